@@ -0,0 +1,48 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random>
+#include "../include/utils/GeoKernels.hpp"
+
+// Distances of 100k points around a 5 km corridor to one segment, a tenth
+// of them close enough to need the exact haversine. Run with:
+//   ./benchmarks "[geo]"
+
+namespace {
+
+constexpr size_t POINTS = 100000;
+
+} // namespace
+
+TEST_CASE("Batched corridor distances", "[geo][!benchmark]") {
+    std::mt19937 random(22);
+    std::uniform_real_distribution<double> along(0.0, 1.0);
+    std::normal_distribution<double> offset(0.0, 0.3);
+
+    utils::Waypoint start{48.14, 11.58};
+    utils::Waypoint end{48.40, 11.20};
+    std::vector<double> latitudes(POINTS);
+    std::vector<double> longitudes(POINTS);
+    for (size_t i = 0; i < POINTS; ++i) {
+        double t = along(random);
+        latitudes[i] = start.latitude + t * (end.latitude - start.latitude) + offset(random);
+        longitudes[i] = start.longitude + t * (end.longitude - start.longitude) + offset(random);
+    }
+    std::vector<double> distances(POINTS);
+    auto frame = utils::GeoKernels::frame(start, end, 5.0);
+
+    BENCHMARK("Point by point") {
+        size_t within = 0;
+        for (size_t i = 0; i < POINTS; ++i) {
+            within += utils::RouteCalculator::isPointInCorridor(start, end, latitudes[i], longitudes[i], 5.0);
+        }
+        return within;
+    };
+    BENCHMARK("Scalar bound") {
+        return utils::GeoKernels::corridorDistances(frame, latitudes, longitudes, distances,
+                                                    utils::GeoKernels::Isa::Scalar);
+    };
+    BENCHMARK("AVX2 bound") {
+        return utils::GeoKernels::corridorDistances(frame, latitudes, longitudes, distances,
+                                                    utils::GeoKernels::Isa::Avx2);
+    };
+}
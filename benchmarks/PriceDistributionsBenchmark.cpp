@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <iostream>
+#include <random>
+#include <fmt/format.h>
+#include "../include/analytics/PriceDistributions.hpp"
+
+// Percentile queries against a filled PriceDistributions: 50 regions of 300
+// stations, polled every five minutes for 48 hours, plus 90 days of daily
+// sketches. Run with:
+//   ./benchmarks "[distributions]"
+
+namespace {
+
+// Monday, 2024-01-15 00:00 CET
+constexpr models::EpochSeconds START = 1705273200;
+constexpr size_t REGIONS = 50;
+constexpr size_t STATIONS = 300;
+
+} // namespace
+
+TEST_CASE("Percentile queries", "[distributions][!benchmark]") {
+    std::mt19937 random(17);
+    std::normal_distribution<double> premium(0.0, 40.0);
+
+    analytics::PriceDistributions distributions;
+    std::vector<models::TenthCents> prices(REGIONS * STATIONS);
+    for (auto& price : prices) {
+        price = 1750 + static_cast<models::TenthCents>(premium(random));
+    }
+
+    // Daily history first, then the recent hours at poll resolution
+    auto now = START + 92 * 86400;
+    for (auto time = START; time < now - 2 * 86400; time += 3600) {
+        for (size_t station = 0; station < prices.size(); ++station) {
+            distributions.observe(static_cast<uint32_t>(station / STATIONS), models::FuelType::E10, time,
+                                  prices[station], std::chrono::hours(1));
+        }
+    }
+    for (auto time = now - 2 * 86400; time < now; time += 300) {
+        for (size_t station = 0; station < prices.size(); ++station) {
+            distributions.observe(static_cast<uint32_t>(station / STATIONS), models::FuelType::E10, time,
+                                  prices[station] + static_cast<models::TenthCents>(random() % 10), std::chrono::minutes(5));
+        }
+    }
+
+    analytics::PriceDistributions::Query lastHour{models::FuelType::E10, now - 3600, now, {}};
+    analytics::PriceDistributions::Query lastDay{models::FuelType::E10, now - 86400, now, {}};
+    analytics::PriceDistributions::Query quarter{models::FuelType::E10, now - 90 * 86400, now, {}};
+    analytics::PriceDistributions::Query regionQuarter{models::FuelType::E10, now - 90 * 86400, now, {7}};
+    analytics::PriceDistributions::Query allRegionsDay{models::FuelType::E10, now - 86400, now, {}};
+    for (uint32_t region = 0; region < REGIONS; ++region) {
+        allRegionsDay.regions.push_back(region);
+    }
+
+    std::cout << fmt::format("Cheapest 10% below {:.1f} in the last hour\n", *distributions.percentile(lastHour, 0.1));
+
+    BENCHMARK("area, last hour") {
+        return distributions.percentile(lastHour, 0.1);
+    };
+    BENCHMARK("area, last day (24 hourly sketches)") {
+        return distributions.percentile(lastDay, 0.1);
+    };
+    BENCHMARK("area, 90 days (daily sketches)") {
+        return distributions.percentile(quarter, 0.1);
+    };
+    BENCHMARK("one region, 90 days") {
+        return distributions.percentile(regionQuarter, 0.1);
+    };
+    BENCHMARK("50 regions merged, last day") {
+        return distributions.percentile(allRegionsDay, 0.1);
+    };
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <fmt/format.h>
+#include "../include/analytics/PriceForecaster.hpp"
+
+// Training and scoring of price forecasts for a region of 300 stations with
+// four weeks of history, about 25 price changes per station and day. Run
+// with:
+//   ./benchmarks "[forecast]"
+
+namespace {
+
+// Monday, 2024-01-15 00:00 CET
+constexpr models::EpochSeconds START = 1705273200;
+constexpr size_t STATIONS = 300;
+
+} // namespace
+
+TEST_CASE("Forecasting a region", "[forecast][!benchmark]") {
+    std::mt19937 random(18);
+    std::uniform_int_distribution<models::EpochSeconds> minutes(10, 110);
+    std::uniform_int_distribution<int> step(-3, 3);
+
+    std::vector<storage::PriceRecord> records;
+    for (models::StationHandle station = 0; station < STATIONS; ++station) {
+        models::TenthCents price = 1750;
+        for (auto time = START; time < START + 28 * 86400; time += minutes(random) * 60) {
+            price = std::clamp(price + step(random) * 10, 1600, 1900);
+            records.push_back({station, models::FuelType::E10, time, price});
+        }
+    }
+    auto history = storage::ColumnarHistory::build(records);
+
+    analytics::PriceForecaster forecaster;
+    for (models::StationHandle station = 0; station < STATIONS; ++station) {
+        forecaster.setBrand(station, station % 3 == 0 ? "Aral" : "Shell");
+    }
+    auto begin = std::chrono::steady_clock::now();
+    forecaster.train(history, models::FuelType::E10);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << fmt::format("Trained on {} price changes in {:.1f} ms\n", records.size(), elapsed.count() * 1000);
+
+    std::vector<models::StationHandle> stations(STATIONS);
+    std::iota(stations.begin(), stations.end(), 0);
+    auto now = START + 28 * 86400;
+
+    BENCHMARK("48-hour forecast of 300 stations") {
+        return forecaster.forecast(stations, models::FuelType::E10, now, 48);
+    };
+    BENCHMARK("24-hour forecast of one station") {
+        return forecaster.forecast(17, models::FuelType::E10, now, 24);
+    };
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random>
+#include "../include/utils/RefuelPlanner.hpp"
+
+// Planning the stops of an 800 km drive with 5000 stations in the
+// corridor. Run with:
+//   ./benchmarks "[refuel]"
+
+namespace {
+
+constexpr size_t CANDIDATES = 5000;
+
+} // namespace
+
+TEST_CASE("Planning refuel stops", "[refuel][!benchmark]") {
+    std::mt19937 random(24);
+    std::uniform_real_distribution<double> position(0.0, 800.0);
+    std::uniform_real_distribution<double> detour(0.0, 6.0);
+    std::normal_distribution<double> price(1.75, 0.06);
+
+    std::vector<utils::RefuelPlanner::Candidate> candidates;
+    for (size_t i = 0; i < CANDIDATES; ++i) {
+        candidates.push_back({std::to_string(i), position(random), detour(random), price(random)});
+    }
+
+    utils::RefuelPlanner::Trip trip;
+    trip.routeLength = 800;
+    trip.tankCapacity = 55;
+    trip.consumption = 6.5;
+    trip.fuel = 12;
+    trip.reserve = 5;
+
+    BENCHMARK("5000 candidates") {
+        return utils::RefuelPlanner::plan(trip, candidates);
+    };
+}
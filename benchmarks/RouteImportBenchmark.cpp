@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <random>
+#include <fmt/format.h>
+#include "../include/utils/RouteImporter.hpp"
+
+// Importing a recorded 100k-point drive from Munich to Hamburg (a point
+// every 6 m, winding, with GPS noise) and getting it ready for corridor
+// queries. Run with:
+//   ./benchmarks "[import]"
+
+namespace {
+
+constexpr size_t POINTS = 100000;
+
+std::vector<utils::Waypoint> makeDrive() {
+    std::mt19937 random(23);
+    std::normal_distribution<double> noise(0.0, 0.00003);
+
+    std::vector<utils::Waypoint> points;
+    points.reserve(POINTS);
+    for (size_t i = 0; i < POINTS; ++i) {
+        double t = static_cast<double>(i) / (POINTS - 1);
+        double bend = 0.05 * std::sin(t * 40.0) + 0.01 * std::sin(t * 400.0);
+        points.push_back({48.14 + t * (53.55 - 48.14) + noise(random),
+                          11.58 + t * (9.99 - 11.58) + bend + noise(random)});
+    }
+    return points;
+}
+
+} // namespace
+
+TEST_CASE("Importing a long route", "[import][!benchmark]") {
+    auto drive = makeDrive();
+
+    std::string gpx = "<gpx><trk><trkseg>\n";
+    for (const auto& point : drive) {
+        gpx += fmt::format("<trkpt lat=\"{:.6f}\" lon=\"{:.6f}\"><ele>500.0</ele></trkpt>\n",
+                           point.latitude, point.longitude);
+    }
+    gpx += "</trkseg></trk></gpx>\n";
+
+    std::string geojson = R"({"type": "Feature", "properties": {}, "geometry": {"type": "LineString", "coordinates": [)";
+    for (size_t i = 0; i < drive.size(); ++i) {
+        geojson += fmt::format("{}[{:.6f},{:.6f}]", i ? "," : "", drive[i].longitude, drive[i].latitude);
+    }
+    geojson += "]}}";
+
+    std::string polyline;
+    int64_t previousLatitude = 0;
+    int64_t previousLongitude = 0;
+    auto encode = [&](int64_t value) {
+        uint64_t bits = value < 0 ? ~(static_cast<uint64_t>(value) << 1) : static_cast<uint64_t>(value) << 1;
+        while (bits >= 0x20) {
+            polyline += static_cast<char>((0x20 | (bits & 0x1f)) + 63);
+            bits >>= 5;
+        }
+        polyline += static_cast<char>(bits + 63);
+    };
+    for (const auto& point : drive) {
+        auto latitude = std::llround(point.latitude * 1e5);
+        auto longitude = std::llround(point.longitude * 1e5);
+        encode(latitude - previousLatitude);
+        encode(longitude - previousLongitude);
+        previousLatitude = latitude;
+        previousLongitude = longitude;
+    }
+
+    utils::RouteImporter::Options options;
+    WARN(fmt::format("{} points simplified to {}", drive.size(),
+                     utils::RouteImporter::simplify(drive, options.tolerance).size()));
+
+    BENCHMARK("Simplifying 100k points") {
+        return utils::RouteImporter::simplify(drive, options.tolerance);
+    };
+    BENCHMARK("GPX") {
+        return utils::RouteImporter::import(gpx, utils::RouteImporter::Format::Gpx, options);
+    };
+    BENCHMARK("GeoJSON") {
+        return utils::RouteImporter::import(geojson, utils::RouteImporter::Format::GeoJson, options);
+    };
+    BENCHMARK("Encoded polyline") {
+        return utils::RouteImporter::import(polyline, utils::RouteImporter::Format::Polyline, options);
+    };
+}
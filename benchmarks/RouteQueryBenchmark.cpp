@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random>
+#include "../include/utils/StationGrid.hpp"
+
+// Corridor queries of a route with 2000 points across Germany against the
+// nationwide station set (about 15k stations). Run with:
+//   ./benchmarks "[route]"
+
+namespace {
+
+constexpr size_t STATIONS = 15000;
+constexpr size_t ROUTE_POINTS = 2000;
+
+} // namespace
+
+TEST_CASE("Finding stations along a route", "[route][!benchmark]") {
+    std::mt19937 random(21);
+    std::uniform_real_distribution<double> latitude(47.5, 55.0);
+    std::uniform_real_distribution<double> longitude(6.0, 15.0);
+    std::normal_distribution<double> wiggle(0.0, 0.002);
+
+    std::vector<models::FuelStation> stations(STATIONS);
+    for (size_t i = 0; i < STATIONS; ++i) {
+        stations[i].id = std::to_string(i);
+        stations[i].location.latitude = latitude(random);
+        stations[i].location.longitude = longitude(random);
+    }
+
+    // Munich to Hamburg, about 600 km
+    std::vector<utils::Waypoint> route;
+    for (size_t i = 0; i < ROUTE_POINTS; ++i) {
+        double t = static_cast<double>(i) / (ROUTE_POINTS - 1);
+        route.push_back({48.14 + t * (53.55 - 48.14) + wiggle(random), 11.58 + t * (9.99 - 11.58) + wiggle(random)});
+    }
+
+    utils::StationGrid grid;
+    for (const auto& station : stations) {
+        grid.upsert(station);
+    }
+
+    BENCHMARK("5 km corridor, persistent grid") {
+        return utils::RouteCalculator::findStationsAlongRoute(route, grid, 5.0);
+    };
+    BENCHMARK("5 km corridor, located along the route") {
+        return utils::RouteCalculator::locateStationsAlongRoute(route, grid, 5.0);
+    };
+    BENCHMARK("5 km corridor, grid built per query") {
+        return utils::RouteCalculator::findStationsAlongRoute(route, stations, 5.0);
+    };
+    BENCHMARK("Testing every station against every segment") {
+        size_t found = 0;
+        for (const auto& station : stations) {
+            for (size_t i = 0; i + 1 < route.size(); ++i) {
+                if (utils::RouteCalculator::isPointInCorridor(route[i], route[i + 1], station.location.latitude,
+                                                              station.location.longitude, 5.0)) {
+                    ++found;
+                    break;
+                }
+            }
+        }
+        return found;
+    };
+    BENCHMARK("Moving 100 stations") {
+        for (size_t i = 0; i < 100; ++i) {
+            auto station = stations[i * 100];
+            station.location.latitude += 0.01;
+            grid.upsert(station);
+        }
+    };
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <fmt/format.h>
+#include "../include/analytics/SeriesKernels.hpp"
+#include "../include/storage/SeriesCodec.hpp"
+
+// Size and decoding speed of compressed price series, decoded block by block
+// into the aggregation kernels. Run with:
+//   ./benchmarks "[codec]"
+
+namespace {
+
+struct Encoded {
+    std::vector<uint8_t> data;
+    std::vector<size_t> offsets;
+    std::vector<models::EpochSeconds> firstTimestamps;
+    std::vector<models::TenthCents> firstPrices;
+    size_t points = 0;
+};
+
+// A year of one station's E5 prices, ~25 changes a day in cent steps
+Encoded encodeYear(size_t series) {
+    std::mt19937 random(5);
+    std::discrete_distribution<int> step({5, 20, 30, 10, 30, 5});
+    std::uniform_int_distribution<models::EpochSeconds> minutes(5, 110);
+
+    Encoded encoded;
+    std::vector<models::EpochSeconds> timestamps;
+    std::vector<models::TenthCents> prices;
+    for (size_t s = 0; s < series; ++s) {
+        models::EpochSeconds timestamp = 1704067200;
+        models::TenthCents price = 1789;
+        for (size_t i = 0; i < 365 * 25; ++i) {
+            timestamp += minutes(random) * 60;
+            price = std::max(1009, price + (step(random) - 3) * 10);
+            timestamps.push_back(timestamp);
+            prices.push_back(price);
+
+            if (timestamps.size() == storage::SeriesCodec::BLOCK_POINTS) {
+                encoded.offsets.push_back(encoded.data.size());
+                encoded.firstTimestamps.push_back(timestamps.front());
+                encoded.firstPrices.push_back(prices.front());
+                storage::SeriesCodec::encode(timestamps, prices, encoded.data);
+                encoded.points += timestamps.size();
+                timestamps.clear();
+                prices.clear();
+            }
+        }
+    }
+    return encoded;
+}
+
+} // namespace
+
+TEST_CASE("Decoding compressed price series", "[codec][!benchmark]") {
+    const auto encoded = encodeYear(200);
+    const auto rawBytes = encoded.points * 24;  // PriceStore log records
+
+    std::cout << fmt::format("Points: {}, {:.2f} bytes/point ({:.1f}x smaller than the log)\n",
+                             encoded.points, static_cast<double>(encoded.data.size()) / encoded.points,
+                             static_cast<double>(rawBytes) / encoded.data.size());
+
+    std::vector<models::EpochSeconds> timestamps(storage::SeriesCodec::BLOCK_POINTS);
+    std::vector<models::TenthCents> prices(storage::SeriesCodec::BLOCK_POINTS);
+    auto decodeAll = [&] {
+        analytics::SeriesKernels::TimeWeighted total;
+        for (size_t block = 0; block < encoded.offsets.size(); ++block) {
+            storage::SeriesCodec::decode(encoded.data.data() + encoded.offsets[block], storage::SeriesCodec::BLOCK_POINTS,
+                                         encoded.firstTimestamps[block], encoded.firstPrices[block],
+                                         timestamps.data(), prices.data());
+            auto sum = analytics::SeriesKernels::timeWeighted(timestamps, prices, timestamps.back(), 86400);
+            total.weightedSum += sum.weightedSum;
+            total.seconds += sum.seconds;
+        }
+        return total;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    decodeAll();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << fmt::format("Decode + timeWeighted: {:.0f} M points/s, {:.2f} GB/s of columns\n",
+                             encoded.points / elapsed.count() / 1e6,
+                             encoded.points * 12 / elapsed.count() / 1e9);
+
+    BENCHMARK("decode and aggregate") {
+        return decodeAll();
+    };
+}
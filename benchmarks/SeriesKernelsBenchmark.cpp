@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <fmt/format.h>
+#include "../include/analytics/SeriesKernels.hpp"
+
+// Scalar and AVX2 aggregation kernels over a year of price changes for a
+// few thousand station series. Run with:
+//   ./benchmarks "[kernels]"
+
+namespace {
+
+using analytics::SeriesKernels;
+
+struct Columns {
+    std::vector<models::EpochSeconds> timestamps;
+    std::vector<models::TenthCents> prices;
+};
+
+// ~25 changes a day for 2000 stations over a year, as one column each
+Columns makeColumns(size_t records) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<models::EpochSeconds> gap(60, 7000);
+    std::uniform_int_distribution<models::TenthCents> price(1500, 2100);
+
+    Columns columns;
+    columns.timestamps.reserve(records);
+    columns.prices.reserve(records);
+    models::EpochSeconds timestamp = 1704067200;
+    for (size_t i = 0; i < records; ++i) {
+        timestamp += gap(random);
+        columns.timestamps.push_back(timestamp);
+        columns.prices.push_back(price(random));
+    }
+    return columns;
+}
+
+template <typename Kernel>
+void reportThroughput(const std::string& name, size_t bytes, Kernel kernel) {
+    constexpr int ROUNDS = 5;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+        kernel();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << fmt::format("{:<32} {:6.2f} GB/s\n", name, ROUNDS * static_cast<double>(bytes) / elapsed.count() / 1e9);
+}
+
+} // namespace
+
+TEST_CASE("Aggregating columnar price history", "[kernels][!benchmark]") {
+    const auto columns = makeColumns(2000 * 365 * 25 / 10);  // a tenth of it, to keep the run short
+    const auto end = columns.timestamps.back();
+    constexpr models::EpochSeconds maxGap = 24 * 3600;
+
+    const size_t priceBytes = columns.prices.size() * sizeof(models::TenthCents);
+    const size_t seriesBytes = priceBytes + columns.timestamps.size() * sizeof(models::EpochSeconds);
+
+    std::cout << fmt::format("Records: {}, CPU kernels: {}\n", columns.prices.size(),
+                             SeriesKernels::isa() == SeriesKernels::Isa::Avx2 ? "AVX2" : "scalar");
+
+    for (auto isa : {SeriesKernels::Isa::Scalar, SeriesKernels::Isa::Avx2}) {
+        auto name = isa == SeriesKernels::Isa::Avx2 ? "AVX2" : "scalar";
+        reportThroughput(fmt::format("summarize ({})", name), priceBytes, [&] {
+            return SeriesKernels::summarize(columns.prices, isa);
+        });
+        reportThroughput(fmt::format("timeWeighted ({})", name), seriesBytes, [&] {
+            return SeriesKernels::timeWeighted(columns.timestamps, columns.prices, end, maxGap, isa);
+        });
+        reportThroughput(fmt::format("accumulateWeek ({})", name), seriesBytes, [&] {
+            analytics::WeekProfile profile{};
+            SeriesKernels::accumulateWeek(columns.timestamps, columns.prices, end, maxGap, profile, isa);
+            return profile[0].seconds;
+        });
+    }
+
+    BENCHMARK("timeWeighted scalar") {
+        return SeriesKernels::timeWeighted(columns.timestamps, columns.prices, end, maxGap, SeriesKernels::Isa::Scalar);
+    };
+
+    BENCHMARK("timeWeighted AVX2") {
+        return SeriesKernels::timeWeighted(columns.timestamps, columns.prices, end, maxGap, SeriesKernels::Isa::Avx2);
+    };
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <fmt/format.h>
+#include "../include/api/StationDecoder.hpp"
+
+// Compares the SAX StationDecoder with the previous approach of parsing the
+// list.php body into a DOM and walking it. Run with:
+//   ./benchmarks "[decoder]"
+
+namespace {
+
+std::atomic<size_t> currentBytes{0};
+std::atomic<size_t> peakBytes{0};
+
+void trackAllocation(size_t size) {
+    size_t now = currentBytes += size;
+    size_t peak = peakBytes.load();
+    while (now > peak && !peakBytes.compare_exchange_weak(peak, now)) {}
+}
+
+} // namespace
+
+// Every allocation carries its size in a header so peak heap usage can be
+// measured around a single decode
+void* operator new(size_t size) {
+    auto* block = static_cast<size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+    if (!block) throw std::bad_alloc();
+    *block = size;
+    trackAllocation(size);
+    return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    auto* block = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - sizeof(std::max_align_t));
+    currentBytes -= *block;
+    std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+namespace {
+
+// Dense-city list.php response: a 25 km radius around Berlin returns several
+// hundred stations
+std::string makeListResponse(size_t stationCount) {
+    std::string body = R"({"ok":true,"license":"CC BY 4.0 -  https://creativecommons.tankerkoenig.de","data":"MTS-K","status":"ok","stations":[)";
+    for (size_t i = 0; i < stationCount; ++i) {
+        if (i > 0) body += ",";
+        body += fmt::format(
+            R"({{"id":"{:08x}-deaf-4f9b-9a32-9797b778f047","name":"TOTAL BERLIN {}","brand":"TOTAL",)"
+            R"("street":"MARGARETE-SOMMER-STR.","place":"BERLIN","lat":{:.6f},"lng":{:.6f},"dist":{:.1f},)"
+            R"("diesel":1.{:03},"e5":1.{:03},"e10":1.{:03},"isOpen":true,"houseNumber":"{}","postCode":10407}})",
+            i, i, 52.3 + (i % 100) * 0.005, 13.1 + (i / 100) * 0.01, (i % 250) * 0.1,
+            600 + i % 100, 700 + i % 100, 680 + i % 100, i % 200);
+    }
+    body += "]}";
+    return body;
+}
+
+// The DOM-based decoding TankerkoenigAPI used before StationDecoder
+std::vector<models::FuelStation> decodeWithDom(const std::string& body) {
+    auto response = nlohmann::json::parse(body);
+
+    std::vector<models::FuelStation> stations;
+    for (const auto& item : response["stations"]) {
+        models::FuelStation station;
+        station.id = item["id"].get<std::string>();
+        station.name = item["name"].get<std::string>();
+        station.brand = item["brand"].get<std::string>();
+        station.location.latitude = item["lat"].get<double>();
+        station.location.longitude = item["lng"].get<double>();
+        station.location.street = item["street"].get<std::string>();
+        station.location.houseNumber = item["houseNumber"].get<std::string>();
+        station.location.city = item["place"].get<std::string>();
+        station.isOpen = item["isOpen"].get<bool>();
+        station.distance = item["dist"].get<double>();
+
+        for (const char* fuelType : {"e5", "e10", "diesel"}) {
+            if (!item[fuelType].is_null()) {
+                station.prices.push_back({
+                    .fuelType = fuelType,
+                    .price = item[fuelType].get<double>(),
+                    .lastUpdate = item.value("lastChange", "")
+                });
+            }
+        }
+        stations.push_back(station);
+    }
+    return stations;
+}
+
+template <typename Decode>
+size_t measurePeakBytes(Decode decode) {
+    size_t baseline = currentBytes.load();
+    peakBytes = baseline;
+    auto stations = decode();
+    return peakBytes.load() - baseline;
+}
+
+} // namespace
+
+TEST_CASE("Decoding a dense-city list.php response", "[decoder][!benchmark]") {
+    const auto body = makeListResponse(1000);
+
+    size_t domPeak = measurePeakBytes([&] { return decodeWithDom(body); });
+    size_t saxPeak = measurePeakBytes([&] {
+        return api::StationDecoder::decode(body, api::StationDecoder::Endpoint::List).stations;
+    });
+
+    std::cout << fmt::format("Response size: {} KiB\n", body.size() / 1024)
+              << fmt::format("Peak heap (DOM): {} KiB\n", domPeak / 1024)
+              << fmt::format("Peak heap (SAX): {} KiB\n", saxPeak / 1024);
+
+    BENCHMARK("DOM parse and walk") {
+        return decodeWithDom(body);
+    };
+
+    BENCHMARK("StationDecoder") {
+        return api::StationDecoder::decode(body, api::StationDecoder::Endpoint::List);
+    };
+}
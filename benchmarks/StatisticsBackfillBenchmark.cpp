@@ -0,0 +1,48 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <fmt/format.h>
+#include "../include/analytics/StatisticsEngine.hpp"
+
+// Recomputing the statistics of 3000 stations over a year of price changes,
+// about 10 per station, fuel type and day, on every core and on one. The
+// nationwide set is about five times the size. Run with:
+//   ./benchmarks "[backfill]"
+
+namespace {
+
+constexpr models::EpochSeconds START = 1704067200;  // 2024-01-01
+constexpr size_t STATIONS = 3000;
+
+} // namespace
+
+TEST_CASE("Backfilling statistics over a year", "[backfill][!benchmark]") {
+    std::mt19937 random(20);
+    std::uniform_int_distribution<models::EpochSeconds> minutes(30, 260);
+    std::uniform_int_distribution<int> step(-3, 3);
+
+    std::vector<storage::PriceRecord> records;
+    for (models::StationHandle station = 0; station < STATIONS; ++station) {
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            models::TenthCents price = 1750;
+            for (auto time = START; time < START + 365 * 86400; time += minutes(random) * 60) {
+                price = std::clamp(price + step(random) * 10, 1500, 2000);
+                records.push_back({station, fuelType, time, price});
+            }
+        }
+    }
+    auto history = storage::ColumnarHistory::build(records);
+    records = {};
+
+    for (size_t threads : {size_t{1}, analytics::StatisticsEngine::BackfillOptions{}.threads}) {
+        analytics::StatisticsEngine engine;
+        analytics::StatisticsEngine::BackfillOptions options;
+        options.threads = threads;
+        auto progress = engine.backfill(history, models::ALL_FUEL_TYPES, options);
+        std::cout << fmt::format("{} records of {} stations on {} threads in {:.2f} s, {:.1f} M records/s\n",
+                                 progress.records, progress.stations, threads, progress.elapsed.count(),
+                                 progress.recordsPerSecond() / 1e6);
+    }
+}
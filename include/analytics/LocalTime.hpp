@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include "../models/CompactStation.hpp"
+
+namespace analytics {
+
+constexpr size_t HOURS_PER_DAY = 24;
+constexpr size_t DAYS_PER_WEEK = 7;
+constexpr size_t HOURS_PER_WEEK = HOURS_PER_DAY * DAYS_PER_WEEK;
+
+// Day names as used by WeeklyStatistics, Monday first
+constexpr std::array<std::string_view, DAYS_PER_WEEK> DAY_NAMES = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+// Tankerkoenig covers Germany, so local time is CET (UTC+1) or CEST (UTC+2)
+models::EpochSeconds toLocalTime(models::EpochSeconds utc);
+
+// 0 for Monday 00:00-00:59 local time up to 167 for Sunday 23:00-23:59
+size_t hourOfWeek(models::EpochSeconds utc);
+
+// Start of the next local hour, in UTC
+models::EpochSeconds nextHour(models::EpochSeconds utc);
+
+// A stretch of time with a constant UTC offset, for converting runs of
+// timestamps without looking up the DST rule for each of them
+struct OffsetPeriod {
+    models::EpochSeconds begin;  // UTC, inclusive
+    models::EpochSeconds end;    // UTC, exclusive
+    models::EpochSeconds offset;  // local minus UTC, in seconds
+};
+
+OffsetPeriod offsetPeriod(models::EpochSeconds utc);
+
+// hourOfWeek() of a local timestamp
+constexpr size_t localHourOfWeek(models::EpochSeconds local) {
+    auto hours = local >= 0 ? local / 3600 : (local - 3599) / 3600;
+    return static_cast<size_t>(((hours + 72) % 168 + 168) % 168);  // 1970-01-01 was a Thursday
+}
+
+} // namespace analytics
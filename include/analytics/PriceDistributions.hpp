@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "QuantileSketch.hpp"
+#include "../storage/ColumnarHistory.hpp"
+
+namespace analytics {
+
+// Distributions of station prices per region, fuel type and time bucket,
+// as QuantileSketches weighted by the seconds each price was seen. Every
+// observation also goes into an area-wide sketch, so questions about the
+// whole area (is this price among the cheapest 10% right now?) read a single
+// track; questions about a set of regions merge theirs.
+//
+// Buckets are hourly (UTC) for the recent past and local days further back.
+// A query merges at most one sketch per bucket and region, so its cost does
+// not depend on the number of stations or observations.
+//
+// All methods are thread-safe.
+class PriceDistributions {
+public:
+    // Caller-defined, e.g. the search area or coverage tile a station was
+    // found in
+    using Region = uint32_t;
+
+    struct Options {
+        size_t hours = 48;  // hourly buckets kept per region and fuel type
+        size_t days = 90;   // daily buckets kept per region and fuel type
+    };
+
+    struct Query {
+        models::FuelType fuelType = models::FuelType::E5;
+        models::EpochSeconds from = 0;  // UTC, inclusive
+        models::EpochSeconds to = 0;    // UTC, exclusive
+        std::vector<Region> regions;    // empty for the whole area
+    };
+
+    PriceDistributions();
+    explicit PriceDistributions(Options options);
+
+    // The price of one station, seen at `timestamp` and taken to hold for
+    // `duration` (e.g. the poll interval)
+    void observe(Region region, models::FuelType fuelType, models::EpochSeconds timestamp,
+                 models::TenthCents price, std::chrono::seconds duration);
+
+    // Add the stored history of a fuel type to the area-wide sketches, each
+    // price weighted by the time until the next change of its series (or
+    // `until` for the newest one), for at most maxGap. Regions are not known
+    // for stored records.
+    void backfill(const storage::ColumnarHistory& history, models::FuelType fuelType,
+                  models::EpochSeconds until, std::chrono::seconds maxGap = std::chrono::hours(24));
+
+    // Hourly buckets if the hourly track still covers `from`, otherwise the
+    // local days overlapping the range
+    QuantileSketch distribution(const Query& query) const;
+
+    // Price in tenth-cents below which the fraction q of the time-weighted
+    // prices lies
+    std::optional<double> percentile(const Query& query, double q) const;
+
+    // Fraction of the time-weighted prices below the given one
+    std::optional<double> rank(const Query& query, models::TenthCents price) const;
+
+private:
+    // Consecutive sketches of one region and fuel type at one resolution
+    struct Track {
+        int64_t firstKey = 0;
+        std::deque<QuantileSketch> sketches;
+
+        // nullptr if the key is older than the retention allows
+        QuantileSketch* at(int64_t key, size_t retention);
+        void mergeInto(QuantileSketch& result, int64_t from, int64_t to) const;
+    };
+
+    struct Tracks {
+        Track hours;
+        Track days;
+    };
+
+    void credit(Tracks& tracks, models::EpochSeconds from, models::EpochSeconds to, models::TenthCents price);
+    bool hourly(models::EpochSeconds from) const;
+
+    static uint64_t key(Region region, models::FuelType fuelType) {
+        return static_cast<uint64_t>(region) * models::FUEL_TYPE_COUNT + models::index(fuelType);
+    }
+
+    Options options;
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, Tracks> regions;  // by key()
+    std::array<Tracks, models::FUEL_TYPE_COUNT> area;  // by fuel type index
+    int64_t latestHour = 0;
+};
+
+} // namespace analytics
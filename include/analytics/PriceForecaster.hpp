@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "LocalTime.hpp"
+#include "../storage/ColumnarHistory.hpp"
+
+namespace analytics {
+
+// Hourly price forecasts per station and fuel type from an online
+// Holt-Winters model: a level with a damped trend plus an hour-of-week
+// seasonal profile, all exponentially smoothed. Every price change credits
+// the price held before it to the hours it was valid in, so models update
+// in O(hours since the last change) and are never retrained in batch.
+//
+// Stations with little history borrow the seasonal profile of their brand
+// (or of the whole area if the brand is unknown or rare), blending into
+// their own profile as it fills up.
+//
+// Not thread-safe.
+class PriceForecaster {
+public:
+    struct Options {
+        // Smoothing per hour of data; the seasonal rate applies per visit of
+        // an hour of the week, i.e. once a week
+        double levelRate = 0.02;
+        double trendRate = 0.005;
+        double seasonalRate = 0.25;
+
+        // Share of the trend carried into each further hour of a forecast
+        double trendDamping = 0.9;
+
+        // A price is credited for at most this long after it was seen
+        std::chrono::seconds maxGap = std::chrono::hours(24);
+
+        // Hours of data after which a station uses its own profile only
+        double warmupHours = 2.0 * HOURS_PER_WEEK;
+
+        // Brands need this many warmed-up stations for their own profile
+        size_t minBrandStations = 3;
+    };
+
+    struct Forecast {
+        models::EpochSeconds start = 0;  // UTC start of the first hour
+        std::vector<double> prices;  // expected price of each hour, in tenth-cents
+
+        // Start of the hour with the lowest expected price
+        models::EpochSeconds cheapestTime() const;
+        double cheapestPrice() const;
+    };
+
+    PriceForecaster();
+    explicit PriceForecaster(Options options);
+
+    // Stations without a brand use the area profile
+    void setBrand(models::StationHandle station, std::string_view brand);
+
+    // Returns false if the record is older than the newest one of its series
+    // and was not applied
+    bool update(const storage::PriceRecord& record);
+
+    // update() for the records of a fuel type, in time order per series.
+    // Records older than the newest one of a series are skipped.
+    void train(const storage::ColumnarHistory& history, models::FuelType fuelType);
+
+    // Hourly forecast from the hour containing `from`. The last price of
+    // the series counts as held until then.
+    std::optional<Forecast> forecast(models::StationHandle station, models::FuelType fuelType,
+                                     models::EpochSeconds from, size_t hours) const;
+
+    // forecast() for many stations
+    std::vector<std::optional<Forecast>> forecast(std::span<const models::StationHandle> stations,
+                                                  models::FuelType fuelType, models::EpochSeconds from,
+                                                  size_t hours) const;
+
+    size_t seriesCount() const { return trainedSeries; }
+
+private:
+    using Profile = std::array<float, HOURS_PER_WEEK>;
+
+    struct Model {
+        Profile seasonal{};
+        double level = 0.0;
+        double trend = 0.0;  // tenth-cents per hour
+        double hours = 0.0;  // of data seen
+        bool warm = false;   // hours reached warmupHours, the profile counts in the sums
+        models::EpochSeconds lastTimestamp = 0;
+        models::TenthCents lastPrice = models::NO_PRICE;
+    };
+
+    // Sum of the warmed-up seasonal profiles of a group of stations, kept up
+    // to date as they change
+    struct ProfileSum {
+        std::array<double, HOURS_PER_WEEK> sum{};
+        size_t stations = 0;
+
+        void add(const Profile& profile, double sign);
+    };
+
+    // Credit a price held over [from, to) to the model, at most one step per
+    // hour. Changes of a warmed-up profile are applied to the sums, if given.
+    void advance(Model& model, models::EpochSeconds from, models::EpochSeconds to, models::TenthCents price,
+                 ProfileSum* brand, ProfileSum* area) const;
+
+    uint16_t brandOf(models::StationHandle station) const {
+        return station < stationBrands.size() ? stationBrands[station] : NO_BRAND;
+    }
+    ProfileSum* brandSum(uint16_t brand, models::FuelType fuelType);
+
+    static size_t slot(models::StationHandle station, models::FuelType fuelType) {
+        return static_cast<size_t>(station) * models::FUEL_TYPE_COUNT + models::index(fuelType);
+    }
+
+    static constexpr uint16_t NO_BRAND = UINT16_MAX;
+
+    Options options;
+    std::vector<std::unique_ptr<Model>> series;  // by slot(), allocated on the first record
+    size_t trainedSeries = 0;
+
+    std::vector<uint16_t> stationBrands;  // by station handle
+    std::unordered_map<std::string, uint16_t> brandIds;
+    std::array<std::vector<ProfileSum>, models::FUEL_TYPE_COUNT> brandSums;  // by fuel type index and brand id
+    std::array<ProfileSum, models::FUEL_TYPE_COUNT> areaSums;
+};
+
+} // namespace analytics
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../storage/PriceStore.hpp"
+
+namespace analytics {
+
+// Downsampled price history at three resolutions, per station and fuel type
+// and summed over all stations (the area). Buckets hold time-weighted sums:
+// a price counts from its timestamp until the next change of the series, for
+// at most maxGap. Five-minute and hourly buckets are aligned to UTC, daily
+// buckets to German local days.
+//
+// Rollups are kept up to date by add() as prices arrive. Records older than
+// the newest one of their series (backfills, imports) cannot be added
+// incrementally; recompute() rebuilds a time range from the store instead.
+//
+// All methods are thread-safe.
+class PriceRollups {
+public:
+    enum class Resolution {
+        FiveMinutes,
+        Hour,
+        Day
+    };
+    static constexpr size_t RESOLUTION_COUNT = 3;
+
+    struct Options {
+        std::chrono::seconds maxGap = std::chrono::hours(24);
+
+        // Buckets kept per series, by Resolution; older ones are dropped
+        std::array<size_t, RESOLUTION_COUNT> retention = {
+            2 * 288,  // two days of five-minute buckets
+            31 * 24,  // a month of hourly buckets
+            400       // a bit over a year of daily buckets
+        };
+    };
+
+    struct Bucket {
+        uint64_t weightedSum = 0;  // price (tenth-cents) x seconds
+        uint64_t seconds = 0;
+        models::TenthCents minPrice = models::NO_PRICE;
+        models::TenthCents maxPrice = models::NO_PRICE;
+
+        void add(models::TenthCents price, uint64_t duration);
+        void merge(const Bucket& other);
+        double average() const { return seconds ? static_cast<double>(weightedSum) / static_cast<double>(seconds) : 0.0; }
+    };
+
+    struct Query {
+        models::FuelType fuelType = models::FuelType::E5;
+        models::EpochSeconds from = 0;  // UTC, inclusive
+        models::EpochSeconds to = 0;    // UTC, exclusive
+        models::EpochSeconds step = 86400;  // multiples of a day are local days
+        std::vector<models::StationHandle> stations;  // empty for the whole area
+    };
+
+    struct Point {
+        models::EpochSeconds start;  // UTC
+        Bucket value;  // seconds is 0 where there is no data
+    };
+
+    struct Result {
+        Resolution resolution;
+        std::vector<Point> points;
+    };
+
+    PriceRollups();
+    explicit PriceRollups(Options options);
+
+    // Returns false if the record is older than the newest one of its series
+    // and was not added
+    bool add(const storage::PriceRecord& record);
+
+    // Rebuild the buckets of whole local days overlapping [from, to) from the
+    // records in the store, with the series split across threads
+    void recompute(storage::PriceStore& store, models::EpochSeconds from, models::EpochSeconds to,
+                   size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+
+    // The coarsest resolution that still holds `from` and that the range
+    // start and step are aligned to; the finest one that holds `from` if
+    // there is none
+    Resolution resolutionFor(const Query& query) const;
+
+    // One point per step. Points are built from the buckets of
+    // resolutionFor(), so their cost depends on the number of points, not
+    // on the number of price changes.
+    Result query(const Query& query) const;
+
+    static models::EpochSeconds seconds(Resolution resolution);
+
+private:
+    // Consecutive buckets of one series at one resolution
+    struct Track {
+        int64_t firstKey = 0;
+        std::deque<Bucket> buckets;
+        int64_t horizon = std::numeric_limits<int64_t>::min();  // buckets before it were dropped or never computed
+
+        // nullptr if the key is older than the retention allows
+        Bucket* at(int64_t key, size_t retention);
+        const Bucket* find(int64_t key) const;
+        void clear(int64_t from, int64_t to);
+        bool covers(int64_t key) const { return key >= horizon; }
+    };
+
+    using Tracks = std::array<Track, RESOLUTION_COUNT>;
+
+    struct Series {
+        Tracks tracks;
+        models::EpochSeconds lastTimestamp = 0;
+        models::TenthCents lastPrice = models::NO_PRICE;
+    };
+
+    // Add a price over [from, to) to the buckets of each resolution, starting
+    // no earlier than floors[resolution]
+    void credit(Tracks& tracks, models::EpochSeconds from, models::EpochSeconds to, models::TenthCents price,
+                const std::array<models::EpochSeconds, RESOLUTION_COUNT>& floors);
+    Resolution selectResolution(const Query& query) const;
+    void rebuildArea(size_t fuel, size_t resolution, int64_t from, int64_t to);
+
+    static size_t slot(models::StationHandle station, models::FuelType fuelType) {
+        return static_cast<size_t>(station) * models::FUEL_TYPE_COUNT + models::index(fuelType);
+    }
+
+    Options options;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Series>> series;  // by slot()
+    std::array<Tracks, models::FUEL_TYPE_COUNT> area;  // by fuel type index
+};
+
+} // namespace analytics
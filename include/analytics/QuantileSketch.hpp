@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace analytics {
+
+// Merging t-digest: a weighted distribution summarized as at most CENTROIDS
+// clusters, with small clusters near the tails so extreme quantiles (the
+// cheapest 10%) stay accurate. The size is fixed, about 1 KiB, however many
+// values are added, and sketches of disjoint data merge into a sketch of the
+// union.
+class QuantileSketch {
+public:
+    static constexpr size_t CENTROIDS = 64;
+    static constexpr size_t BUFFER = 64;  // values added since the last compression
+
+    void add(double value, double weight = 1.0);
+    void merge(const QuantileSketch& other);
+
+    bool empty() const { return total == 0.0; }
+    double weight() const { return total; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+
+    // Value below which the fraction q of the weight lies
+    std::optional<double> quantile(double q) const;
+
+    // Fraction of the weight below the value, counting weight at the value
+    // half
+    std::optional<double> rank(double value) const;
+
+private:
+    struct Centroid {
+        float mean;
+        float weight;
+    };
+
+    void push(Centroid centroid);
+    void compress();
+
+    // Replace the centroids by the sorted input, merged down to the bound
+    void collapse(const Centroid* begin, const Centroid* end);
+
+    // Centroid means with the cumulative weight up to their middle, framed
+    // by (min, 0) and (max, total): the piecewise linear CDF queries use
+    template <typename Visit>
+    void forEachPoint(Visit visit) const;
+
+    std::array<Centroid, CENTROIDS> centroids;
+    std::array<Centroid, BUFFER> buffer;
+    uint32_t centroidCount = 0;
+    uint32_t buffered = 0;
+    double total = 0.0;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+};
+
+} // namespace analytics
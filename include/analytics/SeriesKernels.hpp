@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include "WeekProfile.hpp"
+#include "../models/CompactStation.hpp"
+
+namespace analytics {
+
+// Aggregation kernels over the columns of a price series (timestamps and
+// prices as separate contiguous arrays, timestamps ascending). Each kernel has
+// a scalar and an AVX2 implementation; the AVX2 one is used when the CPU
+// supports it. Both give identical results.
+//
+// A price is valid from its timestamp until the next one, for at most maxGap;
+// the last price until `end`. maxGap must be below 2^31 seconds and prices
+// must not be negative.
+class SeriesKernels {
+public:
+    enum class Isa {
+        Scalar,
+        Avx2
+    };
+
+    struct PriceSummary {
+        models::TenthCents minPrice = models::NO_PRICE;
+        models::TenthCents maxPrice = models::NO_PRICE;
+        int64_t sum = 0;
+        size_t count = 0;
+    };
+
+    struct TimeWeighted {
+        uint64_t weightedSum = 0;  // price (tenth-cents) x seconds
+        uint64_t seconds = 0;
+    };
+
+    // Best implementation supported by this CPU, detected once
+    static Isa isa();
+
+    static PriceSummary summarize(std::span<const models::TenthCents> prices, Isa isa = SeriesKernels::isa());
+
+    static TimeWeighted timeWeighted(
+        std::span<const models::EpochSeconds> timestamps,
+        std::span<const models::TenthCents> prices,
+        models::EpochSeconds end,
+        models::EpochSeconds maxGap,
+        Isa isa = SeriesKernels::isa()
+    );
+
+    // Adds the series to the hour-of-week buckets it was valid in, splitting
+    // intervals at local hour boundaries
+    static void accumulateWeek(
+        std::span<const models::EpochSeconds> timestamps,
+        std::span<const models::TenthCents> prices,
+        models::EpochSeconds end,
+        models::EpochSeconds maxGap,
+        WeekProfile& profile,
+        Isa isa = SeriesKernels::isa()
+    );
+};
+
+} // namespace analytics
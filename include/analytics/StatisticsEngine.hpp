@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LocalTime.hpp"
+#include "SeriesKernels.hpp"
+#include "WeekProfile.hpp"
+#include "../models/CompactStation.hpp"
+#include "../models/PriceStatistics.hpp"
+#include "../storage/ColumnarHistory.hpp"
+
+namespace analytics {
+
+// Streaming price statistics per station and fuel type. Each observation
+// credits the price seen before it to the hour-of-week buckets it was valid
+// in, so averages are time-weighted and every update touches a bounded
+// number of buckets. Reports are built from the buckets; the history is
+// never rescanned.
+class StatisticsEngine {
+public:
+    struct Options {
+        // A price is credited for at most this long after it was seen, so
+        // gaps in the data (e.g. the monitor was down) do not skew averages
+        std::chrono::seconds maxGap = std::chrono::hours(24);
+
+        // Share of stations, by average price, that count as typically cheapest
+        double cheapestFraction = 0.1;
+    };
+
+    // Identifies a station in reports
+    struct StationLabel {
+        std::string id;
+        std::string name;
+    };
+    using Labeler = std::function<StationLabel(models::StationHandle station)>;
+
+    struct BackfillOptions {
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Stations a worker takes from its queue at a time
+        size_t chunkStations = 32;
+
+        // How often the progress callback is called while the job runs
+        std::chrono::milliseconds progressInterval = std::chrono::seconds(1);
+    };
+
+    struct BackfillProgress {
+        size_t stations = 0;  // done, of those with records
+        size_t totalStations = 0;
+        uint64_t records = 0;  // read, including ones the series had seen already
+        uint64_t totalRecords = 0;
+        std::chrono::duration<double> elapsed{0};
+
+        double recordsPerSecond() const {
+            return elapsed.count() > 0 ? static_cast<double>(records) / elapsed.count() : 0.0;
+        }
+    };
+
+    // Called on the thread that runs the backfill
+    using ProgressCallback = std::function<void(const BackfillProgress& progress)>;
+
+    StatisticsEngine();
+    explicit StatisticsEngine(Options options);
+
+    // Record the price of a station at a point in time. Observations of the
+    // same price extend the time it was valid; older observations than the
+    // last one for the series are ignored.
+    void observe(models::StationHandle station, models::FuelType fuelType,
+                 models::EpochSeconds timestamp, models::TenthCents price);
+
+    // Bulk version of observe() for the records of a fuel type, using the
+    // vectorized kernels. Records older than the last observation of a
+    // series are skipped.
+    void backfill(const storage::ColumnarHistory& history, models::FuelType fuelType);
+
+    // backfill() for several fuel types with the stations spread over a
+    // work-stealing pool. Each series is written by one worker only and the
+    // area averages are updated in station order afterwards, so the result
+    // is the same as the sequential backfill for any number of threads.
+    // The calling thread reports progress and returns the final figures.
+    BackfillProgress backfill(const storage::ColumnarHistory& history, std::span<const models::FuelType> fuelTypes,
+                              const BackfillOptions& backfillOptions, const ProgressCallback& progress = {});
+
+    // Time-weighted average over everything observed, in tenth-cents
+    std::optional<double> averagePrice(models::StationHandle station, models::FuelType fuelType) const;
+
+    // Mean of the station averages. O(1).
+    std::optional<double> areaAveragePrice(models::FuelType fuelType) const;
+
+    std::optional<models::StationStatistics> stationStatistics(
+        models::StationHandle station, models::FuelType fuelType, const Labeler& labeler) const;
+
+    // Statistics of every station with data for the fuel type, cheapest
+    // average first. O(stations).
+    models::PriceStatistics statistics(models::FuelType fuelType, const Labeler& labeler) const;
+
+    size_t seriesCount() const { return seriesWithData; }
+
+private:
+    struct Series {
+        WeekProfile buckets;
+        uint64_t weightedSum = 0;
+        uint64_t seconds = 0;
+        models::EpochSeconds lastTimestamp = 0;
+        models::TenthCents lastPrice = models::NO_PRICE;
+
+        std::optional<double> average() const {
+            if (seconds == 0) return std::nullopt;
+            return static_cast<double>(weightedSum) / static_cast<double>(seconds);
+        }
+    };
+
+    Series& seriesFor(models::StationHandle station, models::FuelType fuelType);
+    void updateAreaAverage(models::FuelType fuelType, std::optional<double> before, std::optional<double> after);
+    void credit(Series& series, models::EpochSeconds from, models::EpochSeconds to, models::TenthCents price) const;
+
+    // Apply the records of a column newer than the last observation of the
+    // series. Touches nothing but the series; returns false if there were none.
+    bool extend(Series& series, const storage::ColumnarHistory::Column& column) const;
+
+    models::StationStatistics buildStatistics(const Series& series, models::StationHandle station,
+                                              const Labeler& labeler) const;
+
+    static size_t slot(models::StationHandle station, models::FuelType fuelType) {
+        return static_cast<size_t>(station) * models::FUEL_TYPE_COUNT + models::index(fuelType);
+    }
+
+    Options options;
+    std::vector<std::unique_ptr<Series>> series;  // by slot(), allocated on first observation
+    size_t seriesWithData = 0;
+
+    // Running sums for areaAveragePrice
+    std::array<double, models::FUEL_TYPE_COUNT> averageSums = {};
+    std::array<size_t, models::FUEL_TYPE_COUNT> averageCounts = {};
+    models::EpochSeconds lastUpdate = 0;
+};
+
+} // namespace analytics
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "LocalTime.hpp"
+#include "../models/PriceStatistics.hpp"
+
+namespace analytics {
+
+// Time-weighted prices of one hour of the week, 16 bytes
+struct HourBucket {
+    uint64_t weightedSum = 0;  // price (tenth-cents) x seconds
+    uint32_t seconds = 0;
+    uint16_t minPrice = UINT16_MAX;
+    uint16_t maxPrice = 0;
+
+    void add(models::TenthCents price, uint32_t duration) {
+        auto clamped = static_cast<uint16_t>(std::clamp<models::TenthCents>(price, 0, UINT16_MAX));
+        weightedSum += static_cast<uint64_t>(duration) * clamped;
+        seconds += duration;
+        minPrice = std::min(minPrice, clamped);
+        maxPrice = std::max(maxPrice, clamped);
+    }
+};
+
+// Buckets by hourOfWeek()
+using WeekProfile = std::array<HourBucket, HOURS_PER_WEEK>;
+
+// Per-day minimum, maximum and average in euros, the cheapest and most
+// expensive hour of each day and the cheapest and most expensive day.
+// Days without data are left out.
+models::WeeklyStatistics weeklyStatistics(const WeekProfile& profile);
+
+} // namespace analytics
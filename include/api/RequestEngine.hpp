@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <future>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <curl/curl.h>
+
+namespace api {
+
+struct HttpRequest {
+    std::string url;
+    std::vector<std::string> headers;  // "Name: value"
+};
+
+struct HttpResponse {
+    long status = 0;
+    std::string body;
+    std::map<std::string, std::string> headers;  // Lower-case header names
+};
+
+// Asynchronous HTTP GET engine built on curl_multi. A single worker thread
+// drives all transfers, so connections and TLS sessions are reused across
+// requests, and any number of threads may submit requests concurrently.
+class RequestEngine {
+public:
+    struct Options {
+        size_t maxConcurrentRequests = 8;
+        long timeoutSeconds = 10;
+    };
+
+    // Upper bound for how long the worker sleeps in curl_multi_poll
+    static constexpr int POLL_TIMEOUT_MS = 1000;
+
+    RequestEngine();
+    explicit RequestEngine(Options options);
+    ~RequestEngine();
+    
+    // Disable copying
+    RequestEngine(const RequestEngine&) = delete;
+    RequestEngine& operator=(const RequestEngine&) = delete;
+    
+    // Called on the worker thread when a transfer finishes. error is set if
+    // the transfer failed; HTTP error statuses are reported through
+    // HttpResponse::status. Completions must not block; exceptions thrown
+    // from them are logged and dropped.
+    using Completion = std::function<void(std::exception_ptr error, HttpResponse response)>;
+    
+    // Queue a request. The future throws if the transfer fails.
+    std::future<HttpResponse> submit(HttpRequest request);
+    
+    void submit(HttpRequest request, Completion completion);
+
+private:
+    struct Transfer {
+        HttpRequest request;
+        HttpResponse response;
+        Completion completion;
+        curl_slist* headers = nullptr;
+    };
+
+    void run();
+    void startTransfer(std::unique_ptr<Transfer> transfer);
+    void finishTransfer(CURL* handle, CURLcode result);
+    void abortAll();
+    static void complete(Transfer& transfer, std::exception_ptr error, HttpResponse response);
+    
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userp);
+    
+    Options options;
+    CURLM* multi;
+    CURLSH* share;
+    
+    std::mutex queueMutex;
+    std::deque<std::unique_ptr<Transfer>> pending;
+    bool stopping = false;
+    
+    // Only touched by the worker thread
+    std::map<CURL*, std::unique_ptr<Transfer>> active;
+    std::vector<CURL*> idleHandles;
+    
+    std::thread worker;
+};
+
+} // namespace api
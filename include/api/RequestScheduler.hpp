@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "RequestEngine.hpp"
+
+namespace api {
+
+// Request classes in descending order of importance
+enum class Priority {
+    PricePoll,
+    Discovery,
+    DetailHydration
+};
+
+// Admits requests to the RequestEngine within a token-bucket budget so that
+// the API key stays below the provider's rate limit. Higher priorities are
+// always dispatched first, identical in-flight requests share one transfer,
+// and throttled responses (429/503) pause dispatching and are retried rather
+// than reported as errors.
+class RequestScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        double requestsPerMinute = 60.0;  // <= 0 disables the budget
+        double burst = 10.0;
+        int maxRetries = 3;
+        std::chrono::milliseconds initialBackoff{1000};
+        std::chrono::milliseconds maxBackoff{60000};
+    };
+
+    struct Metrics {
+        uint64_t submitted = 0;
+        uint64_t coalesced = 0;   // answered by an identical in-flight request
+        uint64_t dispatched = 0;  // including retries
+        uint64_t throttled = 0;   // 429/503 responses
+        std::chrono::microseconds totalQueueWait{0};
+        std::chrono::microseconds maxQueueWait{0};
+    };
+
+    static constexpr size_t PRIORITY_COUNT = 3;
+
+    explicit RequestScheduler(RequestEngine::Options engineOptions);
+    RequestScheduler(RequestEngine::Options engineOptions, Options options);
+    ~RequestScheduler();
+    
+    // Disable copying
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+    
+    std::shared_future<HttpResponse> submit(HttpRequest request, Priority priority);
+    
+    // Indexed by Priority
+    std::array<Metrics, PRIORITY_COUNT> metrics() const;
+
+private:
+    struct Job {
+        std::string key;
+        HttpRequest request;
+        Priority priority;
+        std::promise<HttpResponse> promise;
+        std::shared_future<HttpResponse> future;
+        Clock::time_point enqueuedAt;
+        int attempts = 0;
+        bool dispatched = false;
+    };
+
+    void run();
+    void dispatch(std::shared_ptr<Job> job);
+    void complete(const std::shared_ptr<Job>& job, std::exception_ptr error, HttpResponse response);
+    void refill(Clock::time_point now);
+    std::chrono::milliseconds retryDelay(const HttpResponse& response, int attempt) const;
+    
+    static std::string coalescingKey(const HttpRequest& request);
+    
+    Options options;
+    
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::array<std::deque<std::shared_ptr<Job>>, PRIORITY_COUNT> queues;
+    std::unordered_map<std::string, std::shared_ptr<Job>> pending;  // queued or in flight
+    std::array<Metrics, PRIORITY_COUNT> stats;
+    double tokens;
+    Clock::time_point lastRefill;
+    Clock::time_point pausedUntil;
+    bool stopping = false;
+    
+    std::thread worker;
+    
+    // Declared last so that it is destroyed first: aborting its transfers
+    // calls back into complete() while the members above are still alive
+    RequestEngine engine;
+};
+
+} // namespace api
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#include <chrono>
+#include <optional>
+#include <filesystem>
+#include <unordered_map>
+
+namespace api {
+
+// Two-level cache for API responses: a byte-bounded in-memory LRU in front of
+// an optional on-disk store shared by all processes using the same directory
+class ResponseCache {
+public:
+    using Clock = std::chrono::system_clock;
+
+    struct Options {
+        std::filesystem::path directory;  // empty disables the disk store
+        size_t memoryBytes = 16 * 1024 * 1024;
+        std::map<std::string, std::chrono::seconds> ttls;  // per endpoint, e.g. "detail.php"
+        std::chrono::seconds defaultTtl{60};
+    };
+
+    struct Entry {
+        std::string body;
+        std::string etag;
+        std::string lastModified;
+        Clock::time_point storedAt;
+    };
+
+    struct Lookup {
+        Entry entry;
+        bool fresh;  // within the endpoint's TTL
+    };
+
+    explicit ResponseCache(Options options);
+    
+    // Cache key for a request; the API key is excluded so that keys can be
+    // shared between clients
+    static std::string makeKey(const std::string& endpoint, 
+                               const std::map<std::string, std::string>& params);
+    
+    // Returns fresh and stale entries alike, stale ones can be revalidated
+    std::optional<Lookup> lookup(const std::string& key, const std::string& endpoint,
+                                 Clock::time_point now = Clock::now());
+    
+    void store(const std::string& key, Entry entry);
+    
+    // Mark an entry as fresh again after the server confirmed it (304)
+    void refresh(const std::string& key, Clock::time_point now = Clock::now());
+
+private:
+    struct MemoryEntry {
+        Entry entry;
+        std::list<std::string>::iterator position;
+    };
+
+    std::chrono::seconds ttlFor(const std::string& endpoint) const;
+    
+    void insertMemory(const std::string& key, Entry entry);
+    std::optional<Entry> readDisk(const std::string& key) const;
+    void writeDisk(const std::string& key, const Entry& entry) const;
+    std::filesystem::path diskPath(const std::string& key) const;
+    
+    static size_t entrySize(const std::string& key, const Entry& entry);
+    
+    Options options;
+    
+    std::mutex mutex;
+    std::list<std::string> recency;  // most recently used first
+    std::unordered_map<std::string, MemoryEntry> memory;
+    size_t memoryUsed = 0;
+};
+
+} // namespace api
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../models/FuelStation.hpp"
+
+namespace api {
+
+// Decodes Tankerkoenig responses straight into models::FuelStation through
+// nlohmann's SAX interface, without building a JSON DOM first
+class StationDecoder {
+public:
+    enum class Endpoint {
+        List,     // list.php: "stations" array
+        Detail,   // detail.php: single "station" object
+        Prices    // prices.php: "prices" object keyed by station ID
+    };
+
+    struct Result {
+        bool ok = false;
+        std::string message;
+        std::vector<models::FuelStation> stations;
+    };
+
+    // Throws std::runtime_error if the body is not valid JSON
+    static Result decode(std::string_view body, Endpoint endpoint);
+};
+
+} // namespace api
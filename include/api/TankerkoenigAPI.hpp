@@ -1,18 +1,42 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
+#include <map>
+#include <future>
+#include <memory>
 #include <optional>
-#include <curl/curl.h>
-#include <nlohmann/json.hpp>
+#include "RequestEngine.hpp"
+#include "RequestScheduler.hpp"
+#include "ResponseCache.hpp"
+#include "StationDecoder.hpp"
 #include "../models/FuelStation.hpp"
 
 namespace api {
 
+struct SearchArea {
+    double latitude;
+    double longitude;
+    double radius;  // in kilometers
+};
+
+// Client for the Tankerkoenig API. All requests go through a shared
+// RequestScheduler, so the client may be used from several threads, batched
+// calls run concurrently and the API key's rate limit is respected.
 class TankerkoenigAPI {
 public:
+    static constexpr const char* DEFAULT_BASE_URL = "https://creativecommons.tankerkoenig.de/json/";
+
+    struct Options {
+        std::string baseUrl = DEFAULT_BASE_URL;  // e.g. a local stand-in server, must end with '/'
+        RequestEngine::Options engine;
+        RequestScheduler::Options scheduler;
+        std::optional<ResponseCache::Options> cache;  // responses are not cached if empty
+    };
+
     explicit TankerkoenigAPI(const std::string& apiKey);
-    ~TankerkoenigAPI();
+    TankerkoenigAPI(const std::string& apiKey, Options options);
     
     // Disable copying
     TankerkoenigAPI(const TankerkoenigAPI&) = delete;
@@ -26,22 +50,56 @@ public:
         const std::string& fuelType = "all"
     );
     
+    // Search several areas concurrently; results are in the order of areas
+    std::vector<std::vector<models::FuelStation>> findStations(
+        const std::vector<SearchArea>& areas,
+        const std::string& fuelType = "all"
+    );
+    
     // Get details for a specific station
     std::optional<models::FuelStation> getStationDetails(const std::string& stationId);
     
-    // Get prices for a list of stations
+    // Get details for several stations concurrently
+    std::vector<std::optional<models::FuelStation>> getStationDetails(const std::vector<std::string>& stationIds);
+    
+    // Get prices for a list of stations. The list is split into chunks of
+    // MAX_PRICE_IDS which are requested concurrently.
     std::vector<models::FuelStation> getPrices(const std::vector<std::string>& stationIds);
+    
+    // Asynchronous variants. The request is in flight once the call returns;
+    // the response is parsed by the thread that calls get() on the future.
+    std::future<std::vector<models::FuelStation>> findStationsAsync(
+        double lat,
+        double lng,
+        double radius,
+        const std::string& fuelType = "all"
+    );
+    std::future<std::optional<models::FuelStation>> getStationDetailsAsync(const std::string& stationId);
+    std::future<std::vector<models::FuelStation>> getPricesAsync(const std::vector<std::string>& stationIds);
+
+    // Queue statistics per request priority
+    std::array<RequestScheduler::Metrics, RequestScheduler::PRIORITY_COUNT> schedulerMetrics() const;
+
+    // prices.php accepts at most this many station IDs per request
+    static constexpr size_t MAX_PRICE_IDS = 10;
 
 private:
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    // Serves fresh responses from the cache and revalidates stale ones with
+    // If-None-Match/If-Modified-Since where the server sent validators. When
+    // the request fails or stays throttled, a stale cached response is
+    // returned instead of an error. Responses are decoded by the thread that
+    // calls get(), and only those the decoder reports as ok are cached.
+    std::future<StationDecoder::Result> makeRequest(const std::string& endpoint,
+                                                    StationDecoder::Endpoint decoder,
+                                                    const std::map<std::string, std::string>& params);
     
-    nlohmann::json makeRequest(const std::string& endpoint, 
-                             const std::map<std::string, std::string>& params);
+    static Priority priorityFor(const std::string& endpoint);
     
-    CURL* curl;
     std::string apiKey;
-    static constexpr const char* BASE_URL = "https://creativecommons.tankerkoenig.de/json/";
+    std::string baseUrl;
+    RequestScheduler scheduler;
+    std::unique_ptr<ResponseCache> cache;
     static constexpr int TIMEOUT_SECONDS = 10;
 };
 
-} // namespace api 
\ No newline at end of file
+} // namespace api
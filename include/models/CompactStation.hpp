@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "FuelStation.hpp"
+#include "FuelType.hpp"
+
+namespace models {
+
+// Prices in tenths of a cent (1.789 € = 1789), the resolution the API
+// reports. Integer prices compare exactly, without floating point noise.
+using TenthCents = int32_t;
+constexpr TenthCents NO_PRICE = 0;
+
+// Seconds since the epoch (UTC)
+using EpochSeconds = int64_t;
+
+// Dense 32-bit handle for a station ID, see StationInterner
+using StationHandle = uint32_t;
+constexpr StationHandle INVALID_STATION = std::numeric_limits<StationHandle>::max();
+
+inline TenthCents toTenthCents(double euros) {
+    return static_cast<TenthCents>(std::lround(euros * 1000.0));
+}
+
+constexpr double toEuros(TenthCents price) {
+    return price / 1000.0;
+}
+
+// Accepts "2024-01-20 10:00:34+01", "2024-01-20T10:00:34+01:00",
+// "2024-01-20T09:00:34Z" and timestamps without an offset (taken as UTC)
+std::optional<EpochSeconds> parseTimestamp(std::string_view text);
+
+// ISO 8601 in UTC, e.g. "2024-01-20T09:00:34Z"
+std::string formatTimestamp(EpochSeconds timestamp);
+
+// Maps station IDs to dense handles (0, 1, 2, ...) so that per-station data
+// can live in flat arrays and keys compare as integers. Handles stay valid
+// for the lifetime of the interner. Not thread-safe.
+class StationInterner {
+public:
+    StationHandle intern(std::string_view id);
+    std::optional<StationHandle> find(std::string_view id) const;
+    
+    const std::string& id(StationHandle handle) const { return ids.at(handle); }
+    size_t size() const { return ids.size(); }
+
+private:
+    std::deque<std::string> ids;  // deque keeps the strings the keys point into in place
+    std::unordered_map<std::string_view, StationHandle> handles;
+};
+
+// The hot part of a station: what price monitoring and history need, in about
+// 40 bytes. Names and addresses stay in FuelStation at the edges.
+struct CompactStation {
+    StationHandle handle = INVALID_STATION;
+    float latitude = 0.0f;
+    float longitude = 0.0f;
+    bool isOpen = false;
+    EpochSeconds lastUpdate = 0;  // newest price change, 0 if unknown
+    std::array<TenthCents, FUEL_TYPE_COUNT> prices = {};  // NO_PRICE if not offered
+    
+    std::optional<TenthCents> price(FuelType fuelType) const {
+        auto value = prices[index(fuelType)];
+        return value == NO_PRICE ? std::nullopt : std::optional<TenthCents>(value);
+    }
+};
+
+// Conversions at the edges. compact() drops prices of unknown fuel types;
+// expand() restores ID, position, opening state and prices, not the name or
+// address.
+CompactStation compact(const FuelStation& station, StationInterner& interner);
+FuelStation expand(const CompactStation& station, const StationInterner& interner);
+
+} // namespace models
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <nlohmann/json.hpp>
+
+namespace models {
+
+enum class FuelType : uint8_t {
+    E5,
+    E10,
+    Diesel
+};
+
+constexpr size_t FUEL_TYPE_COUNT = 3;
+constexpr std::array<FuelType, FUEL_TYPE_COUNT> ALL_FUEL_TYPES = {FuelType::E5, FuelType::E10, FuelType::Diesel};
+
+// The names used by the Tankerkoenig API and the configuration
+constexpr std::string_view toString(FuelType fuelType) {
+    switch (fuelType) {
+        case FuelType::E5: return "e5";
+        case FuelType::E10: return "e10";
+        case FuelType::Diesel: return "diesel";
+    }
+    return "";
+}
+
+constexpr std::optional<FuelType> parseFuelType(std::string_view name) {
+    for (auto fuelType : ALL_FUEL_TYPES) {
+        if (toString(fuelType) == name) return fuelType;
+    }
+    return std::nullopt;
+}
+
+constexpr size_t index(FuelType fuelType) {
+    return static_cast<size_t>(fuelType);
+}
+
+NLOHMANN_JSON_SERIALIZE_ENUM(FuelType, {
+    {FuelType::E5, "e5"},
+    {FuelType::E10, "e10"},
+    {FuelType::Diesel, "diesel"}
+})
+
+} // namespace models
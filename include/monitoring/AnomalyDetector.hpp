@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "../analytics/LocalTime.hpp"
+#include "../storage/ColumnarHistory.hpp"
+
+namespace monitoring {
+
+// Online detection of unusual prices per station and fuel type. Each
+// hour-of-week bucket keeps an exponentially weighted mean and variance of
+// the prices observed in it, so a price is judged against what the station
+// usually charges at that time of the week rather than against its previous
+// price. Updates are O(1) and the state is about 1.5 KiB per series.
+//
+// Not thread-safe.
+class AnomalyDetector {
+public:
+    enum class AnomalyType {
+        Spike,       // far above the station's band for the hour
+        Drop,        // far below it
+        StalePrice   // unchanged for longer than staleAfter
+    };
+
+    struct Options {
+        // Weight of an observation in its bucket; buckets fill up evenly
+        // until they have 1 / alpha observations
+        double alpha = 0.05;
+
+        // Standard deviations from the bucket mean that count as anomalous;
+        // 0 disables spikes and drops
+        double threshold = 4.0;
+
+        // Spikes and drops must also be this far from the mean; standard
+        // deviations below minStdDev count as minStdDev
+        models::TenthCents minDeviation = 30;
+        double minStdDev = 10.0;
+
+        // Observations a bucket needs before prices are judged against it
+        uint8_t minSamples = 8;
+
+        // 0 disables stale prices
+        std::chrono::seconds staleAfter = std::chrono::hours(72);
+    };
+
+    struct Anomaly {
+        AnomalyType type;
+        models::StationHandle station;
+        models::FuelType fuelType;
+        models::EpochSeconds timestamp;
+        models::TenthCents price;
+        double expected;   // bucket mean in tenth-cents; the price itself for StalePrice
+        double deviation;  // in standard deviations, 0 for StalePrice
+        models::EpochSeconds unchangedSince;  // last change of the price
+    };
+
+    AnomalyDetector();
+    explicit AnomalyDetector(Options options);
+
+    // Judge a price seen at `timestamp`, then add it to its bucket. Spikes
+    // and drops are reported when the price changes, a stale price once
+    // per stretch without change. Observations older than the last one of
+    // the series are not judged. Like train(), a series learns one price
+    // per wall-clock hour however often it is polled, so the bands don't
+    // depend on the update interval.
+    std::optional<Anomaly> observe(models::StationHandle station, models::FuelType fuelType,
+                                   models::EpochSeconds timestamp, models::TenthCents price);
+
+    // Fill the buckets from stored history, sampling the price held at
+    // every hour for up to staleAfter (a day if disabled) after a record.
+    // No events are raised; a stale stretch at the end of the history is
+    // reported by the next observe().
+    void train(const storage::ColumnarHistory& history, models::FuelType fuelType,
+               models::EpochSeconds until);
+
+    // Standard deviations of a price from the station's mean for the hour;
+    // nullopt while the bucket has fewer than minSamples observations
+    std::optional<double> deviation(models::StationHandle station, models::FuelType fuelType,
+                                    models::EpochSeconds timestamp, models::TenthCents price) const;
+
+    const Options& settings() const { return options; }
+
+private:
+    struct Series {
+        std::array<float, analytics::HOURS_PER_WEEK> mean{};
+        std::array<float, analytics::HOURS_PER_WEEK> variance{};
+        std::array<uint8_t, analytics::HOURS_PER_WEEK> samples{};
+        models::EpochSeconds lastTimestamp = 0;
+        models::EpochSeconds lastChange = 0;
+        models::EpochSeconds learnedUntil = 0;  // end of the last hour a price was learned for
+        models::TenthCents lastPrice = models::NO_PRICE;
+        bool staleReported = false;
+    };
+
+    Series& seriesFor(models::StationHandle station, models::FuelType fuelType);
+    // Compare a price with the series and move its last price and change on
+    std::optional<Anomaly> judge(Series& state, size_t hour, models::StationHandle station,
+                                 models::FuelType fuelType, models::EpochSeconds timestamp,
+                                 models::TenthCents price) const;
+    // Add a price to the EW mean and variance of its bucket, unless the
+    // series already learned one for that hour or a later one
+    void learn(Series& state, models::EpochSeconds timestamp, models::TenthCents price) const;
+    std::optional<double> score(const Series& state, size_t hour, models::TenthCents price) const;
+    double stdDev(const Series& state, size_t hour) const;
+
+    static size_t slot(models::StationHandle station, models::FuelType fuelType) {
+        return static_cast<size_t>(station) * models::FUEL_TYPE_COUNT + models::index(fuelType);
+    }
+
+    Options options;
+    std::vector<std::unique_ptr<Series>> series;  // by slot(), allocated on the first observation
+};
+
+std::string_view toString(AnomalyDetector::AnomalyType type);
+
+} // namespace monitoring
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+#include "../models/CompactStation.hpp"
+
+namespace monitoring {
+
+// Current price per (station, fuel type). Lookups go through a flat
+// open-addressing table; alongside it each fuel type keeps its prices
+// ordered (for cheapest and top-k) and counted per price in a Fenwick tree
+// (for ranks), so none of the queries scans the station set.
+class PriceIndex {
+public:
+    struct Entry {
+        models::StationHandle station;
+        models::TenthCents price;
+    };
+
+    // Prices above this rank as if they were this price
+    static constexpr models::TenthCents MAX_RANKED_PRICE = 10000;  // 10 €
+
+    PriceIndex();
+
+    // Store a price and return the previous one, if any. O(log n).
+    std::optional<models::TenthCents> update(models::StationHandle station, models::FuelType fuelType,
+                                             models::TenthCents price);
+    bool erase(models::StationHandle station, models::FuelType fuelType);
+
+    // O(1)
+    std::optional<models::TenthCents> price(models::StationHandle station, models::FuelType fuelType) const;
+    std::optional<Entry> cheapest(models::FuelType fuelType) const;
+
+    // 1 for the cheapest price, stations with the same price share a rank;
+    // 0 if the station has no price for the fuel type. O(log MAX_RANKED_PRICE).
+    size_t rank(models::StationHandle station, models::FuelType fuelType) const;
+
+    // The k cheapest entries, cheapest first. O(k).
+    std::vector<Entry> topK(models::FuelType fuelType, size_t k) const;
+
+    size_t size() const { return count; }
+    size_t size(models::FuelType fuelType) const { return ordered[models::index(fuelType)].size(); }
+
+private:
+    struct Slot {
+        uint64_t key;
+        models::TenthCents price;
+    };
+
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+    static constexpr double MAX_LOAD = 0.5;
+
+    static uint64_t makeKey(models::StationHandle station, models::FuelType fuelType) {
+        return static_cast<uint64_t>(station) << 8 | models::index(fuelType);
+    }
+
+    size_t slotFor(uint64_t key) const;  // the slot holding key, or the empty slot it would go in
+    void grow();
+
+    void addRanked(models::FuelType fuelType, models::TenthCents price, int delta);
+    size_t countBelow(models::FuelType fuelType, models::TenthCents price) const;
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+    int shift;  // 64 - log2(slots.size())
+
+    std::array<std::set<std::pair<models::TenthCents, models::StationHandle>>, models::FUEL_TYPE_COUNT> ordered;
+    std::array<std::vector<int32_t>, models::FUEL_TYPE_COUNT> priceCounts;  // Fenwick trees over prices
+};
+
+} // namespace monitoring
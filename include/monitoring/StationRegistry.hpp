@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include "../models/FuelStation.hpp"
+
+namespace monitoring {
+
+// Keeps the station records found by the last discovery (list.php) so that
+// later cycles only need to poll prices (prices.php) for known station IDs
+class StationRegistry {
+public:
+    using Clock = std::chrono::system_clock;
+
+    // Replace the known station set with a fresh discovery result. Stations
+    // missing from the result are dropped.
+    void update(const std::vector<models::FuelStation>& stations, Clock::time_point now);
+    
+    // Merge a price-only update into the stored station record. Returns the
+    // merged record, or nullptr if the station is unknown.
+    const models::FuelStation* applyPrices(const models::FuelStation& update);
+    
+    // Whether the station set should be rediscovered
+    bool needsDiscovery(Clock::time_point now, std::chrono::minutes interval) const;
+    
+    const models::FuelStation* find(const std::string& stationId) const;
+    std::vector<std::string> stationIds() const;
+    
+    size_t size() const { return stations.size(); }
+    bool empty() const { return stations.empty(); }
+
+private:
+    std::unordered_map<std::string, models::FuelStation> stations;
+    std::optional<Clock::time_point> lastDiscovery;
+};
+
+} // namespace monitoring
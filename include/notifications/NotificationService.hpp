@@ -26,6 +26,18 @@ struct PriceAlertMessage : NotificationMessage {
     bool isBestPrice;
 };
 
+// Anomaly notification: a price far outside the station's usual band for
+// the time of week, or a price that has not changed for days
+struct AnomalyAlertMessage : NotificationMessage {
+    models::FuelStation station;
+    std::string anomalyType;  // "spike", "drop" or "stale"
+    std::string fuelType;
+    double currentPrice;
+    double expectedPrice;  // usual price at this time of the week
+    double deviation;  // in standard deviations, 0 for stale prices
+    std::string unchangedSince;
+};
+
 // Statistics report notification
 struct StatisticsReportMessage : NotificationMessage {
     models::PriceStatistics statistics;
@@ -38,6 +50,7 @@ public:
     virtual ~NotificationService() = default;
     
     virtual void sendPriceAlert(const PriceAlertMessage& message) = 0;
+    virtual void sendAnomalyAlert(const AnomalyAlertMessage& message) = 0;
     virtual void sendStatisticsReport(const StatisticsReportMessage& message) = 0;
     
 protected:
@@ -13,6 +13,7 @@ public:
     
     // Implement notification methods
     void sendPriceAlert(const PriceAlertMessage& message) override;
+    void sendAnomalyAlert(const AnomalyAlertMessage& message) override;
     void sendStatisticsReport(const StatisticsReportMessage& message) override;
 
 private:
@@ -28,6 +29,7 @@ private:
     
     // Card templates
     static const char* PRICE_ALERT_TEMPLATE;
+    static const char* ANOMALY_ALERT_TEMPLATE;
     static const char* STATISTICS_REPORT_TEMPLATE;
 };
 
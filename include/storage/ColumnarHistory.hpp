@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "PriceStore.hpp"
+
+namespace storage {
+
+// Read-only structure-of-arrays copy of a time range of the price history:
+// for every station and fuel type the timestamps and prices are contiguous
+// arrays, sorted by time, that aggregation kernels can stream through.
+// Timestamps take 8 and prices 4 bytes per record.
+class ColumnarHistory {
+public:
+    struct Column {
+        std::span<const models::EpochSeconds> timestamps;
+        std::span<const models::TenthCents> prices;
+
+        size_t size() const { return timestamps.size(); }
+        bool empty() const { return timestamps.empty(); }
+    };
+
+    ColumnarHistory() = default;
+
+    // Records with from <= timestamp < to
+    static ColumnarHistory load(PriceStore& store, models::EpochSeconds from, models::EpochSeconds to);
+    static ColumnarHistory build(std::span<const PriceRecord> records);
+
+    // Empty for unknown stations
+    Column column(models::StationHandle station, models::FuelType fuelType) const;
+
+    // One past the highest station handle with records
+    size_t stationCount() const { return offsets.empty() ? 0 : (offsets.size() - 1) / models::FUEL_TYPE_COUNT; }
+    size_t recordCount() const { return timestamps.size(); }
+    size_t bytes() const { return timestamps.size() * sizeof(models::EpochSeconds) + prices.size() * sizeof(models::TenthCents); }
+
+private:
+    // Column n occupies [offsets[n], offsets[n + 1]) with n = station * FUEL_TYPE_COUNT + fuel index
+    std::vector<uint64_t> offsets;
+    std::vector<models::EpochSeconds> timestamps;
+    std::vector<models::TenthCents> prices;
+};
+
+} // namespace storage
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../models/CompactStation.hpp"
+#include "../models/FuelStation.hpp"
+
+namespace storage {
+
+// A single price change from the Tankerkoenig history dumps. The views point
+// into the mapped CSV file and are only valid during the sink call.
+struct PriceChangeRecord {
+    std::string_view stationId;
+    models::FuelType fuelType;
+    models::EpochSeconds timestamp;
+    models::TenthCents price;
+};
+
+// Splits one CSV record into fields without allocating. Quoted fields are
+// returned without the enclosing quotes; doubled quotes inside them are left
+// as they are (see unescape).
+class CsvFieldSplitter {
+public:
+    explicit CsvFieldSplitter(std::string_view record) : rest(record) {}
+
+    bool next(std::string_view& field);
+
+    static std::string unescape(std::string_view field);
+
+private:
+    std::string_view rest;
+    bool done = false;
+};
+
+// Imports the public Tankerkoenig CSV dumps (prices/YYYY/MM/*-prices.csv and
+// stations/YYYY/MM/*-stations.csv). Files are memory-mapped and price files
+// are split into chunks that are parsed on all cores.
+class CsvImporter {
+public:
+    struct Options {
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t batchSize = 4096;  // records handed to the sink at once
+    };
+
+    struct Stats {
+        uint64_t rows = 0;
+        uint64_t records = 0;
+        uint64_t malformedRows = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Called concurrently from the worker threads
+    using PriceSink = std::function<void(std::span<const PriceChangeRecord> records)>;
+
+    static Stats importPrices(const std::filesystem::path& file, const PriceSink& sink);
+    static Stats importPrices(const std::filesystem::path& file, const PriceSink& sink, Options options);
+
+    // Files are imported one after another, each on all cores
+    static Stats importPrices(const std::vector<std::filesystem::path>& files, const PriceSink& sink, Options options);
+
+    static std::vector<models::FuelStation> importStations(const std::filesystem::path& file);
+
+private:
+    struct AtomicStats {
+        std::atomic<uint64_t> rows{0};
+        std::atomic<uint64_t> records{0};
+        std::atomic<uint64_t> malformedRows{0};
+    };
+
+    static void importPriceChunk(std::string_view chunk, const PriceSink& sink, 
+                                 size_t batchSize, AtomicStats& stats);
+};
+
+} // namespace storage
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../models/CompactStation.hpp"
+
+namespace storage {
+
+struct PriceRecord {
+    models::StationHandle station;
+    models::FuelType fuelType;
+    models::EpochSeconds timestamp;
+    models::TenthCents price;
+};
+
+// Local time-series store of price changes. Layout of the directory:
+//
+//   stations.txt           interned station IDs, one per line; line n is handle n
+//   segment-NNNNNNNN.log   append-only 24-byte checksummed records, rolled at segmentBytes
+//   segment-NNNNNNNN.fpa   a rolled segment rewritten as a compressed SeriesArchive
+//   latest.snapshot        last-known price per (station, fuel type) plus the log
+//                          position it reflects, written by checkpoint()
+//
+// Opening a store maps the snapshot and replays only the records appended
+// after it, so startup does not depend on the length of the history. A torn
+// record at the end of the log (crash during a write) is cut off.
+//
+// With compression enabled, checkpoint() rewrites rolled segments as
+// archives of delta-encoded series blocks, about an eighth of the log size.
+//
+// All methods are thread-safe.
+class PriceStore {
+public:
+    struct Options {
+        std::filesystem::path directory;
+        size_t segmentBytes = 64 * 1024 * 1024;
+        size_t bufferBytes = 64 * 1024;  // appends are written once this much is buffered
+        bool compress = true;  // archive rolled segments on checkpoint()
+    };
+
+    struct Latest {
+        models::TenthCents price = models::NO_PRICE;
+        models::EpochSeconds timestamp = 0;
+    };
+
+    explicit PriceStore(Options options);
+    ~PriceStore();  // flushes and checkpoints
+
+    // Disable copying
+    PriceStore(const PriceStore&) = delete;
+    PriceStore& operator=(const PriceStore&) = delete;
+
+    // Handles are persisted and stay the same across restarts
+    models::StationHandle intern(std::string_view stationId);
+    std::optional<models::StationHandle> find(std::string_view stationId) const;
+    std::string stationId(models::StationHandle station) const;
+    size_t stationCount() const;
+
+    // Records must use handles from intern()
+    void append(const PriceRecord& record);
+    void append(std::span<const PriceRecord> records);
+
+    // Write buffered records (and new station IDs) to the files
+    void flush();
+
+    // Flush, archive rolled segments if compression is enabled and write the
+    // snapshot of the latest prices
+    void checkpoint();
+
+    // The newest record per station and fuel type, loaded on startup
+    std::optional<Latest> latest(models::StationHandle station, models::FuelType fuelType) const;
+    void forEachLatest(const std::function<void(const PriceRecord&)>& callback) const;
+
+    // Records with from <= timestamp < to in append order; records of archived
+    // segments come grouped by series. Segments and archive blocks whose time
+    // range does not overlap are skipped.
+    void scan(models::EpochSeconds from, models::EpochSeconds to,
+              const std::function<void(const PriceRecord&)>& callback);
+
+    uint64_t recordCount() const;
+    size_t segmentCount() const;
+
+private:
+    struct Segment {
+        uint64_t id;
+        uint64_t records;
+        models::EpochSeconds minTimestamp;
+        models::EpochSeconds maxTimestamp;
+        bool archived = false;
+    };
+
+    std::filesystem::path segmentPath(uint64_t id) const;
+    std::filesystem::path archivePath(uint64_t id) const;
+    void loadStations();
+    void loadSnapshot();
+    void replaySegment(Segment& segment, uint64_t firstRecord);
+    void replayArchive(Segment& segment);
+    void archiveSegment(Segment& segment);
+    void openForAppend();
+    void writeBuffer();
+    void rollSegment();
+    void applyLatest(const PriceRecord& record);
+
+    Options options;
+    mutable std::mutex mutex;
+
+    models::StationInterner stations;
+    size_t persistedStations = 0;  // IDs already written to stations.txt
+    std::ofstream stationFile;
+
+    std::vector<Segment> segments;  // oldest first, the last one is appended to
+    int segmentFd = -1;
+    std::vector<char> buffer;
+
+    std::vector<std::array<Latest, models::FUEL_TYPE_COUNT>> latestPrices;  // by station handle
+    bool dirty = false;  // appended since the last checkpoint
+};
+
+} // namespace storage
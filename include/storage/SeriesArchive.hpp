@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <vector>
+#include "ColumnarHistory.hpp"
+#include "MappedFile.hpp"
+#include "SeriesCodec.hpp"
+
+namespace storage {
+
+// Immutable file of compressed price series (see SeriesCodec):
+//
+//   header   magic, version, block count, index offset
+//   blocks   encoded points of one series each, padded
+//   index    one Block per block, sorted by station, fuel type and time
+//
+// The index carries the first point, time range and price range of every
+// block, so blocks can be selected and decoded independently without
+// touching the rest of the file.
+class SeriesArchive {
+public:
+    // Index entry, 48 bytes on disk in host byte order
+    struct Block {
+        uint32_t station;
+        uint8_t fuelType;
+        uint8_t reserved;
+        uint16_t count;
+        models::TenthCents firstPrice;
+        models::TenthCents minPrice;
+        models::TenthCents maxPrice;
+        uint32_t bytes;
+        models::EpochSeconds firstTimestamp;
+        models::EpochSeconds lastTimestamp;
+        uint64_t offset;
+    };
+
+    // Written to a temporary file and renamed, so the path either holds the
+    // complete archive or nothing
+    static void write(const std::filesystem::path& path, const ColumnarHistory& history);
+
+    explicit SeriesArchive(const std::filesystem::path& path);
+
+    std::span<const Block> blocks() const { return index; }
+
+    // The blocks of one series, in time order
+    std::span<const Block> blocks(models::StationHandle station, models::FuelType fuelType) const;
+
+    // Fills block.count points
+    void decode(const Block& block, models::EpochSeconds* timestamps, models::TenthCents* prices) const;
+
+    // Records with from <= timestamp < to, grouped by series. Blocks outside
+    // the range are skipped without decoding.
+    void scan(models::EpochSeconds from, models::EpochSeconds to,
+              const std::function<void(const PriceRecord&)>& callback) const;
+
+    uint64_t recordCount() const { return records; }
+    size_t fileSize() const { return file.size(); }
+
+private:
+    MappedFile file;
+    std::span<const Block> index;
+    uint64_t records = 0;
+};
+
+} // namespace storage
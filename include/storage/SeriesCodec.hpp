@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../models/CompactStation.hpp"
+
+namespace storage {
+
+// Bit-packed encoding of one block of a price series (up to BLOCK_POINTS
+// points, timestamps ascending). The first point is kept outside the block,
+// in the block index, so a block can be decoded on its own. Every following
+// point is stored as
+//
+//   timestamp   delta-of-delta, zigzag:  0 | 10 + 7 bits | 110 + 12 bits | 1110 + 20 bits | 1111 + 64 bits
+//   price       delta in whole cents:    0 + 4 bits | 10 + 8 bits
+//               otherwise, tenth-cents:  110 + 12 bits | 111 + 33 bits
+//
+// Price changes are mostly a few cents, so a typical point takes 2-4 bytes
+// instead of 12.
+class SeriesCodec {
+public:
+    static constexpr size_t BLOCK_POINTS = 1024;
+
+    // Bytes the decoder may read past the end of a block
+    static constexpr size_t PADDING = 8;
+
+    // Appends the encoding of points [1, size) to `out`, followed by PADDING
+    // zero bytes. Returns the size without the padding.
+    static size_t encode(std::span<const models::EpochSeconds> timestamps,
+                         std::span<const models::TenthCents> prices,
+                         std::vector<uint8_t>& out);
+
+    // Decodes `count` points into the arrays, the first one from the given
+    // values. `block` must be followed by PADDING readable bytes.
+    static void decode(const uint8_t* block, size_t count,
+                       models::EpochSeconds firstTimestamp, models::TenthCents firstPrice,
+                       models::EpochSeconds* timestamps, models::TenthCents* prices);
+};
+
+} // namespace storage
@@ -22,26 +22,97 @@ struct LocationConfig {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(LocationConfig, latitude, longitude, searchRadius)
 };
 
+struct CacheConfig {
+    bool enabled = true;
+    std::string directory;  // on-disk cache location, memory only if empty
+    int memoryMegabytes = 16;
+    std::map<std::string, int> ttlSeconds = {  // per endpoint
+        {"list.php", 60},
+        {"prices.php", 60},
+        {"detail.php", 30 * 24 * 3600}
+    };
+    
+    // ttlSeconds entries are merged over the defaults above, so a config may
+    // override a single endpoint
+    friend void to_json(nlohmann::json& json, const CacheConfig& config);
+    friend void from_json(const nlohmann::json& json, CacheConfig& config);
+};
+
+struct CoordinateConfig {
+    double latitude;
+    double longitude;
+    
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CoordinateConfig, latitude, longitude)
+};
+
+struct CoverageConfig {
+    std::vector<CoordinateConfig> area;  // two corners (south-west, north-east) of a box, or 3+ polygon vertices
+    double tileRadius = 25.0;  // in kilometers, at most 25
+    
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(CoverageConfig, area, tileRadius)
+};
+
+struct RateLimitConfig {
+    double requestsPerMinute = 60.0;  // sustained request budget of the API key, 0 disables it
+    double burst = 10.0;  // requests that may be sent back-to-back
+    int maxRetries = 3;  // retries of throttled (429/503) requests
+    
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(RateLimitConfig, requestsPerMinute, burst, maxRetries)
+};
+
+struct ApiConfig {
+    std::string baseUrl = "https://creativecommons.tankerkoenig.de/json/";
+    int maxConcurrentRequests = 8;  // parallel requests to the Tankerkoenig API
+    RateLimitConfig rateLimit;
+    CacheConfig cache;
+    
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ApiConfig, baseUrl, maxConcurrentRequests, rateLimit, cache)
+};
+
+struct StorageConfig {
+    bool enabled = true;
+    std::string directory = "data";  // price history and last known prices
+    int segmentMegabytes = 64;  // size at which log segments are rolled
+    bool compress = true;  // rewrite rolled segments as compressed archives
+    
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(StorageConfig, enabled, directory, segmentMegabytes, compress)
+};
+
 struct MonitoringConfig {
     std::vector<std::string> fuelTypes;  // "e5", "e10", "diesel"
     int updateInterval;  // in minutes
     double priceThreshold;  // minimum price difference to trigger notification
     bool notifyOnIncrease;  // whether to notify when price increases
+    std::string pollMode = "list";  // "list" (list.php every cycle) or "prices" (prices.php for known stations)
+    int discoveryInterval = 1440;  // in minutes, how often "prices" mode rediscovers stations
+    int statisticsInterval = 10080;  // in minutes, how often a statistics report is sent, 0 disables it
+    int statisticsWindowDays = 28;  // stored history loaded into the statistics on startup
+    double anomalyThreshold = 4.0;  // standard deviations from a station's usual price for the hour, 0 disables
+    int staleHours = 72;  // alert when a price has not changed for this long, 0 disables
+    double seasonalBand = 2.0;  // changes within this many standard deviations don't alert, 0 disables
     
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(MonitoringConfig, fuelTypes, updateInterval, 
-                                  priceThreshold, notifyOnIncrease)
+    // fuelTypes, updateInterval, priceThreshold and notifyOnIncrease are
+    // required, the remaining keys fall back to the defaults above
+    friend void to_json(nlohmann::json& json, const MonitoringConfig& config);
+    friend void from_json(const nlohmann::json& json, MonitoringConfig& config);
 };
 
 struct Config {
     std::string apiKey;
     LocationConfig location;
+    std::vector<LocationConfig> regions;  // additional areas monitored alongside location
+    CoverageConfig coverage;  // area tiled into radius queries, monitored alongside location
+    ApiConfig api;
+    StorageConfig storage;
     MonitoringConfig monitoring;
     std::vector<NotificationConfig> notifications;
     
     static Config load(const std::string& path = "config.json");
     static Config fromEnvironment();
     
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(Config, apiKey, location, monitoring, notifications)
+    // regions, coverage, api and storage are optional, the remaining keys are required
+    friend void to_json(nlohmann::json& json, const Config& config);
+    friend void from_json(const nlohmann::json& json, Config& config);
 };
 
 } // namespace utils 
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "RouteCalculator.hpp"
+
+namespace utils {
+
+// A single radius query of a coverage plan. Row and column identify the tile
+// on a global grid, so the same area always yields the same tiles.
+struct CoverageTile {
+    int64_t row;
+    int64_t column;
+    double latitude;
+    double longitude;
+    double radius;  // in kilometers
+};
+
+// Plans the radius queries needed to cover areas larger than the API's
+// search radius limit
+class CoveragePlanner {
+public:
+    // list.php rejects larger radii
+    static constexpr double MAX_RADIUS = 25.0;
+
+    static std::vector<CoverageTile> planBoundingBox(
+        const BoundingBox& box,
+        double radius = MAX_RADIUS
+    );
+    
+    // Polygon vertices in order, the polygon is closed implicitly
+    static std::vector<CoverageTile> planPolygon(
+        const std::vector<Waypoint>& polygon,
+        double radius = MAX_RADIUS
+    );
+
+private:
+    // Circles are laid out in independent latitude rows. Each circle covers
+    // the rectangle of rowHeight x column width around its centre, and
+    // rowHeight = r * sqrt(2) maximizes that rectangle's area.
+    static std::vector<CoverageTile> planCells(
+        const BoundingBox& box,
+        double radius,
+        const std::vector<Waypoint>* polygon
+    );
+    
+    static bool isPointInPolygon(double lat, double lon, const std::vector<Waypoint>& polygon);
+    
+    static bool rectangleIntersectsPolygon(const BoundingBox& cell, const std::vector<Waypoint>& polygon);
+    
+    // Convert degrees to radians
+    static constexpr double toRadians(double degrees) {
+        return degrees * M_PI / 180.0;
+    }
+    
+    // Latitude-degree length is constant, longitude degrees shrink with cos(lat)
+    static constexpr double KM_PER_DEGREE = 111.195;
+    
+    // Keeps the plan conservative against the planar cell approximation
+    static constexpr double SAFETY_FACTOR = 0.99;
+};
+
+} // namespace utils
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <span>
+#include "RouteCalculator.hpp"
+
+namespace utils {
+
+// Batched distances from many points (latitudes and longitudes as separate
+// contiguous arrays) to one route segment, measured like
+// RouteCalculator::pointToSegmentDistance: the point is projected onto the
+// segment in degree space and the great-circle distance to the projection is
+// taken. Everything that depends on the segment alone (radians and cosines
+// of the endpoints, the corridor bounds) is computed once in a frame.
+//
+// Points are first tested against an equirectangular lower bound of their
+// distance, 4 at a time with AVX2 when the CPU supports it. Only points that
+// may lie within the corridor get the exact haversine, so both
+// implementations give identical results.
+class GeoKernels {
+public:
+    enum class Isa {
+        Scalar,
+        Avx2
+    };
+
+    // A segment endpoint with what the haversine needs of it
+    struct Anchor {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        double latitudeRadians = 0.0;
+        double longitudeRadians = 0.0;
+        double cosine = 0.0;  // of the latitude
+    };
+
+    struct SegmentFrame {
+        Anchor start;
+        Anchor end;
+
+        // The segment in degrees is start + t * delta for t in [0, 1]
+        double deltaLatitude = 0.0;
+        double deltaLongitude = 0.0;
+        double lengthSquared = 0.0;  // in square degrees, 0 for a point
+        double inverseLengthSquared = 0.0;
+
+        // A point is farther than `radius` km from the segment if its
+        // offset from the projection, in degrees, exceeds a limit or lies
+        // outside the ellipse dLat^2 + cosineSquared * dLon^2 <= ellipse
+        double radius = 0.0;
+        double latitudeLimit = 0.0;
+        double longitudeLimit = 0.0;
+        double cosineSquared = 0.0;
+        double ellipse = 0.0;
+
+        // and within it if the offset lies inside
+        // dLat^2 + innerCosineSquared * dLon^2 <= innerEllipse
+        double innerCosineSquared = 1.0;
+        double innerEllipse = 0.0;
+    };
+
+    // Best implementation supported by this CPU, detected once
+    static Isa isa();
+
+    static SegmentFrame frame(const Waypoint& start, const Waypoint& end, double radius);
+
+    // Exact distance of one point to the segment, in km
+    static double distance(const SegmentFrame& frame, double latitude, double longitude);
+
+    // Where the point projects onto the segment, from 0 at the start to 1
+    // at the end, as distance() finds it
+    static double project(const SegmentFrame& frame, double latitude, double longitude);
+
+    // Distances in km of the points within frame.radius of the segment,
+    // +infinity for the others. Returns how many are within.
+    static size_t corridorDistances(
+        const SegmentFrame& frame,
+        std::span<const double> latitudes,
+        std::span<const double> longitudes,
+        std::span<double> distances,
+        Isa isa = GeoKernels::isa()
+    );
+
+    // Whether all points are within frame.radius of the segment. Only
+    // points between the two bounds get the exact haversine, and the scan
+    // stops at the first point outside.
+    static bool allWithin(
+        const SegmentFrame& frame,
+        std::span<const double> latitudes,
+        std::span<const double> longitudes,
+        Isa isa = GeoKernels::isa()
+    );
+
+    static constexpr double EARTH_RADIUS = 6371.0;  // in km, as in RouteCalculator
+};
+
+} // namespace utils
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RouteCalculator.hpp"
+
+namespace utils {
+
+// Plans where to stop for fuel along a route and how much to buy, at the
+// lowest cost. Every kilometre is driven on the cheapest fuel that could be
+// in the tank there: fuel from the cheapest station behind it that is at
+// most a tank's range away (after the fuel already in the tank is used).
+// For stations on the route this is optimal; a sweep over the stations by
+// position with a heap of the reachable ones finds it in O(n log n).
+//
+// Stations off the route cost their detour (there and back) in fuel,
+// bought at the stop and leaving that much less room for the route. They
+// are ranked by their price with the detour spread over a full tank, so a
+// cheaper station far off the route only wins if the saving on a full fill
+// pays for the detour. Detours are assumed short next to the range.
+class RefuelPlanner {
+public:
+    struct Trip {
+        double routeLength = 0.0;    // in km
+        double tankCapacity = 50.0;  // in litres
+        double consumption = 7.0;    // litres per 100 km
+        double fuel = 0.0;           // litres in the tank at the start
+        double reserve = 0.0;        // litres never to drive into
+        double arrivalFuel = 0.0;    // litres wanted at the destination, at least the reserve
+    };
+
+    struct Candidate {
+        std::string stationId;
+        double position = 0.0;  // km from the route start
+        double detour = 0.0;    // extra km to stop there and get back to the route
+        double price = 0.0;     // per litre of the fuel type, current or forecast
+    };
+
+    struct Stop {
+        std::string stationId;
+        double position = 0.0;
+        double price = 0.0;
+        double litres = 0.0;         // including the detour
+        double cost = 0.0;
+        double arrivalFuel = 0.0;    // in the tank on arrival, in litres
+    };
+
+    struct Plan {
+        bool feasible = false;
+        double reach = 0.0;  // km the plan gets to, the route length if feasible
+        std::vector<Stop> stops;  // in route order
+        double litres = 0.0;
+        double cost = 0.0;
+    };
+
+    // Throws std::invalid_argument for a trip that makes no sense (no
+    // tank, no consumption, more fuel than fits). Candidates without a
+    // price or off the ends of the route are ignored.
+    static Plan plan(const Trip& trip, const std::vector<Candidate>& candidates);
+
+    // Price of a fuel type ("e5", "e10", "diesel") at an open station
+    static std::optional<double> price(const models::FuelStation& station, std::string_view fuelType);
+
+    // Candidates from located corridor stations at their current prices.
+    // Stations that are closed or don't sell the fuel type are left out.
+    static std::vector<Candidate> candidates(std::span<const RouteStation> stations, std::string_view fuelType);
+};
+
+} // namespace utils
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <vector>
 #include <tuple>
 #include <cmath>
@@ -14,6 +15,13 @@ struct Waypoint {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(Waypoint, latitude, longitude)
 };
 
+struct BoundingBox {
+    double minLatitude;
+    double minLongitude;
+    double maxLatitude;
+    double maxLongitude;
+};
+
 struct RouteSegment {
     Waypoint start;
     Waypoint end;
@@ -22,15 +30,62 @@ struct RouteSegment {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(RouteSegment, start, end, distance)
 };
 
+// A station located along a route by the closest point of the route to it
+struct RouteStation {
+    models::FuelStation station;  // distance is the offset from the route
+    double chainage;  // km along the route from its start to the closest point
+    size_t segment;   // closest segment, from waypoint `segment` to the next
+    double offset;    // km from the closest point
+    double detour;    // estimated extra km to stop there and get back to the route
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(RouteStation, station, chainage, segment, offset, detour)
+};
+
+class StationGrid;
+
 class RouteCalculator {
 public:
-    // Find stations along a route within a corridor
+    // Find stations along a route within a corridor, closest to the route
+    // first
+    static std::vector<models::FuelStation> findStationsAlongRoute(
+        const std::vector<Waypoint>& waypoints,
+        const std::vector<models::FuelStation>& allStations,
+        double corridorWidth  // in kilometers
+    );
+    
+    // Same, against a persistent index of the station set. Only stations in
+    // the grid cells around each segment are tested.
     static std::vector<models::FuelStation> findStationsAlongRoute(
+        const std::vector<Waypoint>& waypoints,
+        const StationGrid& stations,
+        double corridorWidth  // in kilometers
+    );
+    
+    // Stations within the corridor located along the route, ordered by
+    // chainage. Each station is measured against its closest segment.
+    static std::vector<RouteStation> locateStationsAlongRoute(
         const std::vector<Waypoint>& waypoints,
         const std::vector<models::FuelStation>& allStations,
         double corridorWidth  // in kilometers
     );
     
+    static std::vector<RouteStation> locateStationsAlongRoute(
+        const std::vector<Waypoint>& waypoints,
+        const StationGrid& stations,
+        double corridorWidth  // in kilometers
+    );
+    
+    // The located stations at or after `chainage`, e.g. the ones still
+    // ahead of a driver. They are in route order already, so this is a
+    // binary search.
+    static std::span<const RouteStation> stationsAhead(
+        std::span<const RouteStation> stations,
+        double chainage
+    );
+    
+    // Length of the route in kilometers
+    static double routeLength(const std::vector<Waypoint>& waypoints);
+    
     // Calculate distance between two points using Haversine formula
     static double calculateDistance(
         double lat1, double lon1,
@@ -65,6 +120,9 @@ private:
     
     // Earth's radius in kilometers
     static constexpr double EARTH_RADIUS = 6371.0;
+    
+    // Roads are this much longer than the straight line on average
+    static constexpr double ROAD_FACTOR = 1.3;
 };
 
 } // namespace utils 
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "RouteCalculator.hpp"
+
+namespace utils {
+
+// Reads route geometry exported by navigation apps into waypoints for
+// RouteCalculator. The formats are scanned in one pass without building a
+// document: GPX track points (or route points if there is no track), the
+// LineString and MultiLineString geometries of a GeoJSON document in
+// document order, and Google encoded polylines.
+class RouteImporter {
+public:
+    enum class Format {
+        Gpx,
+        GeoJson,
+        Polyline
+    };
+
+    struct Options {
+        // Points closer than this to the simplified route are dropped, in
+        // km. 0 keeps every point.
+        double tolerance = 0.01;
+        int polylinePrecision = 5;  // decimal digits, 6 for OSRM/Valhalla
+    };
+
+    // Called once per point, in route order
+    using PointSink = std::function<void(const Waypoint& point)>;
+
+    // Throws std::runtime_error on malformed input. Returns the number of
+    // points read.
+    static size_t read(std::string_view text, Format format, const PointSink& sink, int polylinePrecision = 5);
+
+    static std::vector<Waypoint> import(std::string_view text, Format format);
+    static std::vector<Waypoint> import(std::string_view text, Format format, const Options& options);
+
+    // Format from the extension: .gpx, .json or .geojson, anything else is
+    // taken as an encoded polyline
+    static std::vector<Waypoint> load(const std::filesystem::path& file);
+    static std::vector<Waypoint> load(const std::filesystem::path& file, const Options& options);
+
+    // Douglas-Peucker with distances measured like the corridor queries:
+    // every dropped point is within `tolerance` km of the segment that
+    // replaces it, so corridors around the result and around the full route
+    // differ by about the tolerance.
+    static std::vector<Waypoint> simplify(std::span<const Waypoint> points, double tolerance);
+};
+
+} // namespace utils
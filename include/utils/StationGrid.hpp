@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RouteCalculator.hpp"
+
+namespace utils {
+
+// Spatial index over a station set: a uniform latitude/longitude grid whose
+// cells keep the positions of their stations in contiguous arrays. Stations
+// are added, moved and removed one at a time, so the index follows the
+// station set without rebuilds. Longitudes are not wrapped at ±180°.
+//
+// Not thread-safe.
+class StationGrid {
+public:
+    struct Cell {
+        std::vector<uint32_t> slots;  // see station()
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+    };
+
+    // About 11 x 7 km in Germany
+    static constexpr double DEFAULT_CELL_DEGREES = 0.1;
+
+    explicit StationGrid(double cellDegrees = DEFAULT_CELL_DEGREES);
+
+    // Add the station, or replace the record of a known one and move it to
+    // its new cell
+    void upsert(const models::FuelStation& station);
+
+    // Add a position that is not keyed by station ID, e.g. one of a list
+    // whose IDs may repeat; find(), erase() and update() don't see it and
+    // its station() record holds only the coordinates. Returns its slot: on
+    // a grid that never had an erase(), slots count up from 0 in insertion
+    // order.
+    uint32_t insert(double latitude, double longitude);
+
+    // Returns false if the station is unknown
+    bool erase(const std::string& stationId);
+
+    // Replace the station set; stations missing from `stations` are dropped
+    void update(const std::vector<models::FuelStation>& stations);
+
+    const models::FuelStation* find(const std::string& stationId) const;
+
+    // Slots are dense and reused after erase(); slotCount() bounds them
+    const models::FuelStation& station(uint32_t slot) const { return entries[slot].station; }
+    size_t slotCount() const { return entries.size(); }
+    size_t size() const { return entries.size() - freeSlots.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Non-empty cells that may hold stations within `radius` km of the
+    // straight line between two waypoints (in degree space, as
+    // RouteCalculator measures segments). The segment is walked in pieces of
+    // about a cell, and only cells in the buffered bounding box of a piece
+    // are returned; every cell at most once.
+    std::vector<const Cell*> cellsNear(const Waypoint& start, const Waypoint& end, double radius) const;
+
+    // Non-empty cells overlapping the box
+    std::vector<const Cell*> cellsIn(const BoundingBox& box) const;
+
+private:
+    struct Entry {
+        models::FuelStation station;
+        uint64_t cell = 0;
+        bool used = false;
+    };
+
+    uint64_t cellKey(double latitude, double longitude) const;
+    void appendCells(const BoundingBox& box, std::vector<uint64_t>& keys) const;
+    uint32_t allocateSlot();
+    void addToCell(uint32_t slot, double latitude, double longitude);
+    void removeFromCell(uint32_t slot);
+
+    double cellDegrees;
+    std::vector<Entry> entries;  // by slot
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> slots;  // by station ID
+    std::unordered_map<uint64_t, Cell> cells;
+};
+
+} // namespace utils
@@ -0,0 +1,55 @@
+#include "analytics/LocalTime.hpp"
+#include <chrono>
+#include <utility>
+
+namespace analytics {
+
+namespace {
+
+constexpr models::EpochSeconds SECONDS_PER_HOUR = 3600;
+constexpr models::EpochSeconds SECONDS_PER_DAY = 86400;
+
+models::EpochSeconds floorDiv(models::EpochSeconds value, models::EpochSeconds divisor) {
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+} // namespace
+
+OffsetPeriod offsetPeriod(models::EpochSeconds utc) {
+    using namespace std::chrono;
+
+    // Summer time runs from 01:00 UTC on the last Sunday of March to 01:00 UTC
+    // on the last Sunday of October
+    auto transitions = [](year y) {
+        auto start = sys_seconds(sys_days(y / March / Sunday[last])) + 1h;
+        auto end = sys_seconds(sys_days(y / October / Sunday[last])) + 1h;
+        return std::pair{start.time_since_epoch().count(), end.time_since_epoch().count()};
+    };
+
+    auto day = sys_days(days(floorDiv(utc, SECONDS_PER_DAY)));
+    auto y = year_month_day(day).year();
+    auto [start, end] = transitions(y);
+
+    if (utc < start) {
+        return {transitions(y - years(1)).second, start, SECONDS_PER_HOUR};
+    }
+    if (utc < end) {
+        return {start, end, 2 * SECONDS_PER_HOUR};
+    }
+    return {end, transitions(y + years(1)).first, SECONDS_PER_HOUR};
+}
+
+models::EpochSeconds toLocalTime(models::EpochSeconds utc) {
+    return utc + offsetPeriod(utc).offset;
+}
+
+size_t hourOfWeek(models::EpochSeconds utc) {
+    return localHourOfWeek(toLocalTime(utc));
+}
+
+models::EpochSeconds nextHour(models::EpochSeconds utc) {
+    // Both offsets are whole hours, so local and UTC hours start together
+    return (floorDiv(utc, SECONDS_PER_HOUR) + 1) * SECONDS_PER_HOUR;
+}
+
+} // namespace analytics
@@ -0,0 +1,174 @@
+#include "analytics/PriceDistributions.hpp"
+#include "analytics/LocalTime.hpp"
+#include <algorithm>
+
+namespace analytics {
+
+namespace {
+
+using models::EpochSeconds;
+
+constexpr EpochSeconds SECONDS_PER_HOUR = 3600;
+constexpr EpochSeconds SECONDS_PER_DAY = 86400;
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+int64_t dayOf(EpochSeconds utc) {
+    return floorDiv(toLocalTime(utc), SECONDS_PER_DAY);
+}
+
+} // namespace
+
+QuantileSketch* PriceDistributions::Track::at(int64_t key, size_t retention) {
+    if (sketches.empty()) {
+        firstKey = key;
+        sketches.emplace_back();
+        return &sketches.front();
+    }
+
+    auto lastKey = firstKey + static_cast<int64_t>(sketches.size()) - 1;
+    if (key < firstKey) {
+        if (lastKey - key >= static_cast<int64_t>(retention)) return nullptr;
+        sketches.insert(sketches.begin(), static_cast<size_t>(firstKey - key), QuantileSketch{});
+        firstKey = key;
+    } else if (key > lastKey) {
+        if (key - lastKey >= static_cast<int64_t>(retention)) {
+            sketches.clear();
+            sketches.emplace_back();
+            firstKey = key;
+        } else {
+            sketches.resize(sketches.size() + static_cast<size_t>(key - lastKey));
+        }
+        while (sketches.size() > retention) {
+            sketches.pop_front();
+            ++firstKey;
+        }
+    }
+    return &sketches[static_cast<size_t>(key - firstKey)];
+}
+
+void PriceDistributions::Track::mergeInto(QuantileSketch& result, int64_t from, int64_t to) const {
+    auto end = firstKey + static_cast<int64_t>(sketches.size());
+    for (auto key = std::max(from, firstKey); key < std::min(to, end); ++key) {
+        result.merge(sketches[static_cast<size_t>(key - firstKey)]);
+    }
+}
+
+PriceDistributions::PriceDistributions() : PriceDistributions(Options{}) {}
+
+PriceDistributions::PriceDistributions(Options options) : options(options) {
+    this->options.hours = std::max<size_t>(1, this->options.hours);
+    this->options.days = std::max<size_t>(1, this->options.days);
+}
+
+void PriceDistributions::observe(
+    Region region,
+    models::FuelType fuelType,
+    models::EpochSeconds timestamp,
+    models::TenthCents price,
+    std::chrono::seconds duration
+) {
+    auto to = timestamp + std::max<EpochSeconds>(1, duration.count());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    credit(regions[key(region, fuelType)], timestamp, to, price);
+    credit(area[models::index(fuelType)], timestamp, to, price);
+}
+
+void PriceDistributions::backfill(
+    const storage::ColumnarHistory& history,
+    models::FuelType fuelType,
+    models::EpochSeconds until,
+    std::chrono::seconds maxGap
+) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& tracks = area[models::index(fuelType)];
+
+    for (models::StationHandle station = 0; station < history.stationCount(); ++station) {
+        auto column = history.column(station, fuelType);
+        for (size_t i = 0; i < column.size(); ++i) {
+            auto next = i + 1 < column.size() ? column.timestamps[i + 1] : until;
+            auto to = std::min({next, column.timestamps[i] + maxGap.count(), until});
+            credit(tracks, column.timestamps[i], to, column.prices[i]);
+        }
+    }
+}
+
+void PriceDistributions::credit(
+    Tracks& tracks,
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    models::TenthCents price
+) {
+    if (price == models::NO_PRICE) return;
+
+    for (auto time = from; time < to;) {
+        auto hour = floorDiv(time, SECONDS_PER_HOUR);
+        auto next = std::min(to, (hour + 1) * SECONDS_PER_HOUR);
+        if (auto* sketch = tracks.hours.at(hour, options.hours)) {
+            sketch->add(price, static_cast<double>(next - time));
+        }
+        latestHour = std::max(latestHour, hour);
+        time = next;
+    }
+
+    // A local day can span a change of the offset
+    auto period = offsetPeriod(from);
+    for (auto time = from; time < to;) {
+        if (time < period.begin || time >= period.end) {
+            period = offsetPeriod(time);
+        }
+        auto day = floorDiv(time + period.offset, SECONDS_PER_DAY);
+        auto next = std::min({to, (day + 1) * SECONDS_PER_DAY - period.offset, period.end});
+        if (auto* sketch = tracks.days.at(day, options.days)) {
+            sketch->add(price, static_cast<double>(next - time));
+        }
+        time = next;
+    }
+}
+
+bool PriceDistributions::hourly(models::EpochSeconds from) const {
+    return floorDiv(from, SECONDS_PER_HOUR) > latestHour - static_cast<int64_t>(options.hours);
+}
+
+QuantileSketch PriceDistributions::distribution(const Query& query) const {
+    QuantileSketch result;
+    if (query.from >= query.to) return result;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<const Tracks*> tracks;
+    if (query.regions.empty()) {
+        tracks.push_back(&area[models::index(query.fuelType)]);
+    } else {
+        for (auto region : query.regions) {
+            auto found = regions.find(key(region, query.fuelType));
+            if (found != regions.end()) {
+                tracks.push_back(&found->second);
+            }
+        }
+    }
+
+    bool useHours = hourly(query.from);
+    for (const auto* entry : tracks) {
+        if (useHours) {
+            entry->hours.mergeInto(result, floorDiv(query.from, SECONDS_PER_HOUR),
+                                   floorDiv(query.to - 1, SECONDS_PER_HOUR) + 1);
+        } else {
+            entry->days.mergeInto(result, dayOf(query.from), dayOf(query.to - 1) + 1);
+        }
+    }
+    return result;
+}
+
+std::optional<double> PriceDistributions::percentile(const Query& query, double q) const {
+    return distribution(query).quantile(q);
+}
+
+std::optional<double> PriceDistributions::rank(const Query& query, models::TenthCents price) const {
+    return distribution(query).rank(price);
+}
+
+} // namespace analytics
@@ -0,0 +1,237 @@
+#include "analytics/PriceForecaster.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace analytics {
+
+namespace {
+
+constexpr models::EpochSeconds SECONDS_PER_HOUR = 3600;
+
+} // namespace
+
+models::EpochSeconds PriceForecaster::Forecast::cheapestTime() const {
+    auto cheapest = std::min_element(prices.begin(), prices.end()) - prices.begin();
+    return start + cheapest * SECONDS_PER_HOUR;
+}
+
+double PriceForecaster::Forecast::cheapestPrice() const {
+    return prices.empty() ? 0.0 : *std::min_element(prices.begin(), prices.end());
+}
+
+void PriceForecaster::ProfileSum::add(const Profile& profile, double sign) {
+    for (size_t hour = 0; hour < HOURS_PER_WEEK; ++hour) {
+        sum[hour] += sign * profile[hour];
+    }
+    stations = sign > 0 ? stations + 1 : stations - 1;
+}
+
+PriceForecaster::PriceForecaster() : PriceForecaster(Options{}) {}
+
+PriceForecaster::PriceForecaster(Options options) : options(options) {
+    if (options.levelRate <= 0 || options.levelRate > 1 || options.trendRate < 0 || options.trendRate > 1 ||
+        options.seasonalRate <= 0 || options.seasonalRate > 1) {
+        throw std::invalid_argument(fmt::format("Invalid forecast smoothing rates: {}, {}, {}",
+                                                options.levelRate, options.trendRate, options.seasonalRate));
+    }
+    if (options.trendDamping < 0 || options.trendDamping >= 1) {
+        throw std::invalid_argument(fmt::format("Invalid forecast trend damping: {}", options.trendDamping));
+    }
+}
+
+void PriceForecaster::setBrand(models::StationHandle station, std::string_view brand) {
+    // Brands are matched case-insensitively ("ARAL" and "Aral")
+    std::string name(brand);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    uint16_t id = NO_BRAND;
+    if (!name.empty()) {
+        auto [it, inserted] = brandIds.try_emplace(name, static_cast<uint16_t>(brandIds.size()));
+        if (inserted && it->second == NO_BRAND) {
+            brandIds.erase(it);  // out of ids; treat it as unknown
+        } else {
+            id = it->second;
+        }
+    }
+
+    if (station >= stationBrands.size()) {
+        stationBrands.resize(station + 1, NO_BRAND);
+    }
+    auto previous = stationBrands[station];
+    if (previous == id) return;
+    stationBrands[station] = id;
+
+    // Move the warmed-up profiles of the station to the new brand
+    for (auto fuelType : models::ALL_FUEL_TYPES) {
+        auto index = slot(station, fuelType);
+        if (index >= series.size() || !series[index] || !series[index]->warm) continue;
+
+        if (auto* sum = brandSum(previous, fuelType)) sum->add(series[index]->seasonal, -1);
+        if (auto* sum = brandSum(id, fuelType)) sum->add(series[index]->seasonal, 1);
+    }
+}
+
+PriceForecaster::ProfileSum* PriceForecaster::brandSum(uint16_t brand, models::FuelType fuelType) {
+    if (brand == NO_BRAND) return nullptr;
+
+    auto& sums = brandSums[models::index(fuelType)];
+    if (brand >= sums.size()) {
+        sums.resize(brand + 1);
+    }
+    return &sums[brand];
+}
+
+bool PriceForecaster::update(const storage::PriceRecord& record) {
+    auto index = slot(record.station, record.fuelType);
+    if (index >= series.size()) {
+        series.resize(index + 1);
+    }
+    if (!series[index]) {
+        series[index] = std::make_unique<Model>();
+        ++trainedSeries;
+    }
+    auto& model = *series[index];
+
+    if (model.lastPrice == models::NO_PRICE) {
+        model.level = record.price;
+    } else {
+        if (record.timestamp < model.lastTimestamp) return false;
+
+        auto until = std::min(record.timestamp, model.lastTimestamp + options.maxGap.count());
+        advance(model, model.lastTimestamp, until, model.lastPrice,
+                brandSum(brandOf(record.station), record.fuelType), &areaSums[models::index(record.fuelType)]);
+    }
+    model.lastTimestamp = record.timestamp;
+    model.lastPrice = record.price;
+    return true;
+}
+
+void PriceForecaster::train(const storage::ColumnarHistory& history, models::FuelType fuelType) {
+    for (models::StationHandle station = 0; station < history.stationCount(); ++station) {
+        auto column = history.column(station, fuelType);
+        for (size_t i = 0; i < column.size(); ++i) {
+            update({station, fuelType, column.timestamps[i], column.prices[i]});
+        }
+    }
+}
+
+void PriceForecaster::advance(
+    Model& model,
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    models::TenthCents price,
+    ProfileSum* brand,
+    ProfileSum* area
+) const {
+    auto period = offsetPeriod(from);
+    while (from < to) {
+        auto end = std::min(nextHour(from), to);
+        if (from < period.begin || from >= period.end) {
+            period = offsetPeriod(from);
+        }
+        auto hour = localHourOfWeek(from + period.offset);
+        auto weight = static_cast<double>(end - from) / SECONDS_PER_HOUR;
+
+        // Holt's level and trend on the deseasonalized price
+        auto& seasonal = model.seasonal[hour];
+        auto predicted = model.level + model.trend * weight;
+        auto level = predicted + std::min(1.0, options.levelRate * weight) * (price - seasonal - predicted);
+        model.trend += options.trendRate * (level - model.level - model.trend * weight);
+        model.level = level;
+
+        // The seasonal deviation from the updated level. Each hour of the week
+        // comes round once a week, so the first weeks are averaged evenly
+        // rather than smoothed.
+        auto weeks = std::floor(model.hours / HOURS_PER_WEEK);
+        auto rate = std::max(options.seasonalRate, 1.0 / (1.0 + weeks));
+        float before = seasonal;
+        seasonal += static_cast<float>(std::min(1.0, rate * weight) * (price - level - seasonal));
+        if (model.warm) {
+            double delta = static_cast<double>(seasonal) - before;
+            if (brand) brand->sum[hour] += delta;
+            if (area) area->sum[hour] += delta;
+        }
+
+        model.hours += weight;
+        if (!model.warm && model.hours >= options.warmupHours) {
+            model.warm = true;
+            if (brand) brand->add(model.seasonal, 1);
+            if (area) area->add(model.seasonal, 1);
+        }
+        from = end;
+    }
+}
+
+std::optional<PriceForecaster::Forecast> PriceForecaster::forecast(
+    models::StationHandle station,
+    models::FuelType fuelType,
+    models::EpochSeconds from,
+    size_t hours
+) const {
+    auto index = slot(station, fuelType);
+    if (index >= series.size() || !series[index] || hours == 0) return std::nullopt;
+
+    // The last price still holds; credit it up to `from` on a copy
+    auto model = *series[index];
+    auto start = nextHour(from) - SECONDS_PER_HOUR;
+    auto until = std::min(from, model.lastTimestamp + options.maxGap.count());
+    if (until > model.lastTimestamp) {
+        advance(model, model.lastTimestamp, until, model.lastPrice, nullptr, nullptr);
+    }
+
+    // Seasonal profile shared by stations like this one, for the warmup
+    const ProfileSum* shared = nullptr;
+    auto brand = brandOf(station);
+    const auto& brands = brandSums[models::index(fuelType)];
+    if (brand != NO_BRAND && brand < brands.size() && brands[brand].stations >= options.minBrandStations) {
+        shared = &brands[brand];
+    } else if (areaSums[models::index(fuelType)].stations > 0) {
+        shared = &areaSums[models::index(fuelType)];
+    }
+    auto own = std::min(1.0, model.hours / options.warmupHours);
+    if (!shared) own = 1.0;
+
+    Forecast result;
+    result.start = start;
+    result.prices.reserve(hours);
+
+    auto period = offsetPeriod(start);
+    double trend = 0.0;
+    double damping = options.trendDamping;
+    for (size_t i = 0; i < hours; ++i) {
+        auto time = start + static_cast<models::EpochSeconds>(i) * SECONDS_PER_HOUR;
+        if (time < period.begin || time >= period.end) {
+            period = offsetPeriod(time);
+        }
+        auto hour = localHourOfWeek(time + period.offset);
+
+        trend += model.trend * damping;
+        damping *= options.trendDamping;
+
+        double seasonal = own * model.seasonal[hour];
+        if (own < 1.0) {
+            seasonal += (1.0 - own) * shared->sum[hour] / static_cast<double>(shared->stations);
+        }
+        result.prices.push_back(model.level + trend + seasonal);
+    }
+    return result;
+}
+
+std::vector<std::optional<PriceForecaster::Forecast>> PriceForecaster::forecast(
+    std::span<const models::StationHandle> stations,
+    models::FuelType fuelType,
+    models::EpochSeconds from,
+    size_t hours
+) const {
+    std::vector<std::optional<Forecast>> result;
+    result.reserve(stations.size());
+    for (auto station : stations) {
+        result.push_back(forecast(station, fuelType, from, hours));
+    }
+    return result;
+}
+
+} // namespace analytics
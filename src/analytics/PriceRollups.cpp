@@ -0,0 +1,384 @@
+#include "analytics/PriceRollups.hpp"
+#include "analytics/LocalTime.hpp"
+#include "storage/ColumnarHistory.hpp"
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace analytics {
+
+namespace {
+
+using models::EpochSeconds;
+
+constexpr EpochSeconds SECONDS_PER_DAY = 86400;
+constexpr size_t DAY = static_cast<size_t>(PriceRollups::Resolution::Day);
+constexpr std::array<EpochSeconds, PriceRollups::RESOLUTION_COUNT> NO_FLOORS = {
+    std::numeric_limits<EpochSeconds>::min(),
+    std::numeric_limits<EpochSeconds>::min(),
+    std::numeric_limits<EpochSeconds>::min()
+};
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+int64_t keyOf(size_t resolution, EpochSeconds utc) {
+    if (resolution == DAY) {
+        return floorDiv(toLocalTime(utc), SECONDS_PER_DAY);
+    }
+    return floorDiv(utc, PriceRollups::seconds(static_cast<PriceRollups::Resolution>(resolution)));
+}
+
+// UTC start of a bucket
+EpochSeconds keyStart(size_t resolution, int64_t key) {
+    if (resolution == DAY) {
+        // Offsets change at 01:00 UTC, never around local midnight
+        auto local = key * SECONDS_PER_DAY;
+        return local - offsetPeriod(local - 2 * 3600).offset;
+    }
+    return key * PriceRollups::seconds(static_cast<PriceRollups::Resolution>(resolution));
+}
+
+// Splits the items into one share per thread. An exception thrown by
+// work(), or by starting a thread, is rethrown once all threads are joined;
+// the other shares may be left unfinished then.
+template <typename Work>
+void runParallel(size_t count, size_t threads, Work work) {
+    threads = std::max<size_t>(1, std::min(threads, count));
+    std::vector<std::exception_ptr> errors(threads);  // by share
+    auto runShare = [&](size_t share) {
+        try {
+            for (size_t item = count * share / threads; item < count * (share + 1) / threads; ++item) {
+                work(item);
+            }
+        } catch (...) {
+            errors[share] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    try {
+        for (size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(runShare, i);
+        }
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    // The calling thread takes the first share
+    if (!errors[0]) {
+        runShare(0);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+} // namespace
+
+void PriceRollups::Bucket::add(models::TenthCents price, uint64_t duration) {
+    if (duration == 0) return;
+    weightedSum += duration * static_cast<uint64_t>(price);
+    minPrice = seconds == 0 ? price : std::min(minPrice, price);
+    maxPrice = seconds == 0 ? price : std::max(maxPrice, price);
+    seconds += duration;
+}
+
+void PriceRollups::Bucket::merge(const Bucket& other) {
+    if (other.seconds == 0) return;
+    minPrice = seconds == 0 ? other.minPrice : std::min(minPrice, other.minPrice);
+    maxPrice = seconds == 0 ? other.maxPrice : std::max(maxPrice, other.maxPrice);
+    weightedSum += other.weightedSum;
+    seconds += other.seconds;
+}
+
+PriceRollups::Bucket* PriceRollups::Track::at(int64_t key, size_t retention) {
+    if (buckets.empty()) {
+        firstKey = key;
+        buckets.emplace_back();
+        return &buckets.front();
+    }
+
+    auto lastKey = firstKey + static_cast<int64_t>(buckets.size()) - 1;
+    if (key < firstKey) {
+        if (lastKey - key >= static_cast<int64_t>(retention)) return nullptr;
+        buckets.insert(buckets.begin(), static_cast<size_t>(firstKey - key), Bucket{});
+        firstKey = key;
+    } else if (key > lastKey) {
+        if (key - lastKey >= static_cast<int64_t>(retention)) {
+            buckets.clear();
+            buckets.emplace_back();
+            firstKey = key;
+        } else {
+            buckets.resize(buckets.size() + static_cast<size_t>(key - lastKey));
+        }
+        while (buckets.size() > retention) {
+            buckets.pop_front();
+            ++firstKey;
+        }
+        horizon = std::max(horizon, key - static_cast<int64_t>(retention) + 1);
+    }
+    return &buckets[static_cast<size_t>(key - firstKey)];
+}
+
+const PriceRollups::Bucket* PriceRollups::Track::find(int64_t key) const {
+    if (key < firstKey || key >= firstKey + static_cast<int64_t>(buckets.size())) return nullptr;
+    return &buckets[static_cast<size_t>(key - firstKey)];
+}
+
+void PriceRollups::Track::clear(int64_t from, int64_t to) {
+    auto end = firstKey + static_cast<int64_t>(buckets.size());
+    for (auto key = std::max(from, firstKey); key < std::min(to, end); ++key) {
+        buckets[static_cast<size_t>(key - firstKey)] = Bucket{};
+    }
+}
+
+PriceRollups::PriceRollups() : PriceRollups(Options{}) {}
+
+PriceRollups::PriceRollups(Options options) : options(options) {
+    for (auto& retention : this->options.retention) {
+        retention = std::max<size_t>(1, retention);
+    }
+    if (this->options.maxGap.count() <= 0) {
+        throw std::runtime_error(fmt::format("Invalid rollup gap: {}s", this->options.maxGap.count()));
+    }
+}
+
+models::EpochSeconds PriceRollups::seconds(Resolution resolution) {
+    switch (resolution) {
+        case Resolution::FiveMinutes: return 300;
+        case Resolution::Hour: return 3600;
+        case Resolution::Day: return SECONDS_PER_DAY;
+    }
+    return SECONDS_PER_DAY;
+}
+
+bool PriceRollups::add(const storage::PriceRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto index = slot(record.station, record.fuelType);
+    if (index >= series.size()) {
+        series.resize(index + 1);
+    }
+    if (!series[index]) {
+        series[index] = std::make_unique<Series>();
+    }
+    auto& entry = *series[index];
+
+    if (entry.lastPrice != models::NO_PRICE) {
+        if (record.timestamp < entry.lastTimestamp) return false;
+
+        auto until = std::min(record.timestamp, entry.lastTimestamp + options.maxGap.count());
+        credit(entry.tracks, entry.lastTimestamp, until, entry.lastPrice, NO_FLOORS);
+        credit(area[models::index(record.fuelType)], entry.lastTimestamp, until, entry.lastPrice, NO_FLOORS);
+    }
+    entry.lastTimestamp = record.timestamp;
+    entry.lastPrice = record.price;
+    return true;
+}
+
+void PriceRollups::recompute(
+    storage::PriceStore& store,
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    size_t threads
+) {
+    if (from >= to) return;
+
+    // Whole local days, which are also whole hours and five-minute slots
+    auto begin = keyStart(DAY, keyOf(DAY, from));
+    auto end = keyStart(DAY, keyOf(DAY, to - 1) + 1);
+    auto maxGap = options.maxGap.count();
+
+    // Prices set up to maxGap before the range still count inside it
+    auto history = storage::ColumnarHistory::load(store, begin - maxGap, end);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Resolutions only get the buckets they can retain
+    std::array<std::pair<int64_t, int64_t>, RESOLUTION_COUNT> keys;
+    std::array<EpochSeconds, RESOLUTION_COUNT> floors;
+    for (size_t resolution = 0; resolution < RESOLUTION_COUNT; ++resolution) {
+        auto last = keyOf(resolution, end);
+        auto first = std::max(keyOf(resolution, begin), last - static_cast<int64_t>(options.retention[resolution]));
+        keys[resolution] = {first, last};
+        floors[resolution] = keyStart(resolution, first);
+    }
+
+    series.resize(std::max(series.size(), history.stationCount() * models::FUEL_TYPE_COUNT));
+
+    // Series are independent, so each worker owns a share of them
+    runParallel(series.size(), threads, [&](size_t index) {
+        auto station = static_cast<models::StationHandle>(index / models::FUEL_TYPE_COUNT);
+        auto fuelType = models::ALL_FUEL_TYPES[index % models::FUEL_TYPE_COUNT];
+        auto column = history.column(station, fuelType);
+
+        auto& entry = series[index];
+        if (!entry) {
+            if (column.empty()) return;
+            entry = std::make_unique<Series>();
+        }
+        for (size_t resolution = 0; resolution < RESOLUTION_COUNT; ++resolution) {
+            auto& track = entry->tracks[resolution];
+            track.clear(keys[resolution].first, keys[resolution].second);
+            track.horizon = std::max(track.horizon, keys[resolution].second - static_cast<int64_t>(options.retention[resolution]));
+        }
+
+        for (size_t i = 0; i < column.size(); ++i) {
+            auto timestamp = column.timestamps[i];
+            auto price = column.prices[i];
+
+            EpochSeconds until;
+            if (i + 1 < column.size()) {
+                until = column.timestamps[i + 1];
+            } else if (entry->lastPrice != models::NO_PRICE && entry->lastTimestamp > timestamp) {
+                until = end;  // the next change is after the range
+            } else {
+                // Newest price of the series; it counts once the next one arrives
+                entry->lastTimestamp = timestamp;
+                entry->lastPrice = price;
+                break;
+            }
+            until = std::min({until, timestamp + maxGap, end});
+            credit(entry->tracks, std::max(timestamp, begin), until, price, floors);
+        }
+    });
+
+    // The area buckets are sums over the series
+    runParallel(models::FUEL_TYPE_COUNT * RESOLUTION_COUNT, threads, [&](size_t task) {
+        auto fuel = task / RESOLUTION_COUNT;
+        auto resolution = task % RESOLUTION_COUNT;
+        rebuildArea(fuel, resolution, keys[resolution].first, keys[resolution].second);
+    });
+}
+
+void PriceRollups::rebuildArea(size_t fuel, size_t resolution, int64_t from, int64_t to) {
+    if (from >= to) return;
+
+    std::vector<Bucket> sums(static_cast<size_t>(to - from));
+    for (size_t index = fuel; index < series.size(); index += models::FUEL_TYPE_COUNT) {
+        if (!series[index]) continue;
+        const auto& track = series[index]->tracks[resolution];
+        for (auto key = std::max(from, track.firstKey);
+             key < std::min(to, track.firstKey + static_cast<int64_t>(track.buckets.size())); ++key) {
+            sums[static_cast<size_t>(key - from)].merge(track.buckets[static_cast<size_t>(key - track.firstKey)]);
+        }
+    }
+
+    auto& track = area[fuel][resolution];
+    track.clear(from, to);
+    track.horizon = std::max(track.horizon, to - static_cast<int64_t>(options.retention[resolution]));
+    for (size_t i = 0; i < sums.size(); ++i) {
+        if (sums[i].seconds == 0) continue;
+        if (auto* bucket = track.at(from + static_cast<int64_t>(i), options.retention[resolution])) {
+            *bucket = sums[i];
+        }
+    }
+}
+
+PriceRollups::Resolution PriceRollups::resolutionFor(const Query& query) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return selectResolution(query);
+}
+
+PriceRollups::Resolution PriceRollups::selectResolution(const Query& query) const {
+    const auto& tracks = area[models::index(query.fuelType)];
+    auto covers = [&](size_t resolution) {
+        return tracks[resolution].covers(keyOf(resolution, query.from));
+    };
+
+    for (size_t resolution = RESOLUTION_COUNT; resolution-- > 0;) {
+        auto key = keyOf(resolution, query.from);
+        auto aligned = query.step % seconds(static_cast<Resolution>(resolution)) == 0 &&
+                       keyStart(resolution, key) == query.from;
+        if (aligned && covers(resolution)) return static_cast<Resolution>(resolution);
+    }
+    for (size_t resolution = 0; resolution < RESOLUTION_COUNT; ++resolution) {
+        if (covers(resolution)) return static_cast<Resolution>(resolution);
+    }
+    return Resolution::Day;
+}
+
+PriceRollups::Result PriceRollups::query(const Query& query) const {
+    if (query.step <= 0) {
+        throw std::runtime_error(fmt::format("Invalid rollup query step: {}s", query.step));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Result result;
+    result.resolution = selectResolution(query);
+    if (query.from >= query.to) return result;
+
+    auto resolution = static_cast<size_t>(result.resolution);
+    auto perPoint = std::max<int64_t>(1, query.step / seconds(result.resolution));
+    auto first = keyOf(resolution, query.from);
+    auto last = keyOf(resolution, query.to - 1) + 1;
+
+    std::vector<const Track*> tracks;
+    if (query.stations.empty()) {
+        tracks.push_back(&area[models::index(query.fuelType)][resolution]);
+    } else {
+        for (auto station : query.stations) {
+            auto index = slot(station, query.fuelType);
+            if (index < series.size() && series[index]) {
+                tracks.push_back(&series[index]->tracks[resolution]);
+            }
+        }
+    }
+
+    for (auto start = first; start < last; start += perPoint) {
+        Point point{keyStart(resolution, start), {}};
+        for (auto key = start; key < std::min(start + perPoint, last); ++key) {
+            for (const auto* track : tracks) {
+                if (const auto* bucket = track->find(key)) {
+                    point.value.merge(*bucket);
+                }
+            }
+        }
+        result.points.push_back(point);
+    }
+    return result;
+}
+
+void PriceRollups::credit(
+    Tracks& tracks,
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    models::TenthCents price,
+    const std::array<models::EpochSeconds, RESOLUTION_COUNT>& floors
+) {
+    for (size_t resolution = 0; resolution < RESOLUTION_COUNT; ++resolution) {
+        auto& track = tracks[resolution];
+        auto retention = options.retention[resolution];
+        auto width = seconds(static_cast<Resolution>(resolution));
+
+        auto period = offsetPeriod(from);
+        for (auto time = std::max(from, floors[resolution]); time < to;) {
+            int64_t key;
+            EpochSeconds next;
+            if (resolution == DAY) {
+                // A local day can span a change of the offset
+                if (time < period.begin || time >= period.end) {
+                    period = offsetPeriod(time);
+                }
+                key = floorDiv(time + period.offset, SECONDS_PER_DAY);
+                next = std::min({to, (key + 1) * SECONDS_PER_DAY - period.offset, period.end});
+            } else {
+                key = floorDiv(time, width);
+                next = std::min(to, (key + 1) * width);
+            }
+
+            if (auto* bucket = track.at(key, retention)) {
+                bucket->add(price, static_cast<uint64_t>(next - time));
+            }
+            time = next;
+        }
+    }
+}
+
+} // namespace analytics
@@ -0,0 +1,179 @@
+#include "analytics/QuantileSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace analytics {
+
+namespace {
+
+// Scale function k1 of the t-digest paper, k(q) = DELTA / (2 pi) asin(2q - 1):
+// a centroid may span at most one unit of k, which is steep near q = 0 and
+// q = 1 and keeps tail centroids small. k runs over [-DELTA / 4, DELTA / 4];
+// as no two neighbouring centroids fit into one unit, a compressed digest
+// has at most DELTA + 1.
+constexpr double DELTA = QuantileSketch::CENTROIDS - 1;
+
+// The q one unit of k after the given one. With s = 2q - 1 and a step of
+// phi = 2 pi / DELTA, sin(asin(s) + phi) = s cos(phi) + sqrt(1 - s^2) sin(phi),
+// so no trigonometric functions are evaluated per centroid.
+double nextLimit(double q) {
+    static const double cosPhi = std::cos(2 * std::numbers::pi / DELTA);
+    static const double sinPhi = std::sin(2 * std::numbers::pi / DELTA);
+
+    auto s = std::clamp(2 * q - 1, -1.0, 1.0);
+    if (s >= cosPhi) return 1.0;  // past the top of the arc sine
+    return (s * cosPhi + std::sqrt(1 - s * s) * sinPhi + 1) / 2;
+}
+
+} // namespace
+
+void QuantileSketch::add(double value, double weight) {
+    if (!(weight > 0) || !std::isfinite(value)) return;
+
+    minValue = total == 0.0 ? value : std::min(minValue, value);
+    maxValue = total == 0.0 ? value : std::max(maxValue, value);
+    total += weight;
+    push({static_cast<float>(value), static_cast<float>(weight)});
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.empty()) return;
+
+    minValue = total == 0.0 ? other.minValue : std::min(minValue, other.minValue);
+    maxValue = total == 0.0 ? other.maxValue : std::max(maxValue, other.maxValue);
+    total += other.total;
+    for (uint32_t i = 0; i < other.centroidCount; ++i) {
+        push(other.centroids[i]);
+    }
+    for (uint32_t i = 0; i < other.buffered; ++i) {
+        push(other.buffer[i]);
+    }
+}
+
+void QuantileSketch::push(Centroid centroid) {
+    if (buffered == BUFFER) {
+        compress();
+    }
+    buffer[buffered++] = centroid;
+}
+
+void QuantileSketch::compress() {
+    if (buffered == 0) return;
+
+    std::array<Centroid, CENTROIDS + BUFFER> all;
+    auto end = std::copy_n(centroids.begin(), centroidCount, all.begin());
+    end = std::copy_n(buffer.begin(), buffered, end);
+    std::sort(all.begin(), end, [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    collapse(all.data(), end);
+}
+
+void QuantileSketch::collapse(const Centroid* begin, const Centroid* end) {
+    double weights = 0.0;
+    for (auto it = begin; it != end; ++it) {
+        weights += it->weight;
+    }
+
+    // Greedily merge neighbours while the merged centroid spans at most one
+    // unit of k
+    centroidCount = 0;
+    double mean = begin->mean;
+    double weight = begin->weight;
+    double before = 0.0;  // weight left of the current centroid
+    double limit = weights * nextLimit(0.0);
+    for (auto it = begin + 1; it != end; ++it) {
+        if (before + weight + it->weight <= limit || centroidCount + 1 == CENTROIDS) {
+            weight += it->weight;
+            mean += (it->mean - mean) * it->weight / weight;
+            continue;
+        }
+        centroids[centroidCount++] = {static_cast<float>(mean), static_cast<float>(weight)};
+        before += weight;
+        limit = weights * nextLimit(before / weights);
+        mean = it->mean;
+        weight = it->weight;
+    }
+    centroids[centroidCount++] = {static_cast<float>(mean), static_cast<float>(weight)};
+    buffered = 0;
+}
+
+template <typename Visit>
+void QuantileSketch::forEachPoint(Visit visit) const {
+    // A centroid at the minimum or maximum stands in for the frame point
+    if (centroidCount == 0 || centroids[0].mean > minValue) {
+        visit(minValue, 0.0);
+    }
+    double cumulative = 0.0;
+    for (uint32_t i = 0; i < centroidCount; ++i) {
+        double weight = centroids[i].weight;
+        visit(std::clamp<double>(centroids[i].mean, minValue, maxValue), cumulative + weight / 2);
+        cumulative += weight;
+    }
+    if (centroidCount == 0 || centroids[centroidCount - 1].mean < maxValue) {
+        visit(maxValue, cumulative);
+    }
+}
+
+std::optional<double> QuantileSketch::quantile(double q) const {
+    if (empty()) return std::nullopt;
+    if (buffered > 0) {
+        auto compressed = *this;
+        compressed.compress();
+        return compressed.quantile(q);
+    }
+
+    // Float centroid weights may sum to slightly less than total
+    double weights = 0.0;
+    for (uint32_t i = 0; i < centroidCount; ++i) {
+        weights += centroids[i].weight;
+    }
+    double target = std::clamp(q, 0.0, 1.0) * weights;
+
+    std::optional<double> result;
+    double previousX = minValue, previousC = 0.0;
+    forEachPoint([&](double x, double c) {
+        if (!result && c >= target) {
+            result = c == previousC ? x : previousX + (target - previousC) / (c - previousC) * (x - previousX);
+        }
+        previousX = x;
+        previousC = c;
+    });
+    return result.value_or(maxValue);
+}
+
+std::optional<double> QuantileSketch::rank(double value) const {
+    if (empty()) return std::nullopt;
+    if (buffered > 0) {
+        auto compressed = *this;
+        compressed.compress();
+        return compressed.rank(value);
+    }
+    if (value < minValue) return 0.0;
+    if (value > maxValue) return 1.0;
+
+    double weights = 0.0;
+    for (uint32_t i = 0; i < centroidCount; ++i) {
+        weights += centroids[i].weight;
+    }
+
+    // Several centroids may sit at the value (a common price); take the
+    // middle between the first and the last of them
+    std::optional<double> left, right;
+    double previousX = minValue, previousC = 0.0;
+    forEachPoint([&](double x, double c) {
+        auto interpolated = [&] { return previousC + (value - previousX) / (x - previousX) * (c - previousC); };
+        if (!left && x >= value) {
+            left = x == value ? c : interpolated();
+        }
+        if (x == value) {
+            right = c;
+        } else if (!right && previousX < value && x > value) {
+            right = interpolated();
+        }
+        previousX = x;
+        previousC = c;
+    });
+    return (left.value_or(weights) + right.value_or(weights)) / 2 / weights;
+}
+
+} // namespace analytics
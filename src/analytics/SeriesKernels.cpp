@@ -0,0 +1,281 @@
+#include "analytics/SeriesKernels.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FUEL_PRICE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace analytics {
+
+namespace {
+
+using models::EpochSeconds;
+using models::TenthCents;
+
+// Records per block in accumulateWeek(), keeps the durations in L1
+constexpr size_t BLOCK_SIZE = 1024;
+
+EpochSeconds duration(EpochSeconds from, EpochSeconds to, EpochSeconds maxGap) {
+    return std::clamp<EpochSeconds>(to - from, 0, maxGap);
+}
+
+SeriesKernels::PriceSummary summarizeScalar(std::span<const TenthCents> prices) {
+    SeriesKernels::PriceSummary summary;
+    if (prices.empty()) return summary;
+
+    TenthCents minPrice = std::numeric_limits<TenthCents>::max();
+    TenthCents maxPrice = std::numeric_limits<TenthCents>::min();
+    int64_t sum = 0;
+    for (auto price : prices) {
+        minPrice = std::min(minPrice, price);
+        maxPrice = std::max(maxPrice, price);
+        sum += price;
+    }
+    return {minPrice, maxPrice, sum, prices.size()};
+}
+
+// Durations of prices[first, first + out.size())
+void durationsScalar(
+    std::span<const EpochSeconds> timestamps,
+    size_t first,
+    EpochSeconds end,
+    EpochSeconds maxGap,
+    std::span<uint32_t> out
+) {
+    for (size_t i = 0; i < out.size(); ++i) {
+        auto index = first + i;
+        auto until = index + 1 < timestamps.size() ? timestamps[index + 1] : end;
+        out[i] = static_cast<uint32_t>(duration(timestamps[index], until, maxGap));
+    }
+}
+
+SeriesKernels::TimeWeighted timeWeightedScalar(
+    std::span<const EpochSeconds> timestamps,
+    std::span<const TenthCents> prices,
+    size_t first,
+    EpochSeconds end,
+    EpochSeconds maxGap
+) {
+    SeriesKernels::TimeWeighted result;
+    for (size_t i = first; i < timestamps.size(); ++i) {
+        auto until = i + 1 < timestamps.size() ? timestamps[i + 1] : end;
+        auto seconds = static_cast<uint64_t>(duration(timestamps[i], until, maxGap));
+        result.weightedSum += seconds * static_cast<uint64_t>(prices[i]);
+        result.seconds += seconds;
+    }
+    return result;
+}
+
+#ifdef FUEL_PRICE_AVX2
+
+__attribute__((target("avx2")))
+int64_t horizontalSum(__m256i values) {
+    alignas(32) std::array<int64_t, 4> lanes;
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), values);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// 8 prices per iteration
+__attribute__((target("avx2")))
+SeriesKernels::PriceSummary summarizeAvx2(std::span<const TenthCents> prices) {
+    if (prices.size() < 8) return summarizeScalar(prices);
+
+    const auto* data = prices.data();
+    auto minimum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    auto maximum = minimum;
+    auto sum = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= prices.size(); i += 8) {
+        auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        minimum = _mm256_min_epi32(minimum, values);
+        maximum = _mm256_max_epi32(maximum, values);
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+    }
+
+    alignas(32) std::array<TenthCents, 8> minLanes, maxLanes;
+    _mm256_store_si256(reinterpret_cast<__m256i*>(minLanes.data()), minimum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxLanes.data()), maximum);
+
+    auto tail = summarizeScalar(prices.subspan(i));
+    SeriesKernels::PriceSummary summary;
+    summary.minPrice = *std::min_element(minLanes.begin(), minLanes.end());
+    summary.maxPrice = *std::max_element(maxLanes.begin(), maxLanes.end());
+    if (tail.count > 0) {
+        summary.minPrice = std::min(summary.minPrice, tail.minPrice);
+        summary.maxPrice = std::max(summary.maxPrice, tail.maxPrice);
+    }
+    summary.sum = horizontalSum(sum) + tail.sum;
+    summary.count = prices.size();
+    return summary;
+}
+
+// Gaps to the next timestamp of 4 consecutive records, clamped to [0, maxGap]
+__attribute__((target("avx2")))
+__m256i durations4(const EpochSeconds* timestamps, __m256i maxGap) {
+    auto current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps));
+    auto next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps + 1));
+    auto gap = _mm256_sub_epi64(next, current);
+    gap = _mm256_blendv_epi8(gap, maxGap, _mm256_cmpgt_epi64(gap, maxGap));
+    return _mm256_andnot_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), gap), gap);
+}
+
+// 4 records per iteration; the last record, which needs `end`, is left to
+// the scalar tail
+__attribute__((target("avx2")))
+SeriesKernels::TimeWeighted timeWeightedAvx2(
+    std::span<const EpochSeconds> timestamps,
+    std::span<const TenthCents> prices,
+    EpochSeconds end,
+    EpochSeconds maxGap
+) {
+    auto gapLimit = _mm256_set1_epi64x(maxGap);
+    auto weighted = _mm256_setzero_si256();
+    auto seconds = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 5 <= timestamps.size(); i += 4) {
+        auto durations = durations4(timestamps.data() + i, gapLimit);
+        auto values = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(prices.data() + i)));
+        weighted = _mm256_add_epi64(weighted, _mm256_mul_epi32(durations, values));
+        seconds = _mm256_add_epi64(seconds, durations);
+    }
+
+    auto tail = timeWeightedScalar(timestamps, prices, i, end, maxGap);
+    tail.weightedSum += static_cast<uint64_t>(horizontalSum(weighted));
+    tail.seconds += static_cast<uint64_t>(horizontalSum(seconds));
+    return tail;
+}
+
+__attribute__((target("avx2")))
+void durationsAvx2(
+    std::span<const EpochSeconds> timestamps,
+    size_t first,
+    EpochSeconds end,
+    EpochSeconds maxGap,
+    std::span<uint32_t> out
+) {
+    auto gapLimit = _mm256_set1_epi64x(maxGap);
+    // Low 32 bits of each 64-bit lane
+    auto narrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+
+    size_t i = 0;
+    for (; i + 4 <= out.size() && first + i + 5 <= timestamps.size(); i += 4) {
+        auto durations = durations4(timestamps.data() + first + i, gapLimit);
+        auto packed = _mm256_permutevar8x32_epi32(durations, narrow);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), _mm256_castsi256_si128(packed));
+    }
+    durationsScalar(timestamps, first + i, end, maxGap, out.subspan(i));
+}
+
+bool cpuSupportsAvx2() {
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+bool cpuSupportsAvx2() {
+    return false;
+}
+
+#endif
+
+// Falls back to scalar when AVX2 is requested but not available
+bool useAvx2(SeriesKernels::Isa isa) {
+    return isa == SeriesKernels::Isa::Avx2 && SeriesKernels::isa() == SeriesKernels::Isa::Avx2;
+}
+
+} // namespace
+
+SeriesKernels::Isa SeriesKernels::isa() {
+    static const Isa best = cpuSupportsAvx2() ? Isa::Avx2 : Isa::Scalar;
+    return best;
+}
+
+SeriesKernels::PriceSummary SeriesKernels::summarize(std::span<const TenthCents> prices, Isa isa) {
+#ifdef FUEL_PRICE_AVX2
+    if (useAvx2(isa)) return summarizeAvx2(prices);
+#endif
+    (void)isa;
+    return summarizeScalar(prices);
+}
+
+SeriesKernels::TimeWeighted SeriesKernels::timeWeighted(
+    std::span<const EpochSeconds> timestamps,
+    std::span<const TenthCents> prices,
+    EpochSeconds end,
+    EpochSeconds maxGap,
+    Isa isa
+) {
+#ifdef FUEL_PRICE_AVX2
+    if (useAvx2(isa)) return timeWeightedAvx2(timestamps, prices, end, maxGap);
+#endif
+    (void)isa;
+    return timeWeightedScalar(timestamps, prices, 0, end, maxGap);
+}
+
+void SeriesKernels::accumulateWeek(
+    std::span<const EpochSeconds> timestamps,
+    std::span<const TenthCents> prices,
+    EpochSeconds end,
+    EpochSeconds maxGap,
+    WeekProfile& profile,
+    Isa isa
+) {
+    if (timestamps.empty()) return;
+
+    // Durations are computed a block at a time with the vector kernel; the
+    // scatter into the buckets has no AVX2 equivalent and stays scalar
+    std::array<uint32_t, BLOCK_SIZE> block;
+    auto period = offsetPeriod(timestamps.front());
+
+    // The local hour [hourBegin, hourEnd) in UTC and its bucket. Timestamps
+    // are ascending, so it only moves forward.
+    EpochSeconds hourBegin = 0, hourEnd = 0;
+    size_t bucket = 0;
+
+    for (size_t first = 0; first < timestamps.size(); first += BLOCK_SIZE) {
+        auto durations = std::span(block).first(std::min(BLOCK_SIZE, timestamps.size() - first));
+#ifdef FUEL_PRICE_AVX2
+        if (useAvx2(isa)) {
+            durationsAvx2(timestamps, first, end, maxGap, durations);
+        } else
+#endif
+        {
+            durationsScalar(timestamps, first, end, maxGap, durations);
+        }
+
+        for (size_t i = 0; i < durations.size(); ++i) {
+            auto from = timestamps[first + i];
+            auto until = from + static_cast<EpochSeconds>(durations[i]);
+            auto price = prices[first + i];
+
+            while (from < until) {
+                if (from >= hourEnd && from < hourEnd + 3600 && hourEnd + 3600 <= period.end) {
+                    hourBegin = hourEnd;
+                    hourEnd += 3600;
+                    bucket = bucket + 1 == HOURS_PER_WEEK ? 0 : bucket + 1;
+                } else if (from >= hourEnd || from < hourBegin) {
+                    if (from < period.begin || from >= period.end) {
+                        period = offsetPeriod(from);
+                    }
+                    // Both offsets are whole hours, so local and UTC hours start together
+                    auto local = from + period.offset;
+                    hourBegin = from - ((local % 3600) + 3600) % 3600;
+                    hourEnd = hourBegin + 3600;
+                    bucket = localHourOfWeek(local);
+                }
+                auto to = std::min(until, hourEnd);
+                profile[bucket].add(price, static_cast<uint32_t>(to - from));
+                from = to;
+            }
+        }
+    }
+    (void)isa;
+}
+
+} // namespace analytics
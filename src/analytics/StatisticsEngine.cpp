@@ -0,0 +1,400 @@
+#include "analytics/StatisticsEngine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+
+namespace analytics {
+
+namespace {
+
+// Indices into the station list of a backfill that one worker still has to
+// do. The owner takes chunks from the front; idle workers steal the back
+// half of the fullest queue.
+struct WorkQueue {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+
+    bool take(size_t chunk, size_t& first, size_t& last) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (begin == end) return false;
+        first = begin;
+        last = begin = std::min(end, begin + chunk);
+        return true;
+    }
+
+    size_t remaining() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return end - begin;
+    }
+};
+
+// Move the back half of the fullest other queue into `own`. False once
+// every queue is empty.
+bool steal(std::vector<WorkQueue>& queues, size_t own) {
+    while (true) {
+        size_t victim = own;
+        size_t most = 0;
+        for (size_t i = 0; i < queues.size(); ++i) {
+            if (i == own) continue;
+            auto remaining = queues[i].remaining();
+            if (remaining > most) {
+                most = remaining;
+                victim = i;
+            }
+        }
+        if (most == 0) return false;
+
+        size_t first, last;
+        {
+            std::lock_guard<std::mutex> lock(queues[victim].mutex);
+            auto& queue = queues[victim];
+            if (queue.begin == queue.end) continue;  // emptied meanwhile
+            first = queue.begin + (queue.end - queue.begin) / 2;
+            last = queue.end;
+            queue.end = first;
+        }
+        std::lock_guard<std::mutex> lock(queues[own].mutex);
+        queues[own].begin = first;
+        queues[own].end = last;
+        return true;
+    }
+}
+
+} // namespace
+
+StatisticsEngine::StatisticsEngine() : StatisticsEngine(Options{}) {}
+
+StatisticsEngine::StatisticsEngine(Options options) : options(options) {}
+
+void StatisticsEngine::observe(
+    models::StationHandle station,
+    models::FuelType fuelType,
+    models::EpochSeconds timestamp,
+    models::TenthCents price
+) {
+    auto& entry = seriesFor(station, fuelType);
+
+    if (entry.lastPrice != models::NO_PRICE) {
+        if (timestamp < entry.lastTimestamp) return;
+
+        auto before = entry.average();
+        auto until = std::min(timestamp, entry.lastTimestamp + options.maxGap.count());
+        credit(entry, entry.lastTimestamp, until, entry.lastPrice);
+        updateAreaAverage(fuelType, before, entry.average());
+    }
+
+    entry.lastTimestamp = timestamp;
+    entry.lastPrice = price;
+    lastUpdate = std::max(lastUpdate, timestamp);
+}
+
+void StatisticsEngine::backfill(const storage::ColumnarHistory& history, models::FuelType fuelType) {
+    for (models::StationHandle station = 0; station < history.stationCount(); ++station) {
+        auto column = history.column(station, fuelType);
+        if (column.empty()) continue;
+
+        auto& entry = seriesFor(station, fuelType);
+        auto before = entry.average();
+        if (!extend(entry, column)) continue;
+
+        updateAreaAverage(fuelType, before, entry.average());
+        lastUpdate = std::max(lastUpdate, entry.lastTimestamp);
+    }
+}
+
+StatisticsEngine::BackfillProgress StatisticsEngine::backfill(
+    const storage::ColumnarHistory& history,
+    std::span<const models::FuelType> fuelTypes,
+    const BackfillOptions& backfillOptions,
+    const ProgressCallback& progress
+) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Series are allocated here, so workers only write to existing ones
+    std::vector<models::StationHandle> stations;
+    BackfillProgress result;
+    for (models::StationHandle station = 0; station < history.stationCount(); ++station) {
+        uint64_t records = 0;
+        for (auto fuelType : fuelTypes) {
+            auto column = history.column(station, fuelType);
+            if (column.empty()) continue;
+            seriesFor(station, fuelType);
+            records += column.size();
+        }
+        if (records == 0) continue;
+        stations.push_back(station);
+        result.totalRecords += records;
+    }
+    result.totalStations = stations.size();
+
+    // Averages before the backfill and whether the series took new records,
+    // by station and position in fuelTypes
+    std::vector<std::optional<double>> before(stations.size() * fuelTypes.size());
+    std::vector<uint8_t> extended(before.size(), 0);
+    for (size_t i = 0; i < stations.size(); ++i) {
+        for (size_t fuel = 0; fuel < fuelTypes.size(); ++fuel) {
+            auto index = slot(stations[i], fuelTypes[fuel]);
+            if (series[index]) {
+                before[i * fuelTypes.size() + fuel] = series[index]->average();
+            }
+        }
+    }
+
+    auto threads = std::max<size_t>(1, std::min(backfillOptions.threads, stations.size()));
+    auto chunk = std::max<size_t>(1, backfillOptions.chunkStations);
+    std::vector<WorkQueue> queues(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues[i].begin = stations.size() * i / threads;
+        queues[i].end = stations.size() * (i + 1) / threads;
+    }
+
+    std::atomic<size_t> stationsDone{0};
+    std::atomic<uint64_t> recordsDone{0};
+    size_t running = threads;
+    std::mutex doneMutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < threads; ++worker) {
+        workers.emplace_back([&, worker] {
+            try {
+                size_t first, last;
+                while (true) {
+                    if (!queues[worker].take(chunk, first, last)) {
+                        if (!steal(queues, worker)) break;
+                        continue;
+                    }
+
+                    uint64_t records = 0;
+                    for (auto i = first; i < last; ++i) {
+                        for (size_t fuel = 0; fuel < fuelTypes.size(); ++fuel) {
+                            auto column = history.column(stations[i], fuelTypes[fuel]);
+                            if (column.empty()) continue;
+                            extended[i * fuelTypes.size() + fuel] =
+                                extend(*series[slot(stations[i], fuelTypes[fuel])], column);
+                            records += column.size();
+                        }
+                    }
+                    stationsDone += last - first;
+                    recordsDone += records;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (!error) error = std::current_exception();
+                // Leave nothing for the others, the result is discarded anyway
+                for (auto& queue : queues) {
+                    std::lock_guard<std::mutex> queueLock(queue.mutex);
+                    queue.begin = queue.end;
+                }
+            }
+            std::lock_guard<std::mutex> lock(doneMutex);
+            --running;
+            done.notify_one();
+        });
+    }
+
+    auto report = [&] {
+        result.stations = stationsDone.load();
+        result.records = recordsDone.load();
+        result.elapsed = std::chrono::steady_clock::now() - start;
+    };
+    {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        while (!done.wait_for(lock, backfillOptions.progressInterval, [&] { return running == 0; })) {
+            if (progress) {
+                report();
+                lock.unlock();
+                progress(result);
+                lock.lock();
+            }
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // Area averages in station order, as the sequential backfill does
+    for (size_t i = 0; i < stations.size(); ++i) {
+        for (size_t fuel = 0; fuel < fuelTypes.size(); ++fuel) {
+            if (!extended[i * fuelTypes.size() + fuel]) continue;
+
+            auto& entry = *series[slot(stations[i], fuelTypes[fuel])];
+            updateAreaAverage(fuelTypes[fuel], before[i * fuelTypes.size() + fuel], entry.average());
+            lastUpdate = std::max(lastUpdate, entry.lastTimestamp);
+        }
+    }
+
+    report();
+    if (progress) {
+        progress(result);
+    }
+    return result;
+}
+
+std::optional<double> StatisticsEngine::averagePrice(models::StationHandle station, models::FuelType fuelType) const {
+    auto index = slot(station, fuelType);
+    if (index >= series.size() || !series[index]) return std::nullopt;
+    return series[index]->average();
+}
+
+std::optional<double> StatisticsEngine::areaAveragePrice(models::FuelType fuelType) const {
+    auto fuel = models::index(fuelType);
+    if (averageCounts[fuel] == 0) return std::nullopt;
+    return averageSums[fuel] / static_cast<double>(averageCounts[fuel]);
+}
+
+std::optional<models::StationStatistics> StatisticsEngine::stationStatistics(
+    models::StationHandle station,
+    models::FuelType fuelType,
+    const Labeler& labeler
+) const {
+    auto index = slot(station, fuelType);
+    if (index >= series.size() || !series[index] || !series[index]->average()) return std::nullopt;
+
+    auto result = buildStatistics(*series[index], station, labeler);
+
+    // Typically cheapest: within the cheapest share of stations by average
+    auto average = *series[index]->average();
+    size_t cheaper = 0;
+    for (size_t i = models::index(fuelType); i < series.size(); i += models::FUEL_TYPE_COUNT) {
+        if (series[i] && series[i]->average() && *series[i]->average() < average) ++cheaper;
+    }
+    auto cheapestCount = static_cast<size_t>(std::ceil(options.cheapestFraction * static_cast<double>(averageCounts[models::index(fuelType)])));
+    result.isTypicallyCheapest = cheaper < cheapestCount;
+    return result;
+}
+
+models::PriceStatistics StatisticsEngine::statistics(models::FuelType fuelType, const Labeler& labeler) const {
+    std::vector<std::pair<double, models::StationHandle>> averages;
+    for (size_t i = models::index(fuelType); i < series.size(); i += models::FUEL_TYPE_COUNT) {
+        if (!series[i]) continue;
+        if (auto average = series[i]->average()) {
+            averages.emplace_back(*average, static_cast<models::StationHandle>(i / models::FUEL_TYPE_COUNT));
+        }
+    }
+    std::sort(averages.begin(), averages.end());
+
+    models::PriceStatistics result;
+    result.fuelType = std::string(models::toString(fuelType));
+    result.areaAveragePrice = areaAveragePrice(fuelType).value_or(0.0) / 1000.0;
+    result.lastUpdate = lastUpdate != 0 ? models::formatTimestamp(lastUpdate) : std::string();
+
+    auto cheapestCount = static_cast<size_t>(std::ceil(options.cheapestFraction * static_cast<double>(averages.size())));
+    result.stationStats.reserve(averages.size());
+    for (size_t i = 0; i < averages.size(); ++i) {
+        auto station = averages[i].second;
+        auto stats = buildStatistics(*series[slot(station, fuelType)], station, labeler);
+        stats.isTypicallyCheapest = i < cheapestCount;
+        result.stationStats.push_back(std::move(stats));
+    }
+    return result;
+}
+
+StatisticsEngine::Series& StatisticsEngine::seriesFor(models::StationHandle station, models::FuelType fuelType) {
+    auto index = slot(station, fuelType);
+    if (index >= series.size()) {
+        series.resize(index + 1);
+    }
+    if (!series[index]) {
+        series[index] = std::make_unique<Series>();
+    }
+    return *series[index];
+}
+
+void StatisticsEngine::updateAreaAverage(
+    models::FuelType fuelType,
+    std::optional<double> before,
+    std::optional<double> after
+) {
+    if (!after) return;
+
+    auto fuel = models::index(fuelType);
+    if (before) {
+        averageSums[fuel] -= *before;
+    } else {
+        ++averageCounts[fuel];
+        ++seriesWithData;
+    }
+    averageSums[fuel] += *after;
+}
+
+void StatisticsEngine::credit(
+    Series& entry,
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    models::TenthCents price
+) const {
+    auto clamped = std::clamp<models::TenthCents>(price, 0, UINT16_MAX);
+
+    // At most maxGap / 1h + 1 buckets
+    while (from < to) {
+        auto end = std::min(nextHour(from), to);
+        auto seconds = static_cast<uint32_t>(end - from);
+
+        entry.buckets[hourOfWeek(from)].add(clamped, seconds);
+        entry.weightedSum += static_cast<uint64_t>(seconds) * static_cast<uint64_t>(clamped);
+        entry.seconds += seconds;
+        from = end;
+    }
+}
+
+bool StatisticsEngine::extend(Series& entry, const storage::ColumnarHistory::Column& column) const {
+    // Records the series has already seen are skipped
+    size_t first = 0;
+    if (entry.lastPrice != models::NO_PRICE) {
+        first = static_cast<size_t>(std::lower_bound(column.timestamps.begin(), column.timestamps.end(),
+                                                     entry.lastTimestamp) - column.timestamps.begin());
+    }
+    if (first == column.size()) return false;
+
+    // The first new record closes the gap to the last observation, like
+    // observe() does
+    if (entry.lastPrice != models::NO_PRICE) {
+        auto until = std::min(column.timestamps[first], entry.lastTimestamp + options.maxGap.count());
+        credit(entry, entry.lastTimestamp, until, entry.lastPrice);
+    }
+    entry.lastTimestamp = column.timestamps[first];
+    entry.lastPrice = column.prices[first];
+
+    auto timestamps = column.timestamps.subspan(first);
+    auto prices = column.prices.subspan(first);
+    if (timestamps.size() < 2) return true;
+
+    // The last price stays open until the next observation, like in observe()
+    auto end = timestamps.back();
+    auto maxGap = options.maxGap.count();
+    SeriesKernels::accumulateWeek(timestamps, prices, end, maxGap, entry.buckets);
+    auto total = SeriesKernels::timeWeighted(timestamps, prices, end, maxGap);
+    entry.weightedSum += total.weightedSum;
+    entry.seconds += total.seconds;
+
+    entry.lastTimestamp = end;
+    entry.lastPrice = prices.back();
+    return true;
+}
+
+models::StationStatistics StatisticsEngine::buildStatistics(
+    const Series& entry,
+    models::StationHandle station,
+    const Labeler& labeler
+) const {
+    auto label = labeler(station);
+
+    models::StationStatistics result;
+    result.stationId = std::move(label.id);
+    result.stationName = std::move(label.name);
+    result.averagePrice = entry.average().value_or(0.0) / 1000.0;
+    result.isTypicallyCheapest = false;
+
+    result.weeklyStats = weeklyStatistics(entry.buckets);
+    return result;
+}
+
+} // namespace analytics
@@ -0,0 +1,58 @@
+#include "analytics/WeekProfile.hpp"
+#include <optional>
+#include <utility>
+#include <fmt/format.h>
+
+namespace analytics {
+
+namespace {
+
+std::string formatHour(size_t hour) {
+    return fmt::format("{:02}:00", hour);
+}
+
+} // namespace
+
+models::WeeklyStatistics weeklyStatistics(const WeekProfile& profile) {
+    models::WeeklyStatistics result;
+
+    std::optional<std::pair<double, size_t>> cheapestDay, mostExpensiveDay;
+    for (size_t day = 0; day < DAYS_PER_WEEK; ++day) {
+        HourBucket total;
+        uint64_t seconds = 0;  // a day can exceed the 32-bit bucket counter
+        std::optional<std::pair<double, size_t>> bestHour, worstHour;
+
+        for (size_t hour = 0; hour < HOURS_PER_DAY; ++hour) {
+            const auto& bucket = profile[day * HOURS_PER_DAY + hour];
+            if (bucket.seconds == 0) continue;
+
+            total.weightedSum += bucket.weightedSum;
+            seconds += bucket.seconds;
+            total.minPrice = std::min(total.minPrice, bucket.minPrice);
+            total.maxPrice = std::max(total.maxPrice, bucket.maxPrice);
+
+            double average = static_cast<double>(bucket.weightedSum) / bucket.seconds;
+            if (!bestHour || average < bestHour->first) bestHour = {average, hour};
+            if (!worstHour || average > worstHour->first) worstHour = {average, hour};
+        }
+        if (seconds == 0) continue;
+
+        auto average = static_cast<double>(total.weightedSum) / static_cast<double>(seconds);
+        result.dailyStats[std::string(DAY_NAMES[day])] = {
+            .minPrice = models::toEuros(total.minPrice),
+            .maxPrice = models::toEuros(total.maxPrice),
+            .avgPrice = average / 1000.0,
+            .bestTimeToRefuel = formatHour(bestHour->second),
+            .worstTimeToRefuel = formatHour(worstHour->second)
+        };
+
+        if (!cheapestDay || average < cheapestDay->first) cheapestDay = {average, day};
+        if (!mostExpensiveDay || average > mostExpensiveDay->first) mostExpensiveDay = {average, day};
+    }
+
+    if (cheapestDay) result.cheapestDay = std::string(DAY_NAMES[cheapestDay->second]);
+    if (mostExpensiveDay) result.mostExpensiveDay = std::string(DAY_NAMES[mostExpensiveDay->second]);
+    return result;
+}
+
+} // namespace analytics
@@ -0,0 +1,245 @@
+#include "api/RequestEngine.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace api {
+
+RequestEngine::RequestEngine() : RequestEngine(Options{}) {}
+
+RequestEngine::RequestEngine(Options options) : options(options) {
+    if (this->options.maxConcurrentRequests == 0) {
+        throw std::invalid_argument("maxConcurrentRequests must be at least 1");
+    }
+
+    multi = curl_multi_init();
+    share = curl_share_init();
+    if (!multi || !share) {
+        if (multi) curl_multi_cleanup(multi);
+        if (share) curl_share_cleanup(share);
+        throw std::runtime_error("Failed to initialize CURL");
+    }
+
+    // The share handle is only used from the worker thread, so it needs no
+    // lock callbacks
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(this->options.maxConcurrentRequests));
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+    worker = std::thread(&RequestEngine::run, this);
+}
+
+RequestEngine::~RequestEngine() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    curl_multi_wakeup(multi);
+    worker.join();
+
+    for (CURL* handle : idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(multi);
+    curl_share_cleanup(share);
+}
+
+std::future<HttpResponse> RequestEngine::submit(HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    auto future = promise->get_future();
+
+    submit(std::move(request), [promise](std::exception_ptr error, HttpResponse response) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(std::move(response));
+        }
+    });
+
+    return future;
+}
+
+void RequestEngine::submit(HttpRequest request, Completion completion) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->completion = std::move(completion);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) {
+            throw std::runtime_error("Request engine is shutting down");
+        }
+        pending.push_back(std::move(transfer));
+    }
+    curl_multi_wakeup(multi);
+}
+
+void RequestEngine::run() {
+    while (true) {
+        std::vector<std::unique_ptr<Transfer>> starting;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping) break;
+
+            while (!pending.empty() && active.size() + starting.size() < options.maxConcurrentRequests) {
+                starting.push_back(std::move(pending.front()));
+                pending.pop_front();
+            }
+        }
+
+        for (auto& transfer : starting) {
+            startTransfer(std::move(transfer));
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        bool finished = false;
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finishTransfer(msg->easy_handle, msg->data.result);
+                finished = true;
+            }
+        }
+
+        // Freed slots may be taken by queued requests right away
+        if (!finished) {
+            curl_multi_poll(multi, nullptr, 0, POLL_TIMEOUT_MS, nullptr);
+        }
+    }
+
+    abortAll();
+}
+
+void RequestEngine::startTransfer(std::unique_ptr<Transfer> transfer) {
+    CURL* handle = nullptr;
+    if (!idleHandles.empty()) {
+        handle = idleHandles.back();
+        idleHandles.pop_back();
+        curl_easy_reset(handle);
+    } else {
+        handle = curl_easy_init();
+    }
+
+    if (!handle) {
+        complete(*transfer, std::make_exception_ptr(std::runtime_error("Failed to initialize CURL")), {});
+        return;
+    }
+
+    for (const auto& header : transfer->request.headers) {
+        transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+    }
+
+    curl_easy_setopt(handle, CURLOPT_URL, transfer->request.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer->headers);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer->response.body);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &transfer->response);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, options.timeoutSeconds);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(handle, CURLOPT_SHARE, share);
+
+    curl_multi_add_handle(multi, handle);
+    active.emplace(handle, std::move(transfer));
+}
+
+void RequestEngine::finishTransfer(CURL* handle, CURLcode result) {
+    curl_multi_remove_handle(multi, handle);
+
+    auto it = active.find(handle);
+    auto transfer = std::move(it->second);
+    active.erase(it);
+
+    curl_slist_free_all(transfer->headers);
+    idleHandles.push_back(handle);
+
+    if (result == CURLE_OK) {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &transfer->response.status);
+        complete(*transfer, nullptr, std::move(transfer->response));
+    } else {
+        complete(*transfer, std::make_exception_ptr(std::runtime_error(
+            fmt::format("CURL request failed: {}", curl_easy_strerror(result)))), {});
+    }
+}
+
+void RequestEngine::abortAll() {
+    auto error = std::make_exception_ptr(std::runtime_error("Request engine is shutting down"));
+
+    for (auto& [handle, transfer] : active) {
+        curl_multi_remove_handle(multi, handle);
+        curl_slist_free_all(transfer->headers);
+        complete(*transfer, error, {});
+        idleHandles.push_back(handle);
+    }
+    active.clear();
+
+    std::deque<std::unique_ptr<Transfer>> aborted;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        aborted.swap(pending);
+    }
+    for (auto& transfer : aborted) {
+        complete(*transfer, error, {});
+    }
+}
+
+// A throwing completion must not unwind into the worker loop, which would
+// terminate the process and strand every other transfer
+void RequestEngine::complete(Transfer& transfer, std::exception_ptr error, HttpResponse response) {
+    try {
+        transfer.completion(error, std::move(response));
+    } catch (const std::exception& e) {
+        std::cerr << fmt::format("Request completion failed: {}", e.what()) << std::endl;
+    } catch (...) {
+        std::cerr << "Request completion failed with an unknown exception" << std::endl;
+    }
+}
+
+size_t RequestEngine::WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    ((std::string*)userp)->append((char*)contents, size * nmemb);
+    return size * nmemb;
+}
+
+size_t RequestEngine::HeaderCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+    auto* response = static_cast<HttpResponse*>(userp);
+    std::string line(buffer, size * nitems);
+
+    // A new status line starts the headers of a redirected or continued response
+    if (line.rfind("HTTP/", 0) == 0) {
+        response->headers.clear();
+        return size * nitems;
+    }
+
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+        return size * nitems;
+    }
+
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    auto valueStart = line.find_first_not_of(" \t", colon + 1);
+    auto valueEnd = line.find_last_not_of(" \t\r\n");
+    auto& value = response->headers[name];
+    value = valueStart == std::string::npos || valueEnd < valueStart
+        ? std::string()
+        : line.substr(valueStart, valueEnd - valueStart + 1);
+
+    // Size the body buffer once instead of growing it chunk by chunk
+    if (name == "content-length") {
+        constexpr size_t MAX_BODY_RESERVE = 64 * 1024 * 1024;
+        response->body.reserve(std::min<size_t>(std::strtoul(value.c_str(), nullptr, 10), MAX_BODY_RESERVE));
+    }
+
+    return size * nitems;
+}
+
+} // namespace api
@@ -0,0 +1,201 @@
+#include "api/RequestScheduler.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace api {
+
+RequestScheduler::RequestScheduler(RequestEngine::Options engineOptions)
+    : RequestScheduler(engineOptions, Options{}) {}
+
+RequestScheduler::RequestScheduler(RequestEngine::Options engineOptions, Options options)
+    : options(options),
+      tokens(options.burst),
+      lastRefill(Clock::now()),
+      pausedUntil(Clock::now()),
+      engine(engineOptions) {
+    worker = std::thread(&RequestScheduler::run, this);
+}
+
+RequestScheduler::~RequestScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_one();
+    worker.join();
+}
+
+std::shared_future<HttpResponse> RequestScheduler::submit(HttpRequest request, Priority priority) {
+    auto key = coalescingKey(request);
+    auto index = static_cast<size_t>(priority);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) {
+        throw std::runtime_error("Request scheduler is shutting down");
+    }
+
+    ++stats[index].submitted;
+
+    if (auto it = pending.find(key); it != pending.end()) {
+        auto& job = it->second;
+        ++stats[index].coalesced;
+
+        // A queued job inherits the most urgent priority it was asked for
+        if (!job->dispatched && priority < job->priority) {
+            auto& from = queues[static_cast<size_t>(job->priority)];
+            from.erase(std::find(from.begin(), from.end(), job));
+            job->priority = priority;
+            queues[index].push_back(job);
+            wakeup.notify_one();
+        }
+        return job->future;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->key = key;
+    job->request = std::move(request);
+    job->priority = priority;
+    job->future = job->promise.get_future().share();
+    job->enqueuedAt = Clock::now();
+
+    pending.emplace(key, job);
+    queues[index].push_back(job);
+    wakeup.notify_one();
+
+    return job->future;
+}
+
+std::array<RequestScheduler::Metrics, RequestScheduler::PRIORITY_COUNT> RequestScheduler::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void RequestScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!stopping) {
+        auto queue = std::find_if(queues.begin(), queues.end(),
+            [](const auto& q) { return !q.empty(); });
+        if (queue == queues.end()) {
+            wakeup.wait(lock);
+            continue;
+        }
+
+        auto now = Clock::now();
+        if (now < pausedUntil) {
+            wakeup.wait_until(lock, pausedUntil);
+            continue;
+        }
+
+        refill(now);
+        if (options.requestsPerMinute > 0 && tokens < 1.0) {
+            auto missing = std::chrono::duration<double>((1.0 - tokens) * 60.0 / options.requestsPerMinute);
+            wakeup.wait_for(lock, std::chrono::duration_cast<Clock::duration>(missing) + std::chrono::milliseconds(1));
+            continue;
+        }
+
+        auto job = queue->front();
+        queue->pop_front();
+        tokens -= 1.0;
+
+        auto& stat = stats[static_cast<size_t>(job->priority)];
+        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(now - job->enqueuedAt);
+        ++stat.dispatched;
+        stat.totalQueueWait += wait;
+        stat.maxQueueWait = std::max(stat.maxQueueWait, wait);
+        job->dispatched = true;
+
+        lock.unlock();
+        dispatch(std::move(job));
+        lock.lock();
+    }
+
+    // Fail whatever is still waiting for a token
+    auto error = std::make_exception_ptr(std::runtime_error("Request scheduler is shutting down"));
+    for (auto& queue : queues) {
+        for (auto& job : queue) {
+            pending.erase(job->key);
+            job->promise.set_exception(error);
+        }
+        queue.clear();
+    }
+}
+
+void RequestScheduler::dispatch(std::shared_ptr<Job> job) {
+    try {
+        engine.submit(job->request, [this, job](std::exception_ptr error, HttpResponse response) {
+            complete(job, error, std::move(response));
+        });
+    } catch (...) {
+        complete(job, std::current_exception(), {});
+    }
+}
+
+void RequestScheduler::complete(const std::shared_ptr<Job>& job, std::exception_ptr error, HttpResponse response) {
+    bool throttled = !error && (response.status == 429 || response.status == 503);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (throttled) {
+            ++stats[static_cast<size_t>(job->priority)].throttled;
+
+            // Back off for everyone: the budget is shared by the whole key
+            if (job->attempts < options.maxRetries && !stopping) {
+                ++job->attempts;
+                auto now = Clock::now();
+                pausedUntil = std::max(pausedUntil, now + retryDelay(response, job->attempts));
+                tokens = 0.0;
+                lastRefill = pausedUntil;
+
+                job->dispatched = false;
+                job->enqueuedAt = now;
+                queues[static_cast<size_t>(job->priority)].push_front(job);
+                wakeup.notify_one();
+                return;
+            }
+        }
+
+        pending.erase(job->key);
+    }
+
+    if (error) {
+        job->promise.set_exception(error);
+    } else {
+        job->promise.set_value(std::move(response));
+    }
+}
+
+void RequestScheduler::refill(Clock::time_point now) {
+    if (now <= lastRefill) return;
+
+    std::chrono::duration<double> elapsed = now - lastRefill;
+    tokens = std::min(options.burst, tokens + elapsed.count() * options.requestsPerMinute / 60.0);
+    lastRefill = now;
+}
+
+std::chrono::milliseconds RequestScheduler::retryDelay(const HttpResponse& response, int attempt) const {
+    // Honour Retry-After when given in seconds, otherwise back off exponentially
+    if (auto it = response.headers.find("retry-after"); it != response.headers.end()) {
+        char* end = nullptr;
+        long seconds = std::strtol(it->second.c_str(), &end, 10);
+        if (end != it->second.c_str() && seconds >= 0) {
+            return std::min<std::chrono::milliseconds>(std::chrono::seconds(seconds), options.maxBackoff);
+        }
+    }
+
+    auto delay = options.initialBackoff * (1LL << std::min(attempt - 1, 16));
+    return std::min<std::chrono::milliseconds>(delay, options.maxBackoff);
+}
+
+std::string RequestScheduler::coalescingKey(const HttpRequest& request) {
+    std::string key = request.url;
+    for (const auto& header : request.headers) {
+        key += '\n';
+        key += header;
+    }
+    return key;
+}
+
+} // namespace api
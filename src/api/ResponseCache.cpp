@@ -0,0 +1,187 @@
+#include "api/ResponseCache.hpp"
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <unistd.h>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+namespace api {
+
+namespace {
+
+// FNV-1a, only used to derive file names; the full key is stored in the file
+uint64_t hashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+ResponseCache::ResponseCache(Options options) : options(std::move(options)) {
+    if (!this->options.directory.empty()) {
+        std::filesystem::create_directories(this->options.directory);
+    }
+}
+
+std::string ResponseCache::makeKey(
+    const std::string& endpoint,
+    const std::map<std::string, std::string>& params
+) {
+    // std::map keeps the parameters sorted, so equal requests get equal keys
+    std::string key = endpoint;
+    char separator = '?';
+    for (const auto& [name, value] : params) {
+        if (name == "apikey") continue;
+        key += separator;
+        key += name + "=" + value;
+        separator = '&';
+    }
+    return key;
+}
+
+std::optional<ResponseCache::Lookup> ResponseCache::lookup(
+    const std::string& key,
+    const std::string& endpoint,
+    Clock::time_point now
+) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::optional<Entry> entry;
+    if (auto it = memory.find(key); it != memory.end()) {
+        recency.splice(recency.begin(), recency, it->second.position);
+        entry = it->second.entry;
+    } else if ((entry = readDisk(key))) {
+        insertMemory(key, *entry);
+    }
+
+    if (!entry) {
+        return std::nullopt;
+    }
+
+    bool fresh = now - entry->storedAt < ttlFor(endpoint);
+    return Lookup{std::move(*entry), fresh};
+}
+
+void ResponseCache::store(const std::string& key, Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    writeDisk(key, entry);
+    insertMemory(key, std::move(entry));
+}
+
+void ResponseCache::refresh(const std::string& key, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = memory.find(key);
+    if (it == memory.end()) {
+        auto entry = readDisk(key);
+        if (!entry) return;
+        insertMemory(key, std::move(*entry));
+        it = memory.find(key);
+        if (it == memory.end()) return;
+    }
+
+    it->second.entry.storedAt = now;
+    writeDisk(key, it->second.entry);
+}
+
+std::chrono::seconds ResponseCache::ttlFor(const std::string& endpoint) const {
+    auto it = options.ttls.find(endpoint);
+    return it != options.ttls.end() ? it->second : options.defaultTtl;
+}
+
+void ResponseCache::insertMemory(const std::string& key, Entry entry) {
+    if (auto it = memory.find(key); it != memory.end()) {
+        memoryUsed -= entrySize(key, it->second.entry);
+        recency.erase(it->second.position);
+        memory.erase(it);
+    }
+
+    size_t size = entrySize(key, entry);
+    if (size > options.memoryBytes) return;
+
+    while (memoryUsed + size > options.memoryBytes && !recency.empty()) {
+        auto& oldest = recency.back();
+        auto it = memory.find(oldest);
+        memoryUsed -= entrySize(oldest, it->second.entry);
+        memory.erase(it);
+        recency.pop_back();
+    }
+
+    recency.push_front(key);
+    memory.emplace(key, MemoryEntry{std::move(entry), recency.begin()});
+    memoryUsed += size;
+}
+
+std::optional<ResponseCache::Entry> ResponseCache::readDisk(const std::string& key) const {
+    if (options.directory.empty()) return std::nullopt;
+
+    std::ifstream file(diskPath(key), std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    // First line holds the metadata, the rest of the file is the body
+    std::string header;
+    if (!std::getline(file, header)) return std::nullopt;
+
+    try {
+        auto meta = nlohmann::json::parse(header);
+        if (meta.at("key").get<std::string>() != key) return std::nullopt;
+
+        Entry entry;
+        entry.etag = meta.value("etag", "");
+        entry.lastModified = meta.value("lastModified", "");
+        entry.storedAt = Clock::time_point(std::chrono::seconds(meta.at("storedAt").get<int64_t>()));
+
+        std::ostringstream body;
+        body << file.rdbuf();
+        entry.body = body.str();
+        return entry;
+    } catch (const std::exception&) {
+        // Corrupt or foreign file, treat as a miss
+        return std::nullopt;
+    }
+}
+
+void ResponseCache::writeDisk(const std::string& key, const Entry& entry) const {
+    if (options.directory.empty()) return;
+
+    nlohmann::json meta = {
+        {"key", key},
+        {"etag", entry.etag},
+        {"lastModified", entry.lastModified},
+        {"storedAt", std::chrono::duration_cast<std::chrono::seconds>(entry.storedAt.time_since_epoch()).count()}
+    };
+
+    // Write to a temporary file and rename it so that concurrent readers in
+    // other processes never see a partial entry. Writes within this process
+    // are serialized by the mutex, so the process ID makes the name unique.
+    auto path = diskPath(key);
+    auto tempPath = path;
+    tempPath += fmt::format(".{}.tmp", getpid());
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return;
+        file << meta.dump() << '\n' << entry.body;
+        if (!file) return;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+std::filesystem::path ResponseCache::diskPath(const std::string& key) const {
+    return options.directory / fmt::format("{:016x}.cache", hashKey(key));
+}
+
+size_t ResponseCache::entrySize(const std::string& key, const Entry& entry) {
+    return key.size() + entry.body.size() + entry.etag.size() + entry.lastModified.size();
+}
+
+} // namespace api
@@ -0,0 +1,244 @@
+#include "api/StationDecoder.hpp"
+#include <optional>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace api {
+
+namespace {
+
+using json = nlohmann::json;
+
+enum class Field {
+    None,
+    Id, Name, Brand,
+    Latitude, Longitude, Street, HouseNumber, PostCode, Place,
+    IsOpen, Status, Distance, LastChange,
+    E5, E10, Diesel
+};
+
+Field lookupField(std::string_view key) {
+    static const std::pair<std::string_view, Field> fields[] = {
+        {"id", Field::Id}, {"name", Field::Name}, {"brand", Field::Brand},
+        {"lat", Field::Latitude}, {"lng", Field::Longitude},
+        {"street", Field::Street}, {"houseNumber", Field::HouseNumber},
+        {"postCode", Field::PostCode}, {"place", Field::Place},
+        {"isOpen", Field::IsOpen}, {"status", Field::Status},
+        {"dist", Field::Distance}, {"lastChange", Field::LastChange},
+        {"e5", Field::E5}, {"e10", Field::E10}, {"diesel", Field::Diesel}
+    };
+
+    for (const auto& [name, field] : fields) {
+        if (name == key) return field;
+    }
+    return Field::None;
+}
+
+// Station objects sit at a fixed depth for each endpoint:
+//   list.php    {"stations": [ {station}, ... ]}
+//   detail.php  {"station": {station}}
+//   prices.php  {"prices": {"<id>": {station}, ...}}
+class Handler : public nlohmann::json_sax<json> {
+public:
+    explicit Handler(StationDecoder::Endpoint endpoint)
+        : endpoint(endpoint),
+          section(endpoint == StationDecoder::Endpoint::List ? "stations"
+                  : endpoint == StationDecoder::Endpoint::Detail ? "station" : "prices"),
+          stationDepth(endpoint == StationDecoder::Endpoint::Detail ? 2 : 3) {}
+
+    StationDecoder::Result result;
+    std::string error;
+
+    bool null() override {
+        return true;
+    }
+
+    bool boolean(bool val) override {
+        if (depth == 1 && topKey == "ok") {
+            result.ok = val;
+        } else if (atStationField() && field == Field::IsOpen) {
+            station.isOpen = val;
+        }
+        // e5/e10/diesel are false for fuel types a station doesn't sell
+        return true;
+    }
+
+    bool number_integer(number_integer_t val) override {
+        return number(static_cast<double>(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        return number(static_cast<double>(val));
+    }
+
+    bool number_float(number_float_t val, const string_t&) override {
+        return number(val);
+    }
+
+    bool string(string_t& val) override {
+        if (depth == 1 && topKey == "message") {
+            result.message = std::move(val);
+            return true;
+        }
+        if (!atStationField()) return true;
+
+        switch (field) {
+            case Field::Id: station.id = std::move(val); break;
+            case Field::Name: station.name = std::move(val); break;
+            case Field::Brand: station.brand = std::move(val); break;
+            case Field::Street: station.location.street = std::move(val); break;
+            case Field::HouseNumber: station.location.houseNumber = std::move(val); break;
+            case Field::PostCode: station.location.postalCode = std::move(val); break;
+            case Field::Place: station.location.city = std::move(val); break;
+            case Field::Status: status = std::move(val); break;
+            case Field::LastChange: lastChange = std::move(val); break;
+            default: break;
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override {
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        ++depth;
+        if (depth == 2 && topKey == section) {
+            inSection = true;
+        }
+        if (inSection && depth == stationDepth) {
+            beginStation();
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (inStation && depth == stationDepth) {
+            endStation();
+        }
+        return leave();
+    }
+
+    bool start_array(std::size_t) override {
+        ++depth;
+        if (depth == 2 && topKey == section) {
+            inSection = true;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        return leave();
+    }
+
+    bool key(string_t& val) override {
+        if (depth == 1) {
+            topKey = val;
+        } else if (inStation && depth == stationDepth) {
+            field = lookupField(val);
+        } else if (inSection && depth == 2 && endpoint == StationDecoder::Endpoint::Prices) {
+            pendingId = std::move(val);
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override {
+        error = fmt::format("Failed to parse response at byte {}: {}", position, ex.what());
+        return false;
+    }
+
+private:
+    bool atStationField() const {
+        return inStation && depth == stationDepth;
+    }
+
+    bool number(double val) {
+        if (!atStationField()) return true;
+
+        switch (field) {
+            case Field::Latitude: station.location.latitude = val; break;
+            case Field::Longitude: station.location.longitude = val; break;
+            case Field::Distance: station.distance = val; break;
+            // The API sends post codes as numbers, dropping leading zeros
+            case Field::PostCode: station.location.postalCode = fmt::format("{:05}", static_cast<long long>(val)); break;
+            case Field::E5: e5 = val; break;
+            case Field::E10: e10 = val; break;
+            case Field::Diesel: diesel = val; break;
+            default: break;
+        }
+        return true;
+    }
+
+    void beginStation() {
+        inStation = true;
+        field = Field::None;
+        station = models::FuelStation{};
+        station.isOpen = false;
+        station.distance = 0.0;
+        station.location.latitude = 0.0;
+        station.location.longitude = 0.0;
+        if (endpoint == StationDecoder::Endpoint::Prices) {
+            station.id = std::move(pendingId);
+        }
+        status.clear();
+        lastChange.clear();
+        e5.reset();
+        e10.reset();
+        diesel.reset();
+    }
+
+    void endStation() {
+        inStation = false;
+
+        if (endpoint == StationDecoder::Endpoint::Prices) {
+            // Unknown IDs are reported with status "no stations"
+            if (status.empty() || status == "no stations") return;
+            station.isOpen = status == "open";
+        }
+
+        // lastChange applies to every fuel type of the station
+        if (e5) station.prices.push_back({.fuelType = "e5", .price = *e5, .lastUpdate = lastChange});
+        if (e10) station.prices.push_back({.fuelType = "e10", .price = *e10, .lastUpdate = lastChange});
+        if (diesel) station.prices.push_back({.fuelType = "diesel", .price = *diesel, .lastUpdate = lastChange});
+
+        result.stations.push_back(std::move(station));
+    }
+
+    bool leave() {
+        if (depth == 2) {
+            inSection = false;
+        }
+        --depth;
+        return true;
+    }
+
+    StationDecoder::Endpoint endpoint;
+    std::string_view section;
+    int stationDepth;
+
+    int depth = 0;
+    std::string topKey;
+    bool inSection = false;
+    bool inStation = false;
+    Field field = Field::None;
+    std::string pendingId;
+
+    models::FuelStation station;
+    std::string status;
+    std::string lastChange;
+    std::optional<double> e5;
+    std::optional<double> e10;
+    std::optional<double> diesel;
+};
+
+} // namespace
+
+StationDecoder::Result StationDecoder::decode(std::string_view body, Endpoint endpoint) {
+    Handler handler(endpoint);
+    if (!json::sax_parse(body.begin(), body.end(), &handler)) {
+        throw std::runtime_error(handler.error.empty() ? "Failed to parse response" : handler.error);
+    }
+    return std::move(handler.result);
+}
+
+} // namespace api
@@ -1,20 +1,29 @@
 #include "api/TankerkoenigAPI.hpp"
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
+#include <iterator>
 #include <fmt/format.h>
 
 namespace api {
 
-TankerkoenigAPI::TankerkoenigAPI(const std::string& apiKey) : apiKey(apiKey) {
-    curl = curl_easy_init();
-    if (!curl) {
-        throw std::runtime_error("Failed to initialize CURL");
-    }
+namespace {
+
+TankerkoenigAPI::Options defaultOptions(long timeoutSeconds) {
+    TankerkoenigAPI::Options options;
+    options.engine.timeoutSeconds = timeoutSeconds;
+    return options;
 }
 
-TankerkoenigAPI::~TankerkoenigAPI() {
-    if (curl) {
-        curl_easy_cleanup(curl);
+} // namespace
+
+TankerkoenigAPI::TankerkoenigAPI(const std::string& apiKey)
+    : TankerkoenigAPI(apiKey, defaultOptions(TIMEOUT_SECONDS)) {}
+
+TankerkoenigAPI::TankerkoenigAPI(const std::string& apiKey, Options options)
+    : apiKey(apiKey), baseUrl(std::move(options.baseUrl)), scheduler(options.engine, options.scheduler) {
+    if (options.cache) {
+        cache = std::make_unique<ResponseCache>(std::move(*options.cache));
     }
 }
 
@@ -24,187 +33,134 @@ std::vector<models::FuelStation> TankerkoenigAPI::findStations(
     double radius,
     const std::string& fuelType
 ) {
-    std::map<std::string, std::string> params = {
-        {"lat", std::to_string(lat)},
-        {"lng", std::to_string(lng)},
-        {"rad", std::to_string(radius)},
-        {"type", fuelType},
-        {"apikey", apiKey}
-    };
+    return findStationsAsync(lat, lng, radius, fuelType).get();
+}
 
-    auto response = makeRequest("list.php", params);
-    
-    if (!response["ok"].get<bool>()) {
-        throw std::runtime_error(response["message"].get<std::string>());
+std::vector<std::vector<models::FuelStation>> TankerkoenigAPI::findStations(
+    const std::vector<SearchArea>& areas,
+    const std::string& fuelType
+) {
+    std::vector<std::future<std::vector<models::FuelStation>>> requests;
+    requests.reserve(areas.size());
+    for (const auto& area : areas) {
+        requests.push_back(findStationsAsync(area.latitude, area.longitude, area.radius, fuelType));
     }
 
-    std::vector<models::FuelStation> stations;
-    for (const auto& item : response["stations"]) {
-        models::FuelStation station;
-        station.id = item["id"].get<std::string>();
-        station.name = item["name"].get<std::string>();
-        station.brand = item["brand"].get<std::string>();
-        
-        station.location.latitude = item["lat"].get<double>();
-        station.location.longitude = item["lng"].get<double>();
-        station.location.street = item["street"].get<std::string>();
-        station.location.houseNumber = item["houseNumber"].get<std::string>();
-        station.location.postalCode = item["postCode"].get<std::string>();
-        station.location.city = item["place"].get<std::string>();
-        
-        station.isOpen = item["isOpen"].get<bool>();
-        station.distance = item["dist"].get<double>();
-
-        // Add prices if available
-        if (!item["e5"].is_null()) {
-            station.prices.push_back({
-                .fuelType = "e5",
-                .price = item["e5"].get<double>(),
-                .lastUpdate = item["lastChange"].get<std::string>()
-            });
-        }
-        if (!item["e10"].is_null()) {
-            station.prices.push_back({
-                .fuelType = "e10",
-                .price = item["e10"].get<double>(),
-                .lastUpdate = item["lastChange"].get<std::string>()
-            });
-        }
-        if (!item["diesel"].is_null()) {
-            station.prices.push_back({
-                .fuelType = "diesel",
-                .price = item["diesel"].get<double>(),
-                .lastUpdate = item["lastChange"].get<std::string>()
-            });
-        }
-
-        stations.push_back(station);
+    std::vector<std::vector<models::FuelStation>> results;
+    results.reserve(areas.size());
+    for (auto& request : requests) {
+        results.push_back(request.get());
     }
-
-    return stations;
+    return results;
 }
 
 std::optional<models::FuelStation> TankerkoenigAPI::getStationDetails(const std::string& stationId) {
-    std::map<std::string, std::string> params = {
-        {"id", stationId},
-        {"apikey", apiKey}
-    };
+    return getStationDetailsAsync(stationId).get();
+}
 
-    auto response = makeRequest("detail.php", params);
-    
-    if (!response["ok"].get<bool>()) {
-        return std::nullopt;
+std::vector<std::optional<models::FuelStation>> TankerkoenigAPI::getStationDetails(
+    const std::vector<std::string>& stationIds
+) {
+    std::vector<std::future<std::optional<models::FuelStation>>> requests;
+    requests.reserve(stationIds.size());
+    for (const auto& stationId : stationIds) {
+        requests.push_back(getStationDetailsAsync(stationId));
     }
 
-    const auto& item = response["station"];
-    models::FuelStation station;
-    station.id = item["id"].get<std::string>();
-    station.name = item["name"].get<std::string>();
-    station.brand = item["brand"].get<std::string>();
-    
-    station.location.latitude = item["lat"].get<double>();
-    station.location.longitude = item["lng"].get<double>();
-    station.location.street = item["street"].get<std::string>();
-    station.location.houseNumber = item["houseNumber"].get<std::string>();
-    station.location.postalCode = item["postCode"].get<std::string>();
-    station.location.city = item["place"].get<std::string>();
-    
-    station.isOpen = item["isOpen"].get<bool>();
-
-    // Add prices if available
-    if (!item["e5"].is_null()) {
-        station.prices.push_back({
-            .fuelType = "e5",
-            .price = item["e5"].get<double>(),
-            .lastUpdate = item["lastChange"].get<std::string>()
-        });
+    std::vector<std::optional<models::FuelStation>> results;
+    results.reserve(stationIds.size());
+    for (auto& request : requests) {
+        results.push_back(request.get());
     }
-    if (!item["e10"].is_null()) {
-        station.prices.push_back({
-            .fuelType = "e10",
-            .price = item["e10"].get<double>(),
-            .lastUpdate = item["lastChange"].get<std::string>()
-        });
-    }
-    if (!item["diesel"].is_null()) {
-        station.prices.push_back({
-            .fuelType = "diesel",
-            .price = item["diesel"].get<double>(),
-            .lastUpdate = item["lastChange"].get<std::string>()
-        });
-    }
-
-    return station;
+    return results;
 }
 
 std::vector<models::FuelStation> TankerkoenigAPI::getPrices(const std::vector<std::string>& stationIds) {
-    if (stationIds.empty()) {
-        return {};
-    }
-
-    std::stringstream ss;
-    for (size_t i = 0; i < stationIds.size(); ++i) {
-        if (i > 0) ss << ",";
-        ss << stationIds[i];
-    }
+    return getPricesAsync(stationIds).get();
+}
 
+std::future<std::vector<models::FuelStation>> TankerkoenigAPI::findStationsAsync(
+    double lat,
+    double lng,
+    double radius,
+    const std::string& fuelType
+) {
     std::map<std::string, std::string> params = {
-        {"ids", ss.str()},
+        {"lat", std::to_string(lat)},
+        {"lng", std::to_string(lng)},
+        {"rad", std::to_string(radius)},
+        {"type", fuelType},
         {"apikey", apiKey}
     };
 
-    auto response = makeRequest("prices.php", params);
-    
-    if (!response["ok"].get<bool>()) {
-        return {};
-    }
-
-    std::vector<models::FuelStation> stations;
-    for (const auto& [id, item] : response["prices"].items()) {
-        if (!item["status"].get<std::string>().empty()) {
-            models::FuelStation station;
-            station.id = id;
-            station.isOpen = item["status"] == "open";
-            
-            if (!item["e5"].is_null()) {
-                station.prices.push_back({
-                    .fuelType = "e5",
-                    .price = item["e5"].get<double>(),
-                    .lastUpdate = item["lastChange"].get<std::string>()
-                });
-            }
-            if (!item["e10"].is_null()) {
-                station.prices.push_back({
-                    .fuelType = "e10",
-                    .price = item["e10"].get<double>(),
-                    .lastUpdate = item["lastChange"].get<std::string>()
-                });
+    return std::async(std::launch::deferred,
+        [response = makeRequest("list.php", StationDecoder::Endpoint::List, params)]() mutable {
+            auto result = response.get();
+            if (!result.ok) {
+                throw std::runtime_error(result.message.empty() ? "list.php request failed" : result.message);
             }
-            if (!item["diesel"].is_null()) {
-                station.prices.push_back({
-                    .fuelType = "diesel",
-                    .price = item["diesel"].get<double>(),
-                    .lastUpdate = item["lastChange"].get<std::string>()
-                });
+            return std::move(result.stations);
+        });
+}
+
+std::future<std::optional<models::FuelStation>> TankerkoenigAPI::getStationDetailsAsync(
+    const std::string& stationId
+) {
+    std::map<std::string, std::string> params = {
+        {"id", stationId},
+        {"apikey", apiKey}
+    };
+
+    return std::async(std::launch::deferred,
+        [response = makeRequest("detail.php", StationDecoder::Endpoint::Detail, params)]() mutable -> std::optional<models::FuelStation> {
+            auto result = response.get();
+            if (!result.ok || result.stations.empty()) {
+                return std::nullopt;
             }
+            return std::move(result.stations.front());
+        });
+}
 
-            stations.push_back(station);
+std::future<std::vector<models::FuelStation>> TankerkoenigAPI::getPricesAsync(
+    const std::vector<std::string>& stationIds
+) {
+    std::vector<std::future<StationDecoder::Result>> chunks;
+    for (size_t begin = 0; begin < stationIds.size(); begin += MAX_PRICE_IDS) {
+        size_t end = std::min(begin + MAX_PRICE_IDS, stationIds.size());
+
+        std::stringstream ss;
+        for (size_t i = begin; i < end; ++i) {
+            if (i > begin) ss << ",";
+            ss << stationIds[i];
         }
-    }
 
-    return stations;
-}
+        std::map<std::string, std::string> params = {
+            {"ids", ss.str()},
+            {"apikey", apiKey}
+        };
+        chunks.push_back(makeRequest("prices.php", StationDecoder::Endpoint::Prices, params));
+    }
 
-size_t TankerkoenigAPI::WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    ((std::string*)userp)->append((char*)contents, size * nmemb);
-    return size * nmemb;
+    return std::async(std::launch::deferred,
+        [chunks = std::move(chunks), count = stationIds.size()]() mutable {
+            std::vector<models::FuelStation> stations;
+            stations.reserve(count);
+            for (auto& chunk : chunks) {
+                auto result = chunk.get();
+                if (result.ok) {
+                    std::move(result.stations.begin(), result.stations.end(), std::back_inserter(stations));
+                }
+            }
+            return stations;
+        });
 }
 
-nlohmann::json TankerkoenigAPI::makeRequest(
+std::future<StationDecoder::Result> TankerkoenigAPI::makeRequest(
     const std::string& endpoint,
+    StationDecoder::Endpoint decoder,
     const std::map<std::string, std::string>& params
 ) {
-    std::string url = BASE_URL + endpoint + "?";
+    std::string url = baseUrl + endpoint + "?";
     bool first = true;
     for (const auto& [key, value] : params) {
         if (!first) url += "&";
@@ -212,18 +168,79 @@ nlohmann::json TankerkoenigAPI::makeRequest(
         first = false;
     }
 
-    std::string response_string;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_string);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, TIMEOUT_SECONDS);
+    HttpRequest request{.url = url, .headers = {}};
+    auto priority = priorityFor(endpoint);
+    if (!cache) {
+        return std::async(std::launch::deferred,
+            [decoder, response = scheduler.submit(std::move(request), priority)]() mutable {
+                return StationDecoder::decode(response.get().body, decoder);
+            });
+    }
 
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        throw std::runtime_error(fmt::format("CURL request failed: {}", curl_easy_strerror(res)));
+    auto key = ResponseCache::makeKey(endpoint, params);
+    auto cached = cache->lookup(key, endpoint);
+    if (cached && cached->fresh) {
+        return std::async(std::launch::deferred,
+            [decoder, body = std::move(cached->entry.body)] {
+                return StationDecoder::decode(body, decoder);
+            });
     }
 
-    return nlohmann::json::parse(response_string);
+    if (cached) {
+        if (!cached->entry.etag.empty()) {
+            request.headers.push_back("If-None-Match: " + cached->entry.etag);
+        }
+        if (!cached->entry.lastModified.empty()) {
+            request.headers.push_back("If-Modified-Since: " + cached->entry.lastModified);
+        }
+    }
+
+    return std::async(std::launch::deferred,
+        [cache = cache.get(), decoder, key = std::move(key), cached = std::move(cached),
+         response = scheduler.submit(std::move(request), priority)]() mutable {
+            HttpResponse result;
+            bool serveStale = false;
+            try {
+                result = response.get();
+                // Still throttled after the scheduler's retries
+                serveStale = result.status == 429 || result.status == 503;
+            } catch (const std::exception&) {
+                if (!cached) throw;
+                serveStale = true;
+            }
+
+            if (serveStale && cached) {
+                return StationDecoder::decode(cached->entry.body, decoder);
+            }
+
+            if (result.status == 304 && cached) {
+                cache->refresh(key);
+                return StationDecoder::decode(cached->entry.body, decoder);
+            }
+
+            auto decoded = StationDecoder::decode(result.body, decoder);
+            // Only successful API responses are worth caching
+            if (result.status == 200 && decoded.ok) {
+                cache->store(key, {
+                    .body = result.body,
+                    .etag = result.headers["etag"],
+                    .lastModified = result.headers["last-modified"],
+                    .storedAt = ResponseCache::Clock::now()
+                });
+            }
+
+            return decoded;
+        });
+}
+
+std::array<RequestScheduler::Metrics, RequestScheduler::PRIORITY_COUNT> TankerkoenigAPI::schedulerMetrics() const {
+    return scheduler.metrics();
+}
+
+Priority TankerkoenigAPI::priorityFor(const std::string& endpoint) {
+    if (endpoint == "prices.php") return Priority::PricePoll;
+    if (endpoint == "list.php") return Priority::Discovery;
+    return Priority::DetailHydration;
 }
 
-} // namespace api 
\ No newline at end of file
+} // namespace api
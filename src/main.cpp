@@ -1,18 +1,54 @@
 #include <iostream>
+#include <algorithm>
 #include <thread>
 #include <chrono>
-#include <map>
+#include <array>
+#include <filesystem>
+#include <unordered_set>
 #include <fmt/format.h>
+#include "analytics/PriceDistributions.hpp"
+#include "analytics/PriceForecaster.hpp"
+#include "analytics/PriceRollups.hpp"
+#include "analytics/StatisticsEngine.hpp"
 #include "api/TankerkoenigAPI.hpp"
+#include "models/CompactStation.hpp"
+#include "monitoring/AnomalyDetector.hpp"
+#include "monitoring/PriceIndex.hpp"
+#include "monitoring/StationRegistry.hpp"
 #include "notifications/TeamsNotificationService.hpp"
+#include "storage/ColumnarHistory.hpp"
+#include "storage/CsvImporter.hpp"
+#include "storage/PriceStore.hpp"
 #include "utils/Config.hpp"
+#include "utils/CoveragePlanner.hpp"
 
 using namespace std::chrono_literals;
 
+storage::PriceStore::Options storeOptions(const utils::Config& config) {
+    storage::PriceStore::Options options;
+    options.directory = config.storage.directory;
+    options.segmentBytes = static_cast<size_t>(std::max(1, config.storage.segmentMegabytes)) * 1024 * 1024;
+    options.compress = config.storage.compress;
+    return options;
+}
+
 class FuelPriceMonitor {
 public:
     explicit FuelPriceMonitor(const utils::Config& config)
-        : config(config), api(config.apiKey) {
+        : config(config), api(config.apiKey, apiOptions(config)), anomalies(anomalyOptions(config)) {
+        if (config.monitoring.pollMode != "list" && config.monitoring.pollMode != "prices") {
+            throw std::runtime_error(fmt::format("Unknown poll mode: {}", config.monitoring.pollMode));
+        }
+
+        for (const auto& name : config.monitoring.fuelTypes) {
+            auto fuelType = models::parseFuelType(name);
+            if (!fuelType) {
+                throw std::runtime_error(fmt::format("Unknown fuel type: {}", name));
+            }
+            monitoredFuelTypes[models::index(*fuelType)] = true;
+        }
+        priceThreshold = models::toTenthCents(config.monitoring.priceThreshold);
+
         // Initialize notification services
         for (const auto& notifConfig : config.notifications) {
             if (notifConfig.type == "teams") {
@@ -23,8 +59,53 @@ public:
             }
         }
 
-        // Initialize price history
-        updatePrices();
+        coverageTiles = planCoverage(config.coverage);
+        if (!coverageTiles.empty()) {
+            std::cout << fmt::format("Coverage area split into {} radius queries", coverageTiles.size()) << std::endl;
+        }
+
+        // Restore the last known prices, so the first cycle already alerts
+        // on changes that happened while the monitor was down
+        if (config.storage.enabled) {
+            store = std::make_unique<storage::PriceStore>(storeOptions(config));
+            store->forEachLatest([this](const storage::PriceRecord& record) {
+                priceIndex.update(record.station, record.fuelType, record.price);
+            });
+            std::cout << fmt::format("Restored {} prices from {}", priceIndex.size(), config.storage.directory) << std::endl;
+
+            auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            // Warm the statistics with the recent history. The history is
+            // freed at the end of the block, before the rollups load a longer one.
+            {
+                auto window = std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::days(std::max(0, config.monitoring.statisticsWindowDays))).count();
+                auto history = storage::ColumnarHistory::load(*store, now - window, now + 1);
+                std::vector<models::FuelType> fuelTypes;
+                for (auto fuelType : models::ALL_FUEL_TYPES) {
+                    if (monitoredFuelTypes[models::index(fuelType)]) {
+                        fuelTypes.push_back(fuelType);
+                    }
+                }
+                auto backfilled = statistics.backfill(history, fuelTypes, {}, [](const auto& progress) {
+                    std::cout << fmt::format("Backfilling statistics: {}/{} stations, {:.1f}M records/s",
+                                             progress.stations, progress.totalStations,
+                                             progress.recordsPerSecond() / 1e6) << std::endl;
+                });
+                std::cout << fmt::format("Statistics backfilled from {} records in {:.1f} s",
+                                         backfilled.records, backfilled.elapsed.count()) << std::endl;
+
+                for (auto fuelType : fuelTypes) {
+                    distributions.backfill(history, fuelType, now);
+                    forecaster.train(history, fuelType);
+                    anomalies.train(history, fuelType, now);
+                }
+            }
+
+            // Daily rollups are kept for a bit over a year
+            rollups.recompute(*store, now - 400 * 86400, now + 1);
+        }
+        lastStatisticsReport = std::chrono::steady_clock::now();
     }
 
     void run() {
@@ -32,8 +113,12 @@ public:
         
         while (true) {
             try {
-                updatePrices();
-                checkPriceChanges();
+                pollPrices();
+                reportThrottling();
+                if (store) {
+                    store->checkpoint();
+                }
+                sendStatisticsReports();
                 
                 // Sleep for the configured interval
                 std::this_thread::sleep_for(std::chrono::minutes(config.monitoring.updateInterval));
@@ -46,65 +131,315 @@ public:
     }
 
 private:
-    void updatePrices() {
-        for (const auto& fuelType : config.monitoring.fuelTypes) {
-            auto stations = api.findStations(
-                config.location.latitude,
-                config.location.longitude,
-                config.location.searchRadius,
-                fuelType
-            );
+    // In "prices" mode the station set is discovered through list.php only
+    // every discoveryInterval minutes and kept in the registry; the cycles in
+    // between poll just the prices of the known stations through prices.php.
+    void pollPrices() {
+        bool incremental = config.monitoring.pollMode == "prices";
+        auto now = monitoring::StationRegistry::Clock::now();
+        
+        if (incremental && !registry.needsDiscovery(now, std::chrono::minutes(config.monitoring.discoveryInterval))) {
+            for (const auto& update : api.getPrices(registry.stationIds())) {
+                if (const auto* station = registry.applyPrices(update)) {
+                    processStation(*station, std::nullopt);
+                }
+            }
+            return;
+        }
 
-            for (const auto& station : stations) {
-                for (const auto& price : station.prices) {
-                    if (price.fuelType == fuelType) {
-                        auto key = std::make_pair(station.id, fuelType);
-                        priceHistory[key] = price.price;
-                    }
+        // A single type=all list.php request per region returns every fuel
+        // type, so one cycle costs one round-trip regardless of how many fuel
+        // types are monitored. All regions are requested concurrently.
+        std::vector<models::FuelStation> stations;
+        std::vector<analytics::PriceDistributions::Region> regions;  // by station, the search area it was found in
+        std::unordered_set<std::string> seen;
+        auto results = api.findStations(searchAreas(), "all");
+        for (size_t area = 0; area < results.size(); ++area) {
+            for (auto& station : results[area]) {
+                // Overlapping regions report the same station more than once
+                if (seen.insert(station.id).second) {
+                    stations.push_back(std::move(station));
+                    regions.push_back(static_cast<analytics::PriceDistributions::Region>(area));
                 }
             }
         }
+
+        if (incremental) {
+            registry.update(stations, now);
+        }
+
+        for (size_t i = 0; i < stations.size(); ++i) {
+            processStation(stations[i], regions[i]);
+        }
     }
 
-    void checkPriceChanges() {
-        for (const auto& fuelType : config.monitoring.fuelTypes) {
-            auto stations = api.findStations(
-                config.location.latitude,
-                config.location.longitude,
-                config.location.searchRadius,
-                fuelType
-            );
+    // Diff the station's prices against the price index and record every
+    // change in the store. Prices are compared as integer tenth-cents, so a
+    // change of exactly the threshold triggers. Stations polled through
+    // prices.php keep the region of their last discovery.
+    void processStation(const models::FuelStation& station,
+                        std::optional<analytics::PriceDistributions::Region> region) {
+        auto handle = store ? store->intern(station.id) : stationHandles.intern(station.id);
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        if (handle >= stationNames.size()) {
+            stationNames.resize(handle + 1);
+            stationRegions.resize(handle + 1, 0);
+        }
+        stationNames[handle] = station.name;
+        forecaster.setBrand(handle, station.brand);
+        if (region) {
+            stationRegions[handle] = *region;
+        }
 
-            for (const auto& station : stations) {
-                for (const auto& price : station.prices) {
-                    if (price.fuelType != fuelType) continue;
-
-                    auto key = std::make_pair(station.id, fuelType);
-                    auto it = priceHistory.find(key);
-                    
-                    if (it != priceHistory.end()) {
-                        double priceChange = price.price - it->second;
-                        
-                        // Check if price change exceeds threshold
-                        if (std::abs(priceChange) >= config.monitoring.priceThreshold) {
-                            if (priceChange < 0 || config.monitoring.notifyOnIncrease) {
-                                sendPriceAlert(station, price, it->second, priceChange);
-                            }
-                        }
-                        
-                        // Update price history
-                        it->second = price.price;
+        for (const auto& price : station.prices) {
+            auto fuelType = models::parseFuelType(price.fuelType);
+            if (!fuelType) continue;
+
+            auto current = models::toTenthCents(price.price);
+            std::optional<double> deviation;
+            bool alerted = false;
+            if (monitoredFuelTypes[models::index(*fuelType)]) {
+                statistics.observe(handle, *fuelType, now, current);
+                distributions.observe(stationRegions[handle], *fuelType, now, current,
+                                      std::chrono::minutes(std::max(1, config.monitoring.updateInterval)));
+
+                // Judged against the station's usual price for the hour before
+                // the price joins it
+                deviation = anomalies.deviation(handle, *fuelType, now, current);
+                if (auto anomaly = anomalies.observe(handle, *fuelType, now, current)) {
+                    sendAnomalyAlert(station, price, *anomaly);
+                    if (anomaly->type != monitoring::AnomalyDetector::AnomalyType::StalePrice) {
+                        alerted = true;
                     }
                 }
             }
+
+            auto previous = priceIndex.update(handle, *fuelType, current);
+            if (previous == current) continue;
+
+            auto timestamp = models::parseTimestamp(price.lastUpdate).value_or(now);
+            storage::PriceRecord record{handle, *fuelType, timestamp, current};
+            if (store) {
+                store->append(record);
+                rollups.add(record);
+            }
+            if (!monitoredFuelTypes[models::index(*fuelType)]) continue;
+            forecaster.update(record);
+            if (!previous) continue;
+
+            auto priceChange = current - *previous;
+
+            // Check if price change exceeds threshold. Changes within the
+            // station's usual band for the hour are normal daily swings, and
+            // anomalies have been reported already.
+            bool usual = config.monitoring.seasonalBand > 0 && deviation &&
+                         std::abs(*deviation) < config.monitoring.seasonalBand;
+            if (std::abs(priceChange) >= priceThreshold && !usual && !alerted) {
+                if (priceChange < 0 || config.monitoring.notifyOnIncrease) {
+                    sendPriceAlert(station, handle, price, *fuelType, *previous, priceChange);
+                }
+            }
         }
     }
 
+    // Every statisticsInterval minutes, one report per monitored fuel type
+    void sendStatisticsReports() {
+        if (config.monitoring.statisticsInterval <= 0) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastStatisticsReport < std::chrono::minutes(config.monitoring.statisticsInterval)) return;
+        lastStatisticsReport = now;
+
+        auto labeler = [this](models::StationHandle handle) {
+            auto id = store ? store->stationId(handle) : std::string(stationHandles.id(handle));
+            auto name = handle < stationNames.size() && !stationNames[handle].empty() ? stationNames[handle] : id;
+            return analytics::StatisticsEngine::StationLabel{std::move(id), std::move(name)};
+        };
+
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            if (!monitoredFuelTypes[models::index(fuelType)]) continue;
+
+            notifications::StatisticsReportMessage message;
+            message.statistics = statistics.statistics(fuelType, labeler);
+            if (message.statistics.stationStats.empty()) continue;
+
+            const auto& cheapest = message.statistics.stationStats.front();
+            message.title = fmt::format("📊 {} Price Statistics", models::toString(fuelType));
+            message.body = fmt::format(
+                "Area average {:.3f}€ across {} stations. Cheapest on average: {} ({:.3f}€), usually cheapest on {}",
+                message.statistics.areaAveragePrice,
+                message.statistics.stationStats.size(),
+                cheapest.stationName,
+                cheapest.averagePrice,
+                cheapest.weeklyStats.cheapestDay
+            );
+            message.body += weekOverWeek(fuelType);
+            message.body += weeklyPercentiles(fuelType);
+            message.body += bestTimeToRefuel(fuelType);
+            message.timestamp = message.statistics.lastUpdate;
+            message.reportPeriod = "Weekly";
+
+            for (const auto& service : notificationServices) {
+                service->sendStatisticsReport(message);
+            }
+        }
+    }
+
+    // Area average of the last seven days against the week before, from the
+    // hourly rollups
+    std::string weekOverWeek(models::FuelType fuelType) const {
+        constexpr models::EpochSeconds WEEK = 7 * 86400;
+        auto now = std::chrono::duration_cast<std::chrono::hours>(
+            std::chrono::system_clock::now().time_since_epoch());
+        auto to = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+
+        auto result = rollups.query({.fuelType = fuelType, .from = to - 2 * WEEK, .to = to, .step = WEEK, .stations = {}});
+        if (result.points.size() != 2 || result.points[0].value.seconds == 0 || result.points[1].value.seconds == 0) {
+            return {};
+        }
+
+        auto current = result.points[1].value.average();
+        auto previous = result.points[0].value.average();
+        return fmt::format(". 7-day area average {:.3f}€ ({:+.3f}€ on the week before)",
+                           current / 1000.0, (current - previous) / 1000.0);
+    }
+
+    // Cheapest tenth and median of the prices seen over the last seven days
+    std::string weeklyPercentiles(models::FuelType fuelType) const {
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto week = distributions.distribution({.fuelType = fuelType, .from = now - 7 * 86400, .to = now + 1, .regions = {}});
+        auto cheapest = week.quantile(0.1);
+        auto median = week.quantile(0.5);
+        if (!cheapest || !median) return {};
+
+        return fmt::format(". Over the last 7 days 10% of the prices were below {:.3f}€ (median {:.3f}€)",
+                           *cheapest / 1000.0, *median / 1000.0);
+    }
+
+    // The hour of the next day with the lowest average forecast over the
+    // stations, and the cheapest single station forecast
+    std::string bestTimeToRefuel(models::FuelType fuelType) const {
+        constexpr size_t HOURS = 24;
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        // Stations polled since startup; the history may hold stations that
+        // are no longer in the area
+        std::vector<models::StationHandle> stations;
+        for (models::StationHandle handle = 0; handle < stationNames.size(); ++handle) {
+            if (!stationNames[handle].empty()) stations.push_back(handle);
+        }
+        auto forecasts = forecaster.forecast(stations, fuelType, now, HOURS);
+
+        std::vector<double> area(HOURS, 0.0);
+        const analytics::PriceForecaster::Forecast* cheapest = nullptr;
+        models::StationHandle cheapestStation = 0;
+        for (size_t i = 0; i < forecasts.size(); ++i) {
+            if (!forecasts[i]) continue;
+            for (size_t hour = 0; hour < HOURS; ++hour) {
+                area[hour] += forecasts[i]->prices[hour];
+            }
+            if (!cheapest || forecasts[i]->cheapestPrice() < cheapest->cheapestPrice()) {
+                cheapest = &*forecasts[i];
+                cheapestStation = stations[i];
+            }
+        }
+        if (!cheapest) return {};
+
+        auto best = std::min_element(area.begin(), area.end()) - area.begin();
+        return fmt::format(". Best time to refuel in the next 24 hours: {}, cheapest expected at {} ({:.3f}€ around {})",
+                           formatLocalHour(cheapest->start + best * 3600), stationNames[cheapestStation],
+                           cheapest->cheapestPrice() / 1000.0, formatLocalHour(cheapest->cheapestTime()));
+    }
+
+    // e.g. "Tue 18:00", German local time
+    static std::string formatLocalHour(models::EpochSeconds utc) {
+        auto hour = analytics::hourOfWeek(utc);
+        return fmt::format("{} {:02}:00", analytics::DAY_NAMES[hour / analytics::HOURS_PER_DAY],
+                           hour % analytics::HOURS_PER_DAY);
+    }
+
+    void reportThrottling() {
+        uint64_t throttled = 0;
+        for (const auto& metrics : api.schedulerMetrics()) {
+            throttled += metrics.throttled;
+        }
+
+        if (throttled > lastThrottled) {
+            std::cerr << fmt::format("API rate limit hit {} times during the last cycle", 
+                                     throttled - lastThrottled) << std::endl;
+        }
+        lastThrottled = throttled;
+    }
+
+    std::vector<api::SearchArea> searchAreas() const {
+        std::vector<api::SearchArea> areas;
+        areas.push_back({config.location.latitude, config.location.longitude, config.location.searchRadius});
+        for (const auto& region : config.regions) {
+            areas.push_back({region.latitude, region.longitude, region.searchRadius});
+        }
+        for (const auto& tile : coverageTiles) {
+            areas.push_back({tile.latitude, tile.longitude, tile.radius});
+        }
+        return areas;
+    }
+
+    static std::vector<utils::CoverageTile> planCoverage(const utils::CoverageConfig& coverage) {
+        const auto& area = coverage.area;
+        if (area.empty()) {
+            return {};
+        }
+        if (area.size() == 2) {
+            return utils::CoveragePlanner::planBoundingBox({
+                area[0].latitude, area[0].longitude,
+                area[1].latitude, area[1].longitude
+            }, coverage.tileRadius);
+        }
+
+        std::vector<utils::Waypoint> polygon;
+        for (const auto& point : area) {
+            polygon.push_back({point.latitude, point.longitude});
+        }
+        return utils::CoveragePlanner::planPolygon(polygon, coverage.tileRadius);
+    }
+
+    static monitoring::AnomalyDetector::Options anomalyOptions(const utils::Config& config) {
+        monitoring::AnomalyDetector::Options options;
+        options.threshold = std::max(0.0, config.monitoring.anomalyThreshold);
+        options.staleAfter = std::chrono::hours(std::max(0, config.monitoring.staleHours));
+        return options;
+    }
+
+    static api::TankerkoenigAPI::Options apiOptions(const utils::Config& config) {
+        api::TankerkoenigAPI::Options options;
+        options.baseUrl = config.api.baseUrl;
+        options.engine.maxConcurrentRequests = static_cast<size_t>(std::max(1, config.api.maxConcurrentRequests));
+        options.scheduler.requestsPerMinute = config.api.rateLimit.requestsPerMinute;
+        options.scheduler.burst = std::max(1.0, config.api.rateLimit.burst);
+        options.scheduler.maxRetries = config.api.rateLimit.maxRetries;
+
+        const auto& cacheConfig = config.api.cache;
+        if (cacheConfig.enabled) {
+            api::ResponseCache::Options cache;
+            cache.directory = cacheConfig.directory;
+            cache.memoryBytes = static_cast<size_t>(std::max(0, cacheConfig.memoryMegabytes)) * 1024 * 1024;
+            for (const auto& [endpoint, ttl] : cacheConfig.ttlSeconds) {
+                cache.ttls[endpoint] = std::chrono::seconds(ttl);
+            }
+            options.cache = std::move(cache);
+        }
+        return options;
+    }
+
     void sendPriceAlert(
         const models::FuelStation& station,
+        models::StationHandle handle,
         const models::FuelPrice& price,
-        double previousPrice,
-        double priceChange
+        models::FuelType fuelType,
+        models::TenthCents previousPrice,
+        models::TenthCents priceChange
     ) {
         notifications::PriceAlertMessage message;
         message.title = priceChange < 0 ? "⬇️ Price Drop Alert!" : "⬆️ Price Increase Alert";
@@ -113,20 +448,34 @@ private:
             price.fuelType,
             station.name,
             priceChange < 0 ? "decreased" : "increased",
-            std::abs(priceChange)
+            models::toEuros(std::abs(priceChange))
         );
         message.timestamp = price.lastUpdate;
         message.station = station;
-        message.previousPrice = previousPrice;
+        message.previousPrice = models::toEuros(previousPrice);
         message.currentPrice = price.price;
-        message.priceChange = priceChange;
+        message.priceChange = models::toEuros(priceChange);
         
-        // Find if this is the best price in the area
-        message.isBestPrice = true;
-        for (const auto& [key, otherPrice] : priceHistory) {
-            if (key.second == price.fuelType && otherPrice < price.price) {
-                message.isBestPrice = false;
-                break;
+        // Whether no known station in the area is cheaper
+        message.isBestPrice = priceIndex.rank(handle, fuelType) == 1;
+
+        // Against the prices seen across the area during the last hour
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto rank = distributions.rank({.fuelType = fuelType, .from = now - 3600, .to = now + 1, .regions = {}},
+                                       models::toTenthCents(price.price));
+        if (rank && *rank <= 0.1) {
+            message.body += ", in the cheapest 10% of the area right now";
+        }
+
+        auto current = models::toTenthCents(price.price);
+        if (auto forecast = forecaster.forecast(handle, fuelType, now, 24)) {
+            // Only drops of at least a cent are worth waiting for
+            if (forecast->cheapestPrice() <= current - 10) {
+                message.body += fmt::format(". Expected to fall to about {:.3f}€ around {}",
+                                            forecast->cheapestPrice() / 1000.0, formatLocalHour(forecast->cheapestTime()));
+            } else {
+                message.body += ". No lower price expected in the next 24 hours";
             }
         }
 
@@ -135,16 +484,99 @@ private:
         }
     }
 
+    void sendAnomalyAlert(
+        const models::FuelStation& station,
+        const models::FuelPrice& price,
+        const monitoring::AnomalyDetector::Anomaly& anomaly
+    ) {
+        using AnomalyType = monitoring::AnomalyDetector::AnomalyType;
+
+        notifications::AnomalyAlertMessage message;
+        message.anomalyType = std::string(monitoring::toString(anomaly.type));
+        message.fuelType = price.fuelType;
+        message.station = station;
+        message.currentPrice = models::toEuros(anomaly.price);
+        message.expectedPrice = anomaly.expected / 1000.0;
+        message.deviation = anomaly.deviation;
+        message.unchangedSince = models::formatTimestamp(anomaly.unchangedSince);
+        message.timestamp = price.lastUpdate;
+
+        auto hours = (anomaly.timestamp - anomaly.unchangedSince) / 3600;
+        switch (anomaly.type) {
+            case AnomalyType::Spike:
+            case AnomalyType::Drop:
+                message.title = anomaly.type == AnomalyType::Spike ? "⚠️ Unusual Price Spike" : "⚠️ Unusual Price Drop";
+                message.body = fmt::format(
+                    "{} at {} is {:.3f}€, usually about {:.3f}€ at this time of the week ({:+.1f} standard deviations)",
+                    price.fuelType, station.name, message.currentPrice, message.expectedPrice, anomaly.deviation);
+                break;
+            case AnomalyType::StalePrice:
+                message.title = "⏸️ Stale Price";
+                message.body = fmt::format(
+                    "{} at {} has been {:.3f}€ for {} hours, the station's feed may be stale",
+                    price.fuelType, station.name, message.currentPrice, hours);
+                break;
+        }
+
+        for (const auto& service : notificationServices) {
+            service->sendAnomalyAlert(message);
+        }
+    }
+
     utils::Config config;
     api::TankerkoenigAPI api;
+    monitoring::AnomalyDetector anomalies;
+    monitoring::StationRegistry registry;
+    std::vector<utils::CoverageTile> coverageTiles;
+    uint64_t lastThrottled = 0;
     std::vector<std::unique_ptr<notifications::NotificationService>> notificationServices;
-    std::map<std::pair<std::string, std::string>, double> priceHistory;  // (stationId, fuelType) -> price
+    std::array<bool, models::FUEL_TYPE_COUNT> monitoredFuelTypes{};
+    models::TenthCents priceThreshold = 0;
+    models::StationInterner stationHandles;  // used when there is no store
+    std::unique_ptr<storage::PriceStore> store;
+    monitoring::PriceIndex priceIndex;
+    analytics::StatisticsEngine statistics;
+    analytics::PriceRollups rollups;
+    analytics::PriceDistributions distributions;
+    analytics::PriceForecaster forecaster;
+    std::vector<std::string> stationNames;  // by handle, for reports
+    std::vector<analytics::PriceDistributions::Region> stationRegions;  // by handle, index into searchAreas()
+    std::chrono::steady_clock::time_point lastStatisticsReport;
 };
 
+// Load Tankerkoenig price dumps (prices/YYYY/MM/*-prices.csv) into the store
+void importHistory(const utils::Config& config, const std::vector<std::filesystem::path>& files) {
+    storage::PriceStore store(storeOptions(config));
+
+    auto stats = storage::CsvImporter::importPrices(files, [&](std::span<const storage::PriceChangeRecord> changes) {
+        std::vector<storage::PriceRecord> records;
+        records.reserve(changes.size());
+        for (const auto& change : changes) {
+            records.push_back({store.intern(change.stationId), change.fuelType, change.timestamp, change.price});
+        }
+        store.append(records);
+    }, {});
+    store.checkpoint();
+
+    std::cout << fmt::format("Imported {} price changes from {} rows ({} malformed, {:.1f} MiB)",
+                             stats.records, stats.rows, stats.malformedRows,
+                             static_cast<double>(stats.bytes) / (1024 * 1024)) << std::endl;
+}
+
 int main(int argc, char* argv[]) {
     try {
         utils::Config config;
         
+        // fuel-price-assistant import <config.json> <prices.csv>...
+        if (argc > 1 && std::string(argv[1]) == "import") {
+            if (argc < 4) {
+                throw std::runtime_error("Usage: import <config.json> <prices.csv>...");
+            }
+            config = utils::Config::load(argv[2]);
+            importHistory(config, std::vector<std::filesystem::path>(argv + 3, argv + argc));
+            return 0;
+        }
+
         if (argc > 1) {
             config = utils::Config::load(argv[1]);
         } else {
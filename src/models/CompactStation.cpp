@@ -0,0 +1,144 @@
+#include "models/CompactStation.hpp"
+#include <charconv>
+#include <fmt/format.h>
+
+namespace models {
+
+namespace {
+
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+// Howard Hinnant's days_from_civil and civil_from_days
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+}
+
+} // namespace
+
+std::optional<EpochSeconds> parseTimestamp(std::string_view text) {
+    // YYYY-MM-DD HH:MM:SS followed by an optional Z, +HH or +HH:MM
+    if (text.size() < 19 || text[4] != '-' || text[7] != '-' || (text[10] != ' ' && text[10] != 'T') ||
+        text[13] != ':' || text[16] != ':') {
+        return std::nullopt;
+    }
+
+    int year, month, day, hour, minute, second;
+    if (!parseNumber(text.substr(0, 4), year) || !parseNumber(text.substr(5, 2), month) ||
+        !parseNumber(text.substr(8, 2), day) || !parseNumber(text.substr(11, 2), hour) ||
+        !parseNumber(text.substr(14, 2), minute) || !parseNumber(text.substr(17, 2), second)) {
+        return std::nullopt;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return std::nullopt;
+    }
+
+    int64_t offsetSeconds = 0;
+    auto offset = text.substr(19);
+    if (offset == "Z") {
+        offset = {};
+    }
+    if (!offset.empty()) {
+        if (offset.size() < 3 || (offset[0] != '+' && offset[0] != '-')) return std::nullopt;
+
+        int offsetHours = 0, offsetMinutes = 0;
+        if (!parseNumber(offset.substr(1, 2), offsetHours)) return std::nullopt;
+        if (offset.size() >= 6 && offset[3] == ':' && !parseNumber(offset.substr(4, 2), offsetMinutes)) {
+            return std::nullopt;
+        }
+        offsetSeconds = (offsetHours * 3600 + offsetMinutes * 60) * (offset[0] == '-' ? -1 : 1);
+    }
+
+    int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return days * 86400 + hour * 3600 + minute * 60 + second - offsetSeconds;
+}
+
+std::string formatTimestamp(EpochSeconds timestamp) {
+    int64_t days = timestamp >= 0 ? timestamp / 86400 : (timestamp - 86399) / 86400;
+    int64_t seconds = timestamp - days * 86400;
+
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    return fmt::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}Z",
+                       year, month, day, seconds / 3600, seconds / 60 % 60, seconds % 60);
+}
+
+StationHandle StationInterner::intern(std::string_view id) {
+    if (auto it = handles.find(id); it != handles.end()) {
+        return it->second;
+    }
+
+    auto handle = static_cast<StationHandle>(ids.size());
+    const auto& stored = ids.emplace_back(id);
+    handles.emplace(stored, handle);
+    return handle;
+}
+
+std::optional<StationHandle> StationInterner::find(std::string_view id) const {
+    auto it = handles.find(id);
+    if (it == handles.end()) return std::nullopt;
+    return it->second;
+}
+
+CompactStation compact(const FuelStation& station, StationInterner& interner) {
+    CompactStation result;
+    result.handle = interner.intern(station.id);
+    result.latitude = static_cast<float>(station.location.latitude);
+    result.longitude = static_cast<float>(station.location.longitude);
+    result.isOpen = station.isOpen;
+
+    for (const auto& price : station.prices) {
+        auto fuelType = parseFuelType(price.fuelType);
+        if (!fuelType) continue;
+
+        result.prices[index(*fuelType)] = toTenthCents(price.price);
+        if (auto updated = parseTimestamp(price.lastUpdate)) {
+            result.lastUpdate = std::max(result.lastUpdate, *updated);
+        }
+    }
+    return result;
+}
+
+FuelStation expand(const CompactStation& station, const StationInterner& interner) {
+    FuelStation result;
+    result.id = interner.id(station.handle);
+    result.location.latitude = station.latitude;
+    result.location.longitude = station.longitude;
+    result.isOpen = station.isOpen;
+    result.distance = 0.0;
+
+    auto lastUpdate = station.lastUpdate != 0 ? formatTimestamp(station.lastUpdate) : std::string();
+    for (auto fuelType : ALL_FUEL_TYPES) {
+        if (auto price = station.price(fuelType)) {
+            result.prices.push_back({
+                .fuelType = std::string(toString(fuelType)),
+                .price = toEuros(*price),
+                .lastUpdate = lastUpdate
+            });
+        }
+    }
+    return result;
+}
+
+} // namespace models
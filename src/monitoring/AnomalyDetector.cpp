@@ -0,0 +1,174 @@
+#include "monitoring/AnomalyDetector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace monitoring {
+
+std::string_view toString(AnomalyDetector::AnomalyType type) {
+    switch (type) {
+        case AnomalyDetector::AnomalyType::Spike: return "spike";
+        case AnomalyDetector::AnomalyType::Drop: return "drop";
+        case AnomalyDetector::AnomalyType::StalePrice: return "stale";
+    }
+    return "unknown";
+}
+
+AnomalyDetector::AnomalyDetector() : AnomalyDetector(Options{}) {}
+
+AnomalyDetector::AnomalyDetector(Options options) : options(options) {
+    if (options.alpha <= 0 || options.alpha > 1) {
+        throw std::invalid_argument(fmt::format("Invalid anomaly smoothing: {}", options.alpha));
+    }
+    if (options.threshold < 0) {
+        throw std::invalid_argument(fmt::format("Invalid anomaly threshold: {}", options.threshold));
+    }
+}
+
+double AnomalyDetector::stdDev(const Series& state, size_t hour) const {
+    return std::max(options.minStdDev, std::sqrt(static_cast<double>(state.variance[hour])));
+}
+
+std::optional<double> AnomalyDetector::score(const Series& state, size_t hour, models::TenthCents price) const {
+    if (state.samples[hour] < options.minSamples) return std::nullopt;
+    return (price - state.mean[hour]) / stdDev(state, hour);
+}
+
+AnomalyDetector::Series& AnomalyDetector::seriesFor(models::StationHandle station, models::FuelType fuelType) {
+    auto index = slot(station, fuelType);
+    if (index >= series.size()) {
+        series.resize(index + 1);
+    }
+    if (!series[index]) {
+        series[index] = std::make_unique<Series>();
+    }
+    return *series[index];
+}
+
+std::optional<AnomalyDetector::Anomaly> AnomalyDetector::judge(
+    Series& state,
+    size_t hour,
+    models::StationHandle station,
+    models::FuelType fuelType,
+    models::EpochSeconds timestamp,
+    models::TenthCents price
+) const {
+    std::optional<Anomaly> result;
+    if (state.lastPrice == models::NO_PRICE) {
+        // First sighting, nothing to compare with
+    } else if (price != state.lastPrice) {
+        auto z = score(state, hour, price);
+        if (options.threshold > 0 && z && std::abs(*z) >= options.threshold &&
+            std::abs(price - state.mean[hour]) >= options.minDeviation) {
+            result = Anomaly{*z > 0 ? AnomalyType::Spike : AnomalyType::Drop, station, fuelType, timestamp,
+                             price, state.mean[hour], *z, state.lastChange};
+        }
+    } else if (options.staleAfter.count() > 0 && !state.staleReported &&
+               timestamp - state.lastChange >= options.staleAfter.count()) {
+        result = Anomaly{AnomalyType::StalePrice, station, fuelType, timestamp,
+                         price, static_cast<double>(price), 0.0, state.lastChange};
+        state.staleReported = true;
+    }
+
+    if (price != state.lastPrice) {
+        state.lastChange = timestamp;
+        state.staleReported = false;
+    }
+    state.lastTimestamp = timestamp;
+    state.lastPrice = price;
+    return result;
+}
+
+void AnomalyDetector::learn(Series& state, models::EpochSeconds timestamp, models::TenthCents price) const {
+    auto hourEnd = analytics::nextHour(timestamp);
+    if (hourEnd <= state.learnedUntil) return;
+    state.learnedUntil = hourEnd;
+    auto hour = analytics::hourOfWeek(timestamp);
+
+    // Anomalous prices enter the bucket clipped to the threshold, so a
+    // single outlier cannot widen the band it is judged against
+    double value = price;
+    auto& samples = state.samples[hour];
+    if (samples >= options.minSamples && options.threshold > 0) {
+        auto limit = options.threshold * stdDev(state, hour);
+        value = std::clamp(value, state.mean[hour] - limit, state.mean[hour] + limit);
+    }
+
+    if (samples == 0) {
+        state.mean[hour] = static_cast<float>(value);
+        state.variance[hour] = 0.0f;
+    } else {
+        // Welford-style exponentially weighted update; the first 1 / alpha
+        // samples are averaged evenly
+        auto alpha = std::max(options.alpha, 1.0 / (samples + 1.0));
+        auto difference = value - state.mean[hour];
+        auto increment = alpha * difference;
+        state.mean[hour] = static_cast<float>(state.mean[hour] + increment);
+        state.variance[hour] = static_cast<float>((1 - alpha) * (state.variance[hour] + difference * increment));
+    }
+    if (samples < UINT8_MAX) {
+        ++samples;
+    }
+}
+
+std::optional<AnomalyDetector::Anomaly> AnomalyDetector::observe(
+    models::StationHandle station,
+    models::FuelType fuelType,
+    models::EpochSeconds timestamp,
+    models::TenthCents price
+) {
+    auto& state = seriesFor(station, fuelType);
+    auto hour = analytics::hourOfWeek(timestamp);
+
+    std::optional<Anomaly> result;
+    if (state.lastPrice == models::NO_PRICE || timestamp >= state.lastTimestamp) {
+        result = judge(state, hour, station, fuelType, timestamp, price);
+    }
+    learn(state, timestamp, price);
+    return result;
+}
+
+void AnomalyDetector::train(
+    const storage::ColumnarHistory& history,
+    models::FuelType fuelType,
+    models::EpochSeconds until
+) {
+    auto span = options.staleAfter.count() > 0 ? options.staleAfter.count() : 86400;
+    for (models::StationHandle station = 0; station < history.stationCount(); ++station) {
+        auto column = history.column(station, fuelType);
+        if (column.size() == 0) continue;
+
+        auto& state = seriesFor(station, fuelType);
+        for (size_t i = 0; i < column.size(); ++i) {
+            auto from = column.timestamps[i];
+            if (state.lastPrice != models::NO_PRICE && from < state.lastTimestamp) continue;
+
+            auto price = column.prices[i];
+            auto to = std::min(i + 1 < column.size() ? column.timestamps[i + 1] : until, from + span);
+            if (price != state.lastPrice) {
+                state.lastChange = from;
+                state.staleReported = false;
+            }
+            state.lastPrice = price;
+            state.lastTimestamp = from;
+
+            for (auto time = from; time < to; time = analytics::nextHour(time)) {
+                learn(state, time, price);
+            }
+        }
+    }
+}
+
+std::optional<double> AnomalyDetector::deviation(
+    models::StationHandle station,
+    models::FuelType fuelType,
+    models::EpochSeconds timestamp,
+    models::TenthCents price
+) const {
+    auto index = slot(station, fuelType);
+    if (index >= series.size() || !series[index]) return std::nullopt;
+    return score(*series[index], analytics::hourOfWeek(timestamp), price);
+}
+
+} // namespace monitoring
@@ -0,0 +1,145 @@
+#include "monitoring/PriceIndex.hpp"
+#include <algorithm>
+
+namespace monitoring {
+
+namespace {
+
+constexpr size_t INITIAL_CAPACITY = 1024;
+
+} // namespace
+
+PriceIndex::PriceIndex()
+    : slots(INITIAL_CAPACITY, Slot{EMPTY, models::NO_PRICE}), shift(64 - 10) {
+    for (auto& counts : priceCounts) {
+        counts.assign(MAX_RANKED_PRICE + 2, 0);
+    }
+}
+
+std::optional<models::TenthCents> PriceIndex::update(
+    models::StationHandle station,
+    models::FuelType fuelType,
+    models::TenthCents price
+) {
+    if ((count + 1) > slots.size() * MAX_LOAD) {
+        grow();
+    }
+
+    auto key = makeKey(station, fuelType);
+    auto& slot = slots[slotFor(key)];
+    auto& prices = ordered[models::index(fuelType)];
+
+    std::optional<models::TenthCents> previous;
+    if (slot.key == key) {
+        previous = slot.price;
+        if (slot.price == price) return previous;
+
+        prices.erase({slot.price, station});
+        addRanked(fuelType, slot.price, -1);
+    } else {
+        slot.key = key;
+        ++count;
+    }
+
+    slot.price = price;
+    prices.insert({price, station});
+    addRanked(fuelType, price, 1);
+    return previous;
+}
+
+bool PriceIndex::erase(models::StationHandle station, models::FuelType fuelType) {
+    auto key = makeKey(station, fuelType);
+    auto index = slotFor(key);
+    if (slots[index].key != key) return false;
+
+    ordered[models::index(fuelType)].erase({slots[index].price, station});
+    addRanked(fuelType, slots[index].price, -1);
+    --count;
+
+    // Backward-shift deletion keeps probe sequences intact without tombstones
+    auto mask = slots.size() - 1;
+    auto hole = index;
+    for (auto next = (hole + 1) & mask; slots[next].key != EMPTY; next = (next + 1) & mask) {
+        auto home = static_cast<size_t>((slots[next].key * 0x9E3779B97F4A7C15ull) >> shift);
+        // Move the entry into the hole unless its home lies cyclically in (hole, next]
+        bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = Slot{EMPTY, models::NO_PRICE};
+    return true;
+}
+
+std::optional<models::TenthCents> PriceIndex::price(models::StationHandle station, models::FuelType fuelType) const {
+    auto key = makeKey(station, fuelType);
+    const auto& slot = slots[slotFor(key)];
+    if (slot.key != key) return std::nullopt;
+    return slot.price;
+}
+
+std::optional<PriceIndex::Entry> PriceIndex::cheapest(models::FuelType fuelType) const {
+    const auto& prices = ordered[models::index(fuelType)];
+    if (prices.empty()) return std::nullopt;
+    return Entry{prices.begin()->second, prices.begin()->first};
+}
+
+size_t PriceIndex::rank(models::StationHandle station, models::FuelType fuelType) const {
+    auto current = price(station, fuelType);
+    if (!current) return 0;
+    return countBelow(fuelType, *current) + 1;
+}
+
+std::vector<PriceIndex::Entry> PriceIndex::topK(models::FuelType fuelType, size_t k) const {
+    const auto& prices = ordered[models::index(fuelType)];
+    std::vector<Entry> result;
+    result.reserve(std::min(k, prices.size()));
+    for (auto it = prices.begin(); it != prices.end() && result.size() < k; ++it) {
+        result.push_back({it->second, it->first});
+    }
+    return result;
+}
+
+size_t PriceIndex::slotFor(uint64_t key) const {
+    // Fibonacci hashing spreads the sequential handles over the table
+    auto mask = slots.size() - 1;
+    auto index = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+    while (slots[index].key != EMPTY && slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+void PriceIndex::grow() {
+    std::vector<Slot> old(slots.size() * 2, Slot{EMPTY, models::NO_PRICE});
+    old.swap(slots);
+    --shift;
+
+    for (const auto& slot : old) {
+        if (slot.key != EMPTY) {
+            slots[slotFor(slot.key)] = slot;
+        }
+    }
+}
+
+void PriceIndex::addRanked(models::FuelType fuelType, models::TenthCents price, int delta) {
+    auto& counts = priceCounts[models::index(fuelType)];
+    for (auto i = static_cast<size_t>(std::clamp<models::TenthCents>(price, 0, MAX_RANKED_PRICE)) + 1;
+         i < counts.size(); i += i & (~i + 1)) {
+        counts[i] += delta;
+    }
+}
+
+size_t PriceIndex::countBelow(models::FuelType fuelType, models::TenthCents price) const {
+    // Prefix sum over [0, price)
+    const auto& counts = priceCounts[models::index(fuelType)];
+    int64_t total = 0;
+    for (auto i = static_cast<size_t>(std::clamp<models::TenthCents>(price, 0, MAX_RANKED_PRICE)); i > 0;
+         i -= i & (~i + 1)) {
+        total += counts[i];
+    }
+    return static_cast<size_t>(total);
+}
+
+} // namespace monitoring
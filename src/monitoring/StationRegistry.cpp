@@ -0,0 +1,62 @@
+#include "monitoring/StationRegistry.hpp"
+#include <algorithm>
+
+namespace monitoring {
+
+void StationRegistry::update(const std::vector<models::FuelStation>& discovered, Clock::time_point now) {
+    std::unordered_map<std::string, models::FuelStation> updated;
+    updated.reserve(discovered.size());
+    for (const auto& station : discovered) {
+        updated.emplace(station.id, station);
+    }
+
+    stations = std::move(updated);
+    lastDiscovery = now;
+}
+
+const models::FuelStation* StationRegistry::applyPrices(const models::FuelStation& update) {
+    auto it = stations.find(update.id);
+    if (it == stations.end()) {
+        return nullptr;
+    }
+
+    auto& station = it->second;
+    station.isOpen = update.isOpen;
+
+    // Fuel types missing from the update keep their last known price
+    for (const auto& price : update.prices) {
+        auto existing = std::find_if(station.prices.begin(), station.prices.end(),
+            [&](const auto& p) { return p.fuelType == price.fuelType; });
+
+        if (existing != station.prices.end()) {
+            *existing = price;
+        } else {
+            station.prices.push_back(price);
+        }
+    }
+
+    return &station;
+}
+
+bool StationRegistry::needsDiscovery(Clock::time_point now, std::chrono::minutes interval) const {
+    return !lastDiscovery || now - *lastDiscovery >= interval;
+}
+
+const models::FuelStation* StationRegistry::find(const std::string& stationId) const {
+    auto it = stations.find(stationId);
+    return it != stations.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> StationRegistry::stationIds() const {
+    std::vector<std::string> ids;
+    ids.reserve(stations.size());
+    for (const auto& [id, station] : stations) {
+        ids.push_back(id);
+    }
+
+    // Stable order keeps prices.php chunks identical between cycles
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace monitoring
@@ -50,6 +50,53 @@ const char* TeamsNotificationService::PRICE_ALERT_TEMPLATE = R"({
     ]
 })";
 
+const char* TeamsNotificationService::ANOMALY_ALERT_TEMPLATE = R"({
+    "type": "AdaptiveCard",
+    "version": "1.4",
+    "body": [
+        {
+            "type": "TextBlock",
+            "size": "Large",
+            "weight": "Bolder",
+            "text": "${title}"
+        },
+        {
+            "type": "FactSet",
+            "facts": [
+                {
+                    "title": "Station",
+                    "value": "${station_name}"
+                },
+                {
+                    "title": "Address",
+                    "value": "${address}"
+                },
+                {
+                    "title": "Anomaly",
+                    "value": "${anomaly_type}"
+                },
+                {
+                    "title": "Current Price",
+                    "value": "${current_price} €"
+                },
+                {
+                    "title": "Usual Price",
+                    "value": "${expected_price} €"
+                },
+                {
+                    "title": "Unchanged Since",
+                    "value": "${unchanged_since}"
+                }
+            ]
+        },
+        {
+            "type": "TextBlock",
+            "text": "${message}",
+            "wrap": true
+        }
+    ]
+})";
+
 const char* TeamsNotificationService::STATISTICS_REPORT_TEMPLATE = R"({
     "type": "AdaptiveCard",
     "version": "1.4",
@@ -114,6 +161,13 @@ void TeamsNotificationService::sendPriceAlert(const PriceAlertMessage& message)
     }
 }
 
+void TeamsNotificationService::sendAnomalyAlert(const AnomalyAlertMessage& message) {
+    auto card = createAdaptiveCard(message);
+    if (!sendWebhookRequest(card)) {
+        throw std::runtime_error("Failed to send anomaly alert to Teams");
+    }
+}
+
 void TeamsNotificationService::sendStatisticsReport(const StatisticsReportMessage& message) {
     auto card = createAdaptiveCard(message);
     if (!sendWebhookRequest(card)) {
@@ -148,6 +202,27 @@ nlohmann::json TeamsNotificationService::createAdaptiveCard(const NotificationMe
 
         return {{"type", "message"}, {"attachments", {{{"contentType", "application/vnd.microsoft.card.adaptive"}, {"content", card}}}};
     }
+    else if (auto anomalyAlert = dynamic_cast<const AnomalyAlertMessage*>(&message)) {
+        std::string address = fmt::format("{} {}, {} {}",
+            anomalyAlert->station.location.street,
+            anomalyAlert->station.location.houseNumber,
+            anomalyAlert->station.location.postalCode,
+            anomalyAlert->station.location.city);
+
+        nlohmann::json card = nlohmann::json::parse(ANOMALY_ALERT_TEMPLATE);
+        card["body"][0]["text"] = anomalyAlert->title;
+        card["body"][1]["facts"][0]["value"] = anomalyAlert->station.name;
+        card["body"][1]["facts"][1]["value"] = address;
+        card["body"][1]["facts"][2]["value"] = anomalyAlert->deviation != 0.0
+            ? fmt::format("{} ({:+.1f} σ)", anomalyAlert->anomalyType, anomalyAlert->deviation)
+            : anomalyAlert->anomalyType;
+        card["body"][1]["facts"][3]["value"] = fmt::format("{:.3f} €", anomalyAlert->currentPrice);
+        card["body"][1]["facts"][4]["value"] = fmt::format("{:.3f} €", anomalyAlert->expectedPrice);
+        card["body"][1]["facts"][5]["value"] = anomalyAlert->unchangedSince;
+        card["body"][2]["text"] = anomalyAlert->body;
+
+        return {{"type", "message"}, {"attachments", {{{"contentType", "application/vnd.microsoft.card.adaptive"}, {"content", card}}}}};
+    }
     else if (auto statsReport = dynamic_cast<const StatisticsReportMessage*>(&message)) {
         nlohmann::json card = nlohmann::json::parse(STATISTICS_REPORT_TEMPLATE);
         card["body"][0]["text"] = statsReport->title;
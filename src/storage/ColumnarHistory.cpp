@@ -0,0 +1,79 @@
+#include "storage/ColumnarHistory.hpp"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace storage {
+
+namespace {
+
+size_t columnIndex(models::StationHandle station, models::FuelType fuelType) {
+    return static_cast<size_t>(station) * models::FUEL_TYPE_COUNT + models::index(fuelType);
+}
+
+} // namespace
+
+ColumnarHistory ColumnarHistory::load(PriceStore& store, models::EpochSeconds from, models::EpochSeconds to) {
+    std::vector<PriceRecord> records;
+    store.scan(from, to, [&](const PriceRecord& record) {
+        records.push_back(record);
+    });
+    return build(records);
+}
+
+ColumnarHistory ColumnarHistory::build(std::span<const PriceRecord> records) {
+    ColumnarHistory history;
+    if (records.empty()) return history;
+
+    models::StationHandle maxStation = 0;
+    for (const auto& record : records) {
+        maxStation = std::max(maxStation, record.station);
+    }
+
+    // Counting sort by column keeps the append order within a column
+    auto columns = (static_cast<size_t>(maxStation) + 1) * models::FUEL_TYPE_COUNT;
+    history.offsets.assign(columns + 1, 0);
+    for (const auto& record : records) {
+        ++history.offsets[columnIndex(record.station, record.fuelType) + 1];
+    }
+    std::partial_sum(history.offsets.begin(), history.offsets.end(), history.offsets.begin());
+
+    std::vector<std::pair<models::EpochSeconds, models::TenthCents>> placed(records.size());
+    std::vector<uint64_t> cursor(history.offsets.begin(), history.offsets.end() - 1);
+    for (const auto& record : records) {
+        placed[cursor[columnIndex(record.station, record.fuelType)]++] = {record.timestamp, record.price};
+    }
+
+    // Appends are nearly always in time order already; imports of older
+    // dumps after newer data are not
+    for (size_t column = 0; column < columns; ++column) {
+        auto begin = placed.begin() + static_cast<ptrdiff_t>(history.offsets[column]);
+        auto end = placed.begin() + static_cast<ptrdiff_t>(history.offsets[column + 1]);
+        auto byTime = [](const auto& a, const auto& b) { return a.first < b.first; };
+        if (!std::is_sorted(begin, end, byTime)) {
+            std::stable_sort(begin, end, byTime);
+        }
+    }
+
+    history.timestamps.reserve(placed.size());
+    history.prices.reserve(placed.size());
+    for (const auto& [timestamp, price] : placed) {
+        history.timestamps.push_back(timestamp);
+        history.prices.push_back(price);
+    }
+    return history;
+}
+
+ColumnarHistory::Column ColumnarHistory::column(models::StationHandle station, models::FuelType fuelType) const {
+    auto index = columnIndex(station, fuelType);
+    if (index + 1 >= offsets.size()) return {};
+
+    auto begin = offsets[index];
+    auto count = offsets[index + 1] - begin;
+    return {
+        std::span(timestamps).subspan(begin, count),
+        std::span(prices).subspan(begin, count)
+    };
+}
+
+} // namespace storage
@@ -0,0 +1,275 @@
+#include "storage/CsvImporter.hpp"
+#include "storage/MappedFile.hpp"
+#include <charconv>
+#include <mutex>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace storage {
+
+namespace {
+
+constexpr std::string_view PRICE_HEADER = "date,station_uuid,diesel,e5,e10,dieselchange,e5change,e10change";
+
+// Change flags in the price dumps: 0 unchanged, 1 changed, 2 removed, 3 new
+bool isPriceChange(std::string_view flag) {
+    return flag == "1" || flag == "3";
+}
+
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+std::string_view nextLine(std::string_view& text) {
+    auto end = text.find('\n');
+    auto line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+// Returns the next record, which may span several lines if a quoted field
+// contains line breaks
+std::string_view nextRecord(std::string_view& text) {
+    bool quoted = false;
+    size_t i = 0;
+    for (; i < text.size(); ++i) {
+        if (text[i] == '"') quoted = !quoted;
+        else if (text[i] == '\n' && !quoted) break;
+    }
+
+    auto record = text.substr(0, i);
+    text.remove_prefix(std::min(text.size(), i + 1));
+    if (!record.empty() && record.back() == '\r') record.remove_suffix(1);
+    return record;
+}
+
+} // namespace
+
+bool CsvFieldSplitter::next(std::string_view& field) {
+    if (done) return false;
+
+    if (!rest.empty() && rest.front() == '"') {
+        // Quoted field, "" is an escaped quote
+        size_t i = 1;
+        while (i < rest.size()) {
+            if (rest[i] == '"') {
+                if (i + 1 < rest.size() && rest[i + 1] == '"') {
+                    i += 2;
+                    continue;
+                }
+                break;
+            }
+            ++i;
+        }
+        field = rest.substr(1, i - 1);
+        rest.remove_prefix(std::min(rest.size(), i + 1));
+    } else {
+        auto comma = rest.find(',');
+        field = rest.substr(0, comma);
+        rest.remove_prefix(comma == std::string_view::npos ? rest.size() : comma);
+    }
+
+    if (rest.empty()) {
+        done = true;
+    } else {
+        rest.remove_prefix(1);  // the comma
+    }
+    return true;
+}
+
+std::string CsvFieldSplitter::unescape(std::string_view field) {
+    std::string result;
+    result.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        result += field[i];
+        if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') ++i;
+    }
+    return result;
+}
+
+CsvImporter::Stats CsvImporter::importPrices(const std::filesystem::path& file, const PriceSink& sink) {
+    return importPrices(file, sink, Options{});
+}
+
+CsvImporter::Stats CsvImporter::importPrices(
+    const std::filesystem::path& file,
+    const PriceSink& sink,
+    Options options
+) {
+    MappedFile mapped(file);
+    std::string_view data = mapped.data();
+
+    auto header = nextLine(data);
+    if (header != PRICE_HEADER) {
+        throw std::runtime_error(fmt::format("Unexpected price file header in {}", file.string()));
+    }
+
+    // Split at line boundaries into one chunk per thread
+    size_t threadCount = std::max<size_t>(1, std::min(options.threads, data.size() / (1 << 16) + 1));
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t i = 1; i <= threadCount && begin < data.size(); ++i) {
+        size_t end = i == threadCount ? data.size() : data.size() * i / threadCount;
+        if (end < begin) end = begin;
+        auto newline = data.find('\n', end);
+        end = newline == std::string_view::npos ? data.size() : newline + 1;
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+
+    AtomicStats stats;
+    std::vector<std::thread> workers;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back([&, chunk = chunks[i]] {
+            try {
+                importPriceChunk(chunk, sink, options.batchSize, stats);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+    }
+
+    // The calling thread takes the first chunk
+    try {
+        if (!chunks.empty()) {
+            importPriceChunk(chunks[0], sink, options.batchSize, stats);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) error = std::current_exception();
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return Stats{
+        .rows = stats.rows.load(),
+        .records = stats.records.load(),
+        .malformedRows = stats.malformedRows.load(),
+        .bytes = mapped.size()
+    };
+}
+
+CsvImporter::Stats CsvImporter::importPrices(
+    const std::vector<std::filesystem::path>& files,
+    const PriceSink& sink,
+    Options options
+) {
+    Stats total;
+    for (const auto& file : files) {
+        auto stats = importPrices(file, sink, options);
+        total.rows += stats.rows;
+        total.records += stats.records;
+        total.malformedRows += stats.malformedRows;
+        total.bytes += stats.bytes;
+    }
+    return total;
+}
+
+void CsvImporter::importPriceChunk(
+    std::string_view chunk,
+    const PriceSink& sink,
+    size_t batchSize,
+    AtomicStats& stats
+) {
+    // In the order of the price columns
+    static constexpr models::FuelType FUEL_TYPES[] = {
+        models::FuelType::Diesel, models::FuelType::E5, models::FuelType::E10
+    };
+
+    std::vector<PriceChangeRecord> batch;
+    batch.reserve(batchSize);
+    uint64_t rows = 0, records = 0, malformed = 0;
+
+    while (!chunk.empty()) {
+        auto line = nextLine(chunk);
+        if (line.empty()) continue;
+        ++rows;
+
+        // date,station_uuid,diesel,e5,e10,dieselchange,e5change,e10change
+        std::string_view fields[8];
+        CsvFieldSplitter splitter(line);
+        size_t count = 0;
+        while (count < 8 && splitter.next(fields[count])) ++count;
+
+        auto timestamp = count == 8 ? models::parseTimestamp(fields[0]) : std::nullopt;
+        if (!timestamp) {
+            ++malformed;
+            continue;
+        }
+
+        for (size_t fuel = 0; fuel < 3; ++fuel) {
+            if (!isPriceChange(fields[5 + fuel])) continue;
+
+            double price = 0.0;
+            if (!parseNumber(fields[2 + fuel], price) || price <= 0.0) continue;
+
+            batch.push_back({fields[1], FUEL_TYPES[fuel], *timestamp, models::toTenthCents(price)});
+            if (batch.size() == batchSize) {
+                sink(batch);
+                records += batch.size();
+                batch.clear();
+            }
+        }
+    }
+
+    if (!batch.empty()) {
+        sink(batch);
+        records += batch.size();
+    }
+
+    stats.rows += rows;
+    stats.records += records;
+    stats.malformedRows += malformed;
+}
+
+std::vector<models::FuelStation> CsvImporter::importStations(const std::filesystem::path& file) {
+    MappedFile mapped(file);
+    std::string_view data = mapped.data();
+
+    // uuid,name,brand,street,house_number,post_code,city,latitude,longitude,first_active,openingtimes_json
+    nextRecord(data);
+
+    std::vector<models::FuelStation> stations;
+    while (!data.empty()) {
+        auto record = nextRecord(data);
+        if (record.empty()) continue;
+
+        std::string_view fields[9];
+        CsvFieldSplitter splitter(record);
+        size_t count = 0;
+        while (count < 9 && splitter.next(fields[count])) ++count;
+        if (count < 9) continue;
+
+        models::FuelStation station;
+        station.id = std::string(fields[0]);
+        station.name = CsvFieldSplitter::unescape(fields[1]);
+        station.brand = CsvFieldSplitter::unescape(fields[2]);
+        station.location.street = CsvFieldSplitter::unescape(fields[3]);
+        station.location.houseNumber = CsvFieldSplitter::unescape(fields[4]);
+        station.location.postalCode = std::string(fields[5]);
+        station.location.city = CsvFieldSplitter::unescape(fields[6]);
+        if (!parseNumber(fields[7], station.location.latitude) ||
+            !parseNumber(fields[8], station.location.longitude)) {
+            continue;
+        }
+        station.isOpen = false;
+        station.distance = 0.0;
+
+        stations.push_back(std::move(station));
+    }
+
+    return stations;
+}
+
+} // namespace storage
@@ -0,0 +1,59 @@
+#include "storage/MappedFile.hpp"
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fmt/format.h>
+
+namespace storage {
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("Failed to open {}", path.string()));
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("Failed to stat {}", path.string()));
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            address = nullptr;
+            ::close(fd);
+            throw std::runtime_error(fmt::format("Failed to map {}", path.string()));
+        }
+        ::madvise(address, length, MADV_SEQUENTIAL);
+    }
+
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (address) {
+        ::munmap(address, length);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : address(std::exchange(other.address, nullptr)),
+      length(std::exchange(other.length, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (address) {
+            ::munmap(address, length);
+        }
+        address = std::exchange(other.address, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+} // namespace storage
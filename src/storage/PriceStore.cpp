@@ -0,0 +1,522 @@
+#include "storage/PriceStore.hpp"
+#include "storage/ColumnarHistory.hpp"
+#include "storage/MappedFile.hpp"
+#include "storage/SeriesArchive.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fmt/format.h>
+
+namespace storage {
+
+namespace {
+
+// On-disk layouts, in host byte order
+struct DiskRecord {
+    int64_t timestamp;
+    uint32_t station;
+    int32_t price;
+    uint8_t fuelType;
+    uint8_t reserved[3];
+    uint32_t checksum;  // over the preceding 20 bytes
+};
+static_assert(sizeof(DiskRecord) == 24);
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t stationCount;
+    uint64_t segmentCount;
+};
+
+struct SnapshotSegment {
+    uint64_t id;
+    uint64_t records;
+    int64_t minTimestamp;
+    int64_t maxTimestamp;
+};
+
+struct SnapshotEntry {
+    int64_t timestamp;
+    int32_t price;
+    uint32_t reserved;
+};
+
+constexpr char SNAPSHOT_MAGIC[8] = {'F', 'P', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr const char* STATIONS_FILE = "stations.txt";
+constexpr const char* SNAPSHOT_FILE = "latest.snapshot";
+
+uint32_t checksum(const DiskRecord& record) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&record);
+    for (size_t i = 0; i < offsetof(DiskRecord, checksum); ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::optional<uint64_t> parseSegmentId(const std::filesystem::path& path) {
+    auto name = path.filename().string();
+    if (!name.starts_with("segment-") || !(name.ends_with(".log") || name.ends_with(".fpa"))) return std::nullopt;
+    try {
+        return std::stoull(name.substr(8, name.size() - 12));
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+PriceStore::PriceStore(Options options) : options(std::move(options)) {
+    std::filesystem::create_directories(this->options.directory);
+
+    loadStations();
+    loadSnapshot();
+
+    // Segments written after the snapshot are replayed in full, the last
+    // segment the snapshot knew from where the snapshot left off
+    std::vector<uint64_t> onDisk;
+    for (const auto& entry : std::filesystem::directory_iterator(this->options.directory)) {
+        if (auto id = parseSegmentId(entry.path())) onDisk.push_back(*id);
+    }
+    std::sort(onDisk.begin(), onDisk.end());
+    onDisk.erase(std::unique(onDisk.begin(), onDisk.end()), onDisk.end());
+
+    std::erase_if(segments, [&](const Segment& segment) {
+        return !std::binary_search(onDisk.begin(), onDisk.end(), segment.id);
+    });
+    uint64_t lastKnown = segments.empty() ? 0 : segments.back().id;
+    for (auto id : onDisk) {
+        if (id > lastKnown) {
+            segments.push_back({id, 0, std::numeric_limits<models::EpochSeconds>::max(),
+                                std::numeric_limits<models::EpochSeconds>::min()});
+        }
+    }
+
+    // An archive replaces its log; a log next to one is left over from a
+    // crash during archiveSegment()
+    for (auto& segment : segments) {
+        if (std::filesystem::exists(archivePath(segment.id))) {
+            segment.archived = true;
+            std::filesystem::remove(segmentPath(segment.id));
+        }
+    }
+
+    for (auto& segment : segments) {
+        if (segment.id < lastKnown) continue;
+        if (segment.archived) {
+            replayArchive(segment);
+        } else {
+            replaySegment(segment, segment.id == lastKnown ? segment.records : 0);
+        }
+    }
+
+    openForAppend();
+}
+
+PriceStore::~PriceStore() {
+    try {
+        checkpoint();
+    } catch (const std::exception&) {
+        // The log is complete up to the last write; the next start replays it
+    }
+    if (segmentFd >= 0) {
+        ::close(segmentFd);
+    }
+}
+
+models::StationHandle PriceStore::intern(std::string_view stationId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stations.intern(stationId);
+}
+
+std::optional<models::StationHandle> PriceStore::find(std::string_view stationId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stations.find(stationId);
+}
+
+std::string PriceStore::stationId(models::StationHandle station) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stations.id(station);
+}
+
+size_t PriceStore::stationCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stations.size();
+}
+
+void PriceStore::append(const PriceRecord& record) {
+    append(std::span<const PriceRecord>(&record, 1));
+}
+
+void PriceStore::append(std::span<const PriceRecord> records) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (const auto& record : records) {
+        if (record.station >= stations.size()) {
+            throw std::invalid_argument(fmt::format("Unknown station handle {}", record.station));
+        }
+        if ((segments.back().records + 1) * sizeof(DiskRecord) > options.segmentBytes) {
+            rollSegment();
+        }
+
+        DiskRecord disk{};
+        disk.timestamp = record.timestamp;
+        disk.station = record.station;
+        disk.price = record.price;
+        disk.fuelType = static_cast<uint8_t>(record.fuelType);
+        disk.checksum = checksum(disk);
+
+        const auto* bytes = reinterpret_cast<const char*>(&disk);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(disk));
+
+        auto& segment = segments.back();
+        ++segment.records;
+        segment.minTimestamp = std::min(segment.minTimestamp, record.timestamp);
+        segment.maxTimestamp = std::max(segment.maxTimestamp, record.timestamp);
+        applyLatest(record);
+
+        if (buffer.size() >= options.bufferBytes) {
+            writeBuffer();
+        }
+    }
+    dirty = dirty || !records.empty();
+}
+
+void PriceStore::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    writeBuffer();
+}
+
+void PriceStore::checkpoint() {
+    std::lock_guard<std::mutex> lock(mutex);
+    writeBuffer();
+
+    // Every segment but the last one is complete
+    if (options.compress) {
+        for (size_t i = 0; i + 1 < segments.size(); ++i) {
+            if (!segments[i].archived) {
+                archiveSegment(segments[i]);
+            }
+        }
+    }
+
+    auto path = options.directory / SNAPSHOT_FILE;
+    if (!dirty && std::filesystem::exists(path)) return;
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.stationCount = latestPrices.size();
+    header.segmentCount = segments.size();
+
+    std::vector<SnapshotSegment> segmentEntries;
+    for (const auto& segment : segments) {
+        segmentEntries.push_back({segment.id, segment.records, segment.minTimestamp, segment.maxTimestamp});
+    }
+    std::vector<SnapshotEntry> entries;
+    entries.reserve(latestPrices.size() * models::FUEL_TYPE_COUNT);
+    for (const auto& prices : latestPrices) {
+        for (const auto& latest : prices) {
+            entries.push_back({latest.timestamp, latest.price, 0});
+        }
+    }
+
+    // Written to a temporary file first so a crash never leaves a partial snapshot
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(segmentEntries.data()),
+                   static_cast<std::streamsize>(segmentEntries.size() * sizeof(SnapshotSegment)));
+        file.write(reinterpret_cast<const char*>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(SnapshotEntry)));
+        if (!file) {
+            throw std::runtime_error(fmt::format("Failed to write {}", temporary.string()));
+        }
+    }
+    std::filesystem::rename(temporary, path);
+    dirty = false;
+}
+
+std::optional<PriceStore::Latest> PriceStore::latest(models::StationHandle station, models::FuelType fuelType) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (station >= latestPrices.size()) return std::nullopt;
+
+    const auto& latest = latestPrices[station][models::index(fuelType)];
+    if (latest.price == models::NO_PRICE) return std::nullopt;
+    return latest;
+}
+
+void PriceStore::forEachLatest(const std::function<void(const PriceRecord&)>& callback) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t station = 0; station < latestPrices.size(); ++station) {
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            const auto& latest = latestPrices[station][models::index(fuelType)];
+            if (latest.price == models::NO_PRICE) continue;
+            callback({static_cast<models::StationHandle>(station), fuelType, latest.timestamp, latest.price});
+        }
+    }
+}
+
+void PriceStore::scan(
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    const std::function<void(const PriceRecord&)>& callback
+) {
+    // Segments are append-only, so the records written so far can be read
+    // without holding the lock
+    std::vector<Segment> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        writeBuffer();
+        snapshot = segments;
+    }
+
+    for (const auto& segment : snapshot) {
+        if (segment.records == 0 || segment.maxTimestamp < from || segment.minTimestamp >= to) continue;
+
+        std::optional<MappedFile> file;
+        if (!segment.archived) {
+            try {
+                file.emplace(segmentPath(segment.id));
+            } catch (const std::exception&) {
+                // Archived by a checkpoint after the copy was taken
+            }
+        }
+        if (!file) {
+            SeriesArchive(archivePath(segment.id)).scan(from, to, callback);
+            continue;
+        }
+
+        auto count = std::min<uint64_t>(segment.records, file->size() / sizeof(DiskRecord));
+        for (uint64_t i = 0; i < count; ++i) {
+            DiskRecord disk;
+            std::memcpy(&disk, file->data().data() + i * sizeof(DiskRecord), sizeof(disk));
+            if (disk.timestamp < from || disk.timestamp >= to) continue;
+
+            callback({disk.station, static_cast<models::FuelType>(disk.fuelType), disk.timestamp, disk.price});
+        }
+    }
+}
+
+uint64_t PriceStore::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t total = 0;
+    for (const auto& segment : segments) {
+        total += segment.records;
+    }
+    return total;
+}
+
+size_t PriceStore::segmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return segments.size();
+}
+
+std::filesystem::path PriceStore::segmentPath(uint64_t id) const {
+    return options.directory / fmt::format("segment-{:08}.log", id);
+}
+
+std::filesystem::path PriceStore::archivePath(uint64_t id) const {
+    return options.directory / fmt::format("segment-{:08}.fpa", id);
+}
+
+void PriceStore::loadStations() {
+    auto path = options.directory / STATIONS_FILE;
+    if (std::filesystem::exists(path)) {
+        MappedFile file(path);
+        auto data = file.data();
+
+        // A line without its newline is a torn write and is dropped
+        size_t complete = 0;
+        for (size_t end; (end = data.find('\n', complete)) != std::string_view::npos; complete = end + 1) {
+            stations.intern(data.substr(complete, end - complete));
+        }
+        if (complete != data.size()) {
+            std::filesystem::resize_file(path, complete);
+        }
+    }
+
+    persistedStations = stations.size();
+    stationFile.open(path, std::ios::app | std::ios::binary);
+    if (!stationFile) {
+        throw std::runtime_error(fmt::format("Failed to open {}", path.string()));
+    }
+}
+
+void PriceStore::loadSnapshot() {
+    auto path = options.directory / SNAPSHOT_FILE;
+    if (!std::filesystem::exists(path)) return;
+
+    MappedFile file(path);
+    auto data = file.data();
+
+    SnapshotHeader header;
+    if (data.size() < sizeof(header)) return;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    size_t expected = sizeof(header) + header.segmentCount * sizeof(SnapshotSegment) +
+                      header.stationCount * models::FUEL_TYPE_COUNT * sizeof(SnapshotEntry);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || data.size() != expected ||
+        header.stationCount > stations.size()) {
+        // Unusable snapshot: fall back to replaying the whole log
+        return;
+    }
+
+    const char* position = data.data() + sizeof(header);
+    for (uint64_t i = 0; i < header.segmentCount; ++i, position += sizeof(SnapshotSegment)) {
+        SnapshotSegment segment;
+        std::memcpy(&segment, position, sizeof(segment));
+        segments.push_back({segment.id, segment.records, segment.minTimestamp, segment.maxTimestamp});
+    }
+
+    latestPrices.resize(header.stationCount);
+    for (auto& prices : latestPrices) {
+        for (auto& latest : prices) {
+            SnapshotEntry entry;
+            std::memcpy(&entry, position, sizeof(entry));
+            position += sizeof(entry);
+            latest = {entry.price, entry.timestamp};
+        }
+    }
+}
+
+void PriceStore::replaySegment(Segment& segment, uint64_t firstRecord) {
+    auto path = segmentPath(segment.id);
+    uint64_t valid;
+    {
+        MappedFile file(path);
+        uint64_t count = file.size() / sizeof(DiskRecord);
+        valid = std::min(firstRecord, count);
+        for (uint64_t i = valid; i < count; ++i, ++valid) {
+            DiskRecord disk;
+            std::memcpy(&disk, file.data().data() + i * sizeof(DiskRecord), sizeof(disk));
+            if (disk.checksum != checksum(disk) || disk.station >= stations.size() ||
+                disk.fuelType >= models::FUEL_TYPE_COUNT) {
+                break;
+            }
+
+            PriceRecord record{disk.station, static_cast<models::FuelType>(disk.fuelType), disk.timestamp, disk.price};
+            segment.minTimestamp = std::min(segment.minTimestamp, record.timestamp);
+            segment.maxTimestamp = std::max(segment.maxTimestamp, record.timestamp);
+            applyLatest(record);
+        }
+
+        if (valid == firstRecord && file.size() == valid * sizeof(DiskRecord)) {
+            segment.records = valid;
+            return;
+        }
+    }
+
+    // Cut off a torn or corrupt tail so new records follow valid ones
+    if (std::filesystem::file_size(path) != valid * sizeof(DiskRecord)) {
+        std::filesystem::resize_file(path, valid * sizeof(DiskRecord));
+    }
+    segment.records = valid;
+    dirty = true;
+}
+
+// Archives are only written from complete segments, so all of it is valid.
+// Replaying is idempotent: applyLatest keeps the newest record either way.
+void PriceStore::replayArchive(Segment& segment) {
+    SeriesArchive archive(archivePath(segment.id));
+    segment.records = 0;
+    archive.scan(std::numeric_limits<models::EpochSeconds>::min(), std::numeric_limits<models::EpochSeconds>::max(),
+                 [&](const PriceRecord& record) {
+        ++segment.records;
+        segment.minTimestamp = std::min(segment.minTimestamp, record.timestamp);
+        segment.maxTimestamp = std::max(segment.maxTimestamp, record.timestamp);
+        applyLatest(record);
+    });
+    dirty = true;
+}
+
+void PriceStore::archiveSegment(Segment& segment) {
+    auto path = segmentPath(segment.id);
+    std::vector<PriceRecord> records;
+    {
+        MappedFile file(path);
+        auto count = std::min<uint64_t>(segment.records, file.size() / sizeof(DiskRecord));
+        records.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            DiskRecord disk;
+            std::memcpy(&disk, file.data().data() + i * sizeof(DiskRecord), sizeof(disk));
+            records.push_back({disk.station, static_cast<models::FuelType>(disk.fuelType), disk.timestamp, disk.price});
+        }
+    }
+
+    SeriesArchive::write(archivePath(segment.id), ColumnarHistory::build(records));
+    std::filesystem::remove(path);
+    segment.archived = true;
+}
+
+void PriceStore::openForAppend() {
+    if (segments.empty()) {
+        segments.push_back({1, 0, std::numeric_limits<models::EpochSeconds>::max(),
+                            std::numeric_limits<models::EpochSeconds>::min()});
+    }
+
+    auto path = segmentPath(segments.back().id);
+    segmentFd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (segmentFd < 0) {
+        throw std::runtime_error(fmt::format("Failed to open {}", path.string()));
+    }
+}
+
+void PriceStore::writeBuffer() {
+    // Station IDs go first so that every record on disk refers to a known ID
+    if (persistedStations < stations.size()) {
+        for (; persistedStations < stations.size(); ++persistedStations) {
+            stationFile << stations.id(static_cast<models::StationHandle>(persistedStations)) << '\n';
+        }
+        stationFile.flush();
+        if (!stationFile) {
+            throw std::runtime_error("Failed to write station IDs");
+        }
+    }
+
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t result = ::write(segmentFd, buffer.data() + written, buffer.size() - written);
+        if (result < 0) {
+            throw std::runtime_error(fmt::format("Failed to write {}", segmentPath(segments.back().id).string()));
+        }
+        written += static_cast<size_t>(result);
+    }
+    buffer.clear();
+}
+
+void PriceStore::rollSegment() {
+    writeBuffer();
+    ::close(segmentFd);
+    segmentFd = -1;
+
+    segments.push_back({segments.back().id + 1, 0, std::numeric_limits<models::EpochSeconds>::max(),
+                        std::numeric_limits<models::EpochSeconds>::min()});
+    openForAppend();
+}
+
+void PriceStore::applyLatest(const PriceRecord& record) {
+    if (record.station >= latestPrices.size()) {
+        latestPrices.resize(record.station + 1);
+    }
+
+    // Records may arrive out of order (e.g. bulk imports), keep the newest
+    auto& latest = latestPrices[record.station][models::index(record.fuelType)];
+    if (latest.price == models::NO_PRICE || record.timestamp >= latest.timestamp) {
+        latest = {record.price, record.timestamp};
+    }
+}
+
+} // namespace storage
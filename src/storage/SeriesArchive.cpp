@@ -0,0 +1,145 @@
+#include "storage/SeriesArchive.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace storage {
+
+namespace {
+
+struct ArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t blockCount;
+    uint64_t indexOffset;
+};
+
+constexpr char ARCHIVE_MAGIC[8] = {'F', 'P', 'A', 'R', 'C', 'H', '0', '1'};
+constexpr uint32_t ARCHIVE_VERSION = 1;
+
+static_assert(sizeof(SeriesArchive::Block) == 48);
+static_assert(alignof(SeriesArchive::Block) <= 8);
+
+bool seriesBefore(const SeriesArchive::Block& block, std::pair<uint32_t, uint8_t> series) {
+    return std::pair(block.station, block.fuelType) < series;
+}
+
+} // namespace
+
+void SeriesArchive::write(const std::filesystem::path& path, const ColumnarHistory& history) {
+    std::vector<uint8_t> data;
+    std::vector<Block> blocks;
+
+    for (models::StationHandle station = 0; station < history.stationCount(); ++station) {
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            auto column = history.column(station, fuelType);
+            for (size_t first = 0; first < column.size(); first += SeriesCodec::BLOCK_POINTS) {
+                auto count = std::min(SeriesCodec::BLOCK_POINTS, column.size() - first);
+                auto timestamps = column.timestamps.subspan(first, count);
+                auto prices = column.prices.subspan(first, count);
+
+                Block block{};
+                block.station = station;
+                block.fuelType = static_cast<uint8_t>(fuelType);
+                block.count = static_cast<uint16_t>(count);
+                block.firstPrice = prices.front();
+                block.minPrice = *std::min_element(prices.begin(), prices.end());
+                block.maxPrice = *std::max_element(prices.begin(), prices.end());
+                block.firstTimestamp = timestamps.front();
+                block.lastTimestamp = timestamps.back();
+                block.offset = sizeof(ArchiveHeader) + data.size();
+                block.bytes = static_cast<uint32_t>(SeriesCodec::encode(timestamps, prices, data));
+                blocks.push_back(block);
+            }
+        }
+    }
+
+    // The index is 8-byte aligned so it can be used in place when mapped
+    data.resize((data.size() + 7) & ~size_t{7});
+
+    ArchiveHeader header{};
+    std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = ARCHIVE_VERSION;
+    header.blockCount = blocks.size();
+    header.indexOffset = sizeof(ArchiveHeader) + data.size();
+
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.write(reinterpret_cast<const char*>(blocks.data()),
+                   static_cast<std::streamsize>(blocks.size() * sizeof(Block)));
+        if (!file) {
+            throw std::runtime_error(fmt::format("Failed to write {}", temporary.string()));
+        }
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+SeriesArchive::SeriesArchive(const std::filesystem::path& path) : file(path) {
+    auto data = file.data();
+
+    ArchiveHeader header;
+    if (data.size() < sizeof(header)) {
+        throw std::runtime_error(fmt::format("Truncated archive: {}", path.string()));
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(header.magic)) != 0 || header.version != ARCHIVE_VERSION ||
+        header.indexOffset % alignof(Block) != 0 ||
+        header.indexOffset + header.blockCount * sizeof(Block) != data.size()) {
+        throw std::runtime_error(fmt::format("Invalid archive: {}", path.string()));
+    }
+
+    index = {reinterpret_cast<const Block*>(data.data() + header.indexOffset), header.blockCount};
+    for (const auto& block : index) {
+        if (block.offset + block.bytes + SeriesCodec::PADDING > header.indexOffset || block.count == 0 ||
+            block.count > SeriesCodec::BLOCK_POINTS || block.fuelType >= models::FUEL_TYPE_COUNT) {
+            throw std::runtime_error(fmt::format("Invalid archive block in {}", path.string()));
+        }
+        records += block.count;
+    }
+}
+
+std::span<const SeriesArchive::Block> SeriesArchive::blocks(models::StationHandle station, models::FuelType fuelType) const {
+    auto series = std::pair(station, static_cast<uint8_t>(models::index(fuelType)));
+    auto begin = std::lower_bound(index.begin(), index.end(), series, seriesBefore);
+    auto end = begin;
+    while (end != index.end() && end->station == station && end->fuelType == series.second) {
+        ++end;
+    }
+    return {begin, end};
+}
+
+void SeriesArchive::decode(const Block& block, models::EpochSeconds* timestamps, models::TenthCents* prices) const {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(file.data().data()) + block.offset;
+    SeriesCodec::decode(bytes, block.count, block.firstTimestamp, block.firstPrice, timestamps, prices);
+}
+
+void SeriesArchive::scan(
+    models::EpochSeconds from,
+    models::EpochSeconds to,
+    const std::function<void(const PriceRecord&)>& callback
+) const {
+    std::array<models::EpochSeconds, SeriesCodec::BLOCK_POINTS> timestamps;
+    std::array<models::TenthCents, SeriesCodec::BLOCK_POINTS> prices;
+
+    for (const auto& block : index) {
+        if (block.lastTimestamp < from || block.firstTimestamp >= to) continue;
+
+        decode(block, timestamps.data(), prices.data());
+        auto fuelType = static_cast<models::FuelType>(block.fuelType);
+        for (size_t i = 0; i < block.count; ++i) {
+            if (timestamps[i] < from || timestamps[i] >= to) continue;
+            callback({block.station, fuelType, timestamps[i], prices[i]});
+        }
+    }
+}
+
+} // namespace storage
@@ -0,0 +1,207 @@
+#include "storage/SeriesCodec.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace storage {
+
+namespace {
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Bits are packed least significant first
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out), start(out.size()) {}
+
+    void write(uint64_t value, unsigned bits) {
+        if (bits > 32) {
+            write(value & 0xffffffffu, 32);
+            write(value >> 32, bits - 32);
+            return;
+        }
+        buffer |= (value & ((uint64_t{1} << bits) - 1)) << used;
+        used += bits;
+        while (used >= 8) {
+            out.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            used -= 8;
+        }
+    }
+
+    size_t finish() {
+        if (used > 0) {
+            out.push_back(static_cast<uint8_t>(buffer));
+        }
+        buffer = 0;
+        used = 0;
+        return out.size() - start;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    size_t start;
+    uint64_t buffer = 0;
+    unsigned used = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* data) : data(data) {}
+
+    // Up to 56 bits
+    uint64_t peek(unsigned bits) const {
+        uint64_t word;
+        std::memcpy(&word, data + (position >> 3), sizeof(word));
+        return (word >> (position & 7)) & ((uint64_t{1} << bits) - 1);
+    }
+
+    void skip(unsigned bits) { position += bits; }
+
+    uint64_t read(unsigned bits) {
+        if (bits > 32) {
+            auto low = read(32);
+            return low | (read(bits - 32) << 32);
+        }
+        auto value = peek(bits);
+        position += bits;
+        return value;
+    }
+
+private:
+    const uint8_t* data;
+    size_t position = 0;
+};
+
+void encodeTimestamp(BitWriter& writer, int64_t deltaOfDelta) {
+    auto value = zigzag(deltaOfDelta);
+    if (value == 0) {
+        writer.write(0b0, 1);
+    } else if (value < (1u << 7)) {
+        writer.write(0b01, 2);
+        writer.write(value, 7);
+    } else if (value < (1u << 12)) {
+        writer.write(0b011, 3);
+        writer.write(value, 12);
+    } else if (value < (1u << 20)) {
+        writer.write(0b0111, 4);
+        writer.write(value, 20);
+    } else {
+        writer.write(0b1111, 4);
+        writer.write(value, 64);
+    }
+}
+
+void encodePrice(BitWriter& writer, int64_t delta) {
+    if (delta % 10 == 0) {
+        auto cents = zigzag(delta / 10);
+        if (cents < (1u << 4)) {
+            writer.write(0b0, 1);
+            writer.write(cents, 4);
+            return;
+        }
+        if (cents < (1u << 8)) {
+            writer.write(0b01, 2);
+            writer.write(cents, 8);
+            return;
+        }
+    }
+    auto value = zigzag(delta);
+    if (value < (1u << 12)) {
+        writer.write(0b011, 3);
+        writer.write(value, 12);
+    } else {
+        writer.write(0b111, 3);
+        writer.write(value, 33);
+    }
+}
+
+} // namespace
+
+size_t SeriesCodec::encode(
+    std::span<const models::EpochSeconds> timestamps,
+    std::span<const models::TenthCents> prices,
+    std::vector<uint8_t>& out
+) {
+    if (timestamps.size() != prices.size() || timestamps.empty() || timestamps.size() > BLOCK_POINTS) {
+        throw std::invalid_argument(fmt::format("Invalid block of {} points", timestamps.size()));
+    }
+
+    BitWriter writer(out);
+    int64_t previousDelta = 0;
+    for (size_t i = 1; i < timestamps.size(); ++i) {
+        auto delta = timestamps[i] - timestamps[i - 1];
+        encodeTimestamp(writer, delta - previousDelta);
+        encodePrice(writer, static_cast<int64_t>(prices[i]) - prices[i - 1]);
+        previousDelta = delta;
+    }
+    auto size = writer.finish();
+    out.insert(out.end(), PADDING, 0);
+    return size;
+}
+
+void SeriesCodec::decode(
+    const uint8_t* block,
+    size_t count,
+    models::EpochSeconds firstTimestamp,
+    models::TenthCents firstPrice,
+    models::EpochSeconds* timestamps,
+    models::TenthCents* prices
+) {
+    if (count == 0) return;
+
+    BitReader reader(block);
+    auto timestamp = firstTimestamp;
+    int64_t price = firstPrice;
+    int64_t delta = 0;
+    timestamps[0] = timestamp;
+    prices[0] = firstPrice;
+
+    for (size_t i = 1; i < count; ++i) {
+        // The prefixes are read from a single peek: the position of the first
+        // zero bit among the next four selects the class
+        auto prefix = reader.peek(4);
+        if ((prefix & 1) == 0) {
+            reader.skip(1);
+        } else if ((prefix & 2) == 0) {
+            reader.skip(2);
+            delta += unzigzag(reader.read(7));
+        } else if ((prefix & 4) == 0) {
+            reader.skip(3);
+            delta += unzigzag(reader.read(12));
+        } else if ((prefix & 8) == 0) {
+            reader.skip(4);
+            delta += unzigzag(reader.read(20));
+        } else {
+            reader.skip(4);
+            delta += unzigzag(reader.read(64));
+        }
+        timestamp += delta;
+
+        prefix = reader.peek(3);
+        if ((prefix & 1) == 0) {
+            reader.skip(1);
+            price += unzigzag(reader.read(4)) * 10;
+        } else if ((prefix & 2) == 0) {
+            reader.skip(2);
+            price += unzigzag(reader.read(8)) * 10;
+        } else if ((prefix & 4) == 0) {
+            reader.skip(3);
+            price += unzigzag(reader.read(12));
+        } else {
+            reader.skip(3);
+            price += unzigzag(reader.read(33));
+        }
+
+        timestamps[i] = timestamp;
+        prices[i] = static_cast<models::TenthCents>(price);
+    }
+}
+
+} // namespace storage
@@ -6,19 +6,112 @@
 
 namespace utils {
 
+namespace {
+
+// Settings the monitoring cycle can't run with, whichever source they came from
+void validate(const Config& config) {
+    if (config.monitoring.updateInterval <= 0) {
+        throw std::runtime_error("monitoring.updateInterval must be a positive number of minutes");
+    }
+    if (config.monitoring.fuelTypes.empty()) {
+        throw std::runtime_error("monitoring.fuelTypes must list at least one fuel type");
+    }
+}
+
+} // namespace
+
+void to_json(nlohmann::json& json, const CacheConfig& config) {
+    json = nlohmann::json{
+        {"enabled", config.enabled},
+        {"directory", config.directory},
+        {"memoryMegabytes", config.memoryMegabytes},
+        {"ttlSeconds", config.ttlSeconds}
+    };
+}
+
+void from_json(const nlohmann::json& json, CacheConfig& config) {
+    const CacheConfig defaults{};
+    config.enabled = json.value("enabled", defaults.enabled);
+    config.directory = json.value("directory", defaults.directory);
+    config.memoryMegabytes = json.value("memoryMegabytes", defaults.memoryMegabytes);
+    config.ttlSeconds = defaults.ttlSeconds;
+    for (const auto& [endpoint, ttl] : json.value("ttlSeconds", std::map<std::string, int>{})) {
+        config.ttlSeconds[endpoint] = ttl;
+    }
+}
+
+void to_json(nlohmann::json& json, const MonitoringConfig& config) {
+    json = nlohmann::json{
+        {"fuelTypes", config.fuelTypes},
+        {"updateInterval", config.updateInterval},
+        {"priceThreshold", config.priceThreshold},
+        {"notifyOnIncrease", config.notifyOnIncrease},
+        {"pollMode", config.pollMode},
+        {"discoveryInterval", config.discoveryInterval},
+        {"statisticsInterval", config.statisticsInterval},
+        {"statisticsWindowDays", config.statisticsWindowDays},
+        {"anomalyThreshold", config.anomalyThreshold},
+        {"staleHours", config.staleHours},
+        {"seasonalBand", config.seasonalBand}
+    };
+}
+
+void from_json(const nlohmann::json& json, MonitoringConfig& config) {
+    const MonitoringConfig defaults{};
+    json.at("fuelTypes").get_to(config.fuelTypes);
+    json.at("updateInterval").get_to(config.updateInterval);
+    json.at("priceThreshold").get_to(config.priceThreshold);
+    json.at("notifyOnIncrease").get_to(config.notifyOnIncrease);
+    config.pollMode = json.value("pollMode", defaults.pollMode);
+    config.discoveryInterval = json.value("discoveryInterval", defaults.discoveryInterval);
+    config.statisticsInterval = json.value("statisticsInterval", defaults.statisticsInterval);
+    config.statisticsWindowDays = json.value("statisticsWindowDays", defaults.statisticsWindowDays);
+    config.anomalyThreshold = json.value("anomalyThreshold", defaults.anomalyThreshold);
+    config.staleHours = json.value("staleHours", defaults.staleHours);
+    config.seasonalBand = json.value("seasonalBand", defaults.seasonalBand);
+}
+
+void to_json(nlohmann::json& json, const Config& config) {
+    json = nlohmann::json{
+        {"apiKey", config.apiKey},
+        {"location", config.location},
+        {"regions", config.regions},
+        {"coverage", config.coverage},
+        {"api", config.api},
+        {"storage", config.storage},
+        {"monitoring", config.monitoring},
+        {"notifications", config.notifications}
+    };
+}
+
+void from_json(const nlohmann::json& json, Config& config) {
+    json.at("apiKey").get_to(config.apiKey);
+    json.at("location").get_to(config.location);
+    config.regions = json.value("regions", std::vector<LocationConfig>{});
+    config.coverage = json.value("coverage", CoverageConfig{});
+    config.api = json.value("api", ApiConfig{});
+    config.storage = json.value("storage", StorageConfig{});
+    json.at("monitoring").get_to(config.monitoring);
+    json.at("notifications").get_to(config.notifications);
+}
+
 Config Config::load(const std::string& path) {
     std::ifstream file(path);
     if (!file.is_open()) {
         throw std::runtime_error(fmt::format("Failed to open config file: {}", path));
     }
 
+    Config config;
     try {
         nlohmann::json json;
         file >> json;
-        return json.get<Config>();
+        config = json.get<Config>();
     } catch (const std::exception& e) {
         throw std::runtime_error(fmt::format("Failed to parse config file: {}", e.what()));
     }
+
+    validate(config);
+    return config;
 }
 
 Config Config::fromEnvironment() {
@@ -47,11 +140,41 @@ Config Config::fromEnvironment() {
         throw std::runtime_error(fmt::format("Failed to parse location values: {}", e.what()));
     }
 
+    // API client configuration
+    const char* baseUrl = std::getenv("TANKERKOENIG_BASE_URL");
+    if (baseUrl) {
+        config.api.baseUrl = baseUrl;
+    }
+
+    const char* maxConcurrentRequests = std::getenv("MAX_CONCURRENT_REQUESTS");
+    if (maxConcurrentRequests) {
+        config.api.maxConcurrentRequests = std::stoi(maxConcurrentRequests);
+    }
+
+    const char* requestsPerMinute = std::getenv("REQUESTS_PER_MINUTE");
+    if (requestsPerMinute) {
+        config.api.rateLimit.requestsPerMinute = std::stod(requestsPerMinute);
+    }
+
+    const char* cacheDirectory = std::getenv("CACHE_DIRECTORY");
+    if (cacheDirectory) {
+        config.api.cache.directory = cacheDirectory;
+    }
+
+    // Storage configuration
+    const char* storageDirectory = std::getenv("STORAGE_DIRECTORY");
+    if (storageDirectory) {
+        config.storage.directory = storageDirectory;
+    }
+
     // Monitoring configuration
     const char* fuelTypes = std::getenv("FUEL_TYPES");
     const char* updateInterval = std::getenv("UPDATE_INTERVAL");
     const char* priceThreshold = std::getenv("PRICE_THRESHOLD");
     const char* notifyOnIncrease = std::getenv("NOTIFY_ON_INCREASE");
+    const char* pollMode = std::getenv("POLL_MODE");
+    const char* discoveryInterval = std::getenv("DISCOVERY_INTERVAL");
+    const char* statisticsInterval = std::getenv("STATISTICS_INTERVAL");
 
     if (fuelTypes) {
         std::string types(fuelTypes);
@@ -71,6 +194,9 @@ Config Config::fromEnvironment() {
     config.monitoring.updateInterval = updateInterval ? std::stoi(updateInterval) : 15;
     config.monitoring.priceThreshold = priceThreshold ? std::stod(priceThreshold) : 0.02;
     config.monitoring.notifyOnIncrease = notifyOnIncrease ? (std::string(notifyOnIncrease) == "true") : false;
+    if (pollMode) config.monitoring.pollMode = pollMode;
+    if (discoveryInterval) config.monitoring.discoveryInterval = std::stoi(discoveryInterval);
+    if (statisticsInterval) config.monitoring.statisticsInterval = std::stoi(statisticsInterval);
 
     // Notification configuration
     const char* teamsWebhook = std::getenv("TEAMS_WEBHOOK_URL");
@@ -81,6 +207,7 @@ Config Config::fromEnvironment() {
         config.notifications.push_back(teamsConfig);
     }
 
+    validate(config);
     return config;
 }
 
@@ -0,0 +1,126 @@
+#include "utils/CoveragePlanner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace utils {
+
+std::vector<CoverageTile> CoveragePlanner::planBoundingBox(const BoundingBox& box, double radius) {
+    return planCells(box, radius, nullptr);
+}
+
+std::vector<CoverageTile> CoveragePlanner::planPolygon(const std::vector<Waypoint>& polygon, double radius) {
+    if (polygon.size() < 3) {
+        throw std::invalid_argument("A coverage polygon needs at least 3 vertices");
+    }
+
+    BoundingBox box{polygon[0].latitude, polygon[0].longitude, polygon[0].latitude, polygon[0].longitude};
+    for (const auto& vertex : polygon) {
+        box.minLatitude = std::min(box.minLatitude, vertex.latitude);
+        box.maxLatitude = std::max(box.maxLatitude, vertex.latitude);
+        box.minLongitude = std::min(box.minLongitude, vertex.longitude);
+        box.maxLongitude = std::max(box.maxLongitude, vertex.longitude);
+    }
+
+    return planCells(box, radius, &polygon);
+}
+
+std::vector<CoverageTile> CoveragePlanner::planCells(
+    const BoundingBox& box,
+    double radius,
+    const std::vector<Waypoint>* polygon
+) {
+    if (radius <= 0 || radius > MAX_RADIUS) {
+        throw std::invalid_argument("Coverage radius must be within (0, 25] km");
+    }
+    if (box.minLatitude > box.maxLatitude || box.minLongitude > box.maxLongitude) {
+        throw std::invalid_argument("Invalid coverage bounding box");
+    }
+
+    double effectiveRadius = radius * SAFETY_FACTOR;
+    double rowHeightKm = effectiveRadius * std::sqrt(2.0);
+    double rowHeight = rowHeightKm / KM_PER_DEGREE;
+
+    // Rows are anchored at the equator and columns at the prime meridian, so
+    // tiles don't move when the area changes
+    auto firstRow = static_cast<int64_t>(std::floor(box.minLatitude / rowHeight + 0.5));
+    auto lastRow = static_cast<int64_t>(std::floor(box.maxLatitude / rowHeight + 0.5));
+
+    std::vector<CoverageTile> tiles;
+    for (int64_t row = firstRow; row <= lastRow; ++row) {
+        double latitude = row * rowHeight;
+
+        // Column width is limited by the equatorward edge of the row, where a
+        // degree of longitude is longest
+        double edgeLatitude = std::min(89.0, std::max(0.0, std::abs(latitude) - rowHeight / 2));
+        double columnWidthKm = rowHeightKm;  // 2 * sqrt(r^2 - (h/2)^2) with h = r * sqrt(2)
+        double columnWidth = columnWidthKm / (KM_PER_DEGREE * std::cos(toRadians(edgeLatitude)));
+
+        auto firstColumn = static_cast<int64_t>(std::floor(box.minLongitude / columnWidth + 0.5));
+        auto lastColumn = static_cast<int64_t>(std::floor(box.maxLongitude / columnWidth + 0.5));
+
+        for (int64_t column = firstColumn; column <= lastColumn; ++column) {
+            double longitude = column * columnWidth;
+
+            if (polygon) {
+                BoundingBox cell{
+                    latitude - rowHeight / 2, longitude - columnWidth / 2,
+                    latitude + rowHeight / 2, longitude + columnWidth / 2
+                };
+                if (!rectangleIntersectsPolygon(cell, *polygon)) continue;
+            }
+
+            tiles.push_back({row, column, latitude, longitude, radius});
+        }
+    }
+
+    return tiles;
+}
+
+bool CoveragePlanner::isPointInPolygon(double lat, double lon, const std::vector<Waypoint>& polygon) {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const auto& a = polygon[i];
+        const auto& b = polygon[j];
+        if ((a.latitude > lat) != (b.latitude > lat)) {
+            double crossing = a.longitude + (lat - a.latitude) * (b.longitude - a.longitude) / (b.latitude - a.latitude);
+            if (lon < crossing) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool CoveragePlanner::rectangleIntersectsPolygon(const BoundingBox& cell, const std::vector<Waypoint>& polygon) {
+    double centerLat = (cell.minLatitude + cell.maxLatitude) / 2;
+    double centerLon = (cell.minLongitude + cell.maxLongitude) / 2;
+    if (isPointInPolygon(centerLat, centerLon, polygon)) {
+        return true;
+    }
+
+    // Otherwise some polygon edge must cross the cell (Liang-Barsky clipping)
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        double x0 = polygon[j].longitude, y0 = polygon[j].latitude;
+        double dx = polygon[i].longitude - x0, dy = polygon[i].latitude - y0;
+
+        double p[4] = {-dx, dx, -dy, dy};
+        double q[4] = {x0 - cell.minLongitude, cell.maxLongitude - x0, y0 - cell.minLatitude, cell.maxLatitude - y0};
+
+        double t0 = 0.0, t1 = 1.0;
+        bool outside = false;
+        for (int k = 0; k < 4 && !outside; ++k) {
+            if (p[k] == 0) {
+                outside = q[k] < 0;
+            } else {
+                double t = q[k] / p[k];
+                if (p[k] < 0) t0 = std::max(t0, t);
+                else t1 = std::min(t1, t);
+                outside = t0 > t1;
+            }
+        }
+        if (!outside) return true;
+    }
+
+    return false;
+}
+
+} // namespace utils
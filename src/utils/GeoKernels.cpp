@@ -0,0 +1,351 @@
+#include "utils/GeoKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FUEL_PRICE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace utils {
+
+namespace {
+
+constexpr double INFINITE = std::numeric_limits<double>::infinity();
+constexpr double DEGREES_PER_RADIAN = 180.0 / M_PI;
+
+// Keeps the bounds conservative against rounding
+constexpr double SLACK = 1.0 + 1e-9;
+
+// As RouteCalculator::toRadians
+double toRadians(double degrees) {
+    return degrees * M_PI / 180.0;
+}
+
+GeoKernels::Anchor anchor(double latitude, double longitude) {
+    auto latitudeRadians = toRadians(latitude);
+    return {latitude, longitude, latitudeRadians, toRadians(longitude), std::cos(latitudeRadians)};
+}
+
+// RouteCalculator::calculateDistance from a point to an anchor
+double haversine(double latitude, double longitude, const GeoKernels::Anchor& to) {
+    double lat1Rad = toRadians(latitude);
+    double dLat = to.latitudeRadians - lat1Rad;
+    double dLon = to.longitudeRadians - toRadians(longitude);
+
+    double a = std::sin(dLat/2) * std::sin(dLat/2) +
+               std::cos(lat1Rad) * to.cosine *
+               std::sin(dLon/2) * std::sin(dLon/2);
+
+    double c = 2 * std::atan2(std::sqrt(a), std::sqrt(1-a));
+    return GeoKernels::EARTH_RADIUS * c;
+}
+
+// Offset of a point from its projection onto the segment, in degrees
+void offset(const GeoKernels::SegmentFrame& frame, double latitude, double longitude, double& dLat, double& dLon) {
+    double t = ((latitude - frame.start.latitude) * frame.deltaLatitude +
+                (longitude - frame.start.longitude) * frame.deltaLongitude) * frame.inverseLengthSquared;
+    t = std::clamp(t, 0.0, 1.0);
+    dLat = latitude - (frame.start.latitude + t * frame.deltaLatitude);
+    dLon = longitude - (frame.start.longitude + t * frame.deltaLongitude);
+}
+
+// Whether the offset rules the point out
+bool outside(const GeoKernels::SegmentFrame& frame, double dLat, double dLon) {
+    return std::abs(dLat) > frame.latitudeLimit || std::abs(dLon) > frame.longitudeLimit ||
+           dLat * dLat + frame.cosineSquared * dLon * dLon > frame.ellipse;
+}
+
+// Whether the offset puts the point within the corridor
+bool inside(const GeoKernels::SegmentFrame& frame, double dLat, double dLon) {
+    return dLat * dLat + frame.innerCosineSquared * dLon * dLon <= frame.innerEllipse;
+}
+
+size_t corridorDistancesScalar(
+    const GeoKernels::SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes,
+    std::span<double> distances,
+    size_t first
+) {
+    size_t within = 0;
+    for (size_t i = first; i < latitudes.size(); ++i) {
+        distances[i] = INFINITE;
+        double dLat, dLon;
+        offset(frame, latitudes[i], longitudes[i], dLat, dLon);
+        if (outside(frame, dLat, dLon)) continue;
+
+        auto distance = GeoKernels::distance(frame, latitudes[i], longitudes[i]);
+        if (distance <= frame.radius) {
+            distances[i] = distance;
+            ++within;
+        }
+    }
+    return within;
+}
+
+bool allWithinScalar(
+    const GeoKernels::SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes,
+    size_t first
+) {
+    for (size_t i = first; i < latitudes.size(); ++i) {
+        double dLat, dLon;
+        offset(frame, latitudes[i], longitudes[i], dLat, dLon);
+        if (outside(frame, dLat, dLon)) return false;
+        if (inside(frame, dLat, dLon)) continue;
+        if (!(GeoKernels::distance(frame, latitudes[i], longitudes[i]) <= frame.radius)) return false;
+    }
+    return true;
+}
+
+#ifdef FUEL_PRICE_AVX2
+
+// 4 points per iteration; lanes that pass the bound are refined one by one
+__attribute__((target("avx2")))
+size_t corridorDistancesAvx2(
+    const GeoKernels::SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes,
+    std::span<double> distances
+) {
+    auto startLatitude = _mm256_set1_pd(frame.start.latitude);
+    auto startLongitude = _mm256_set1_pd(frame.start.longitude);
+    auto deltaLatitude = _mm256_set1_pd(frame.deltaLatitude);
+    auto deltaLongitude = _mm256_set1_pd(frame.deltaLongitude);
+    auto inverseLength = _mm256_set1_pd(frame.inverseLengthSquared);
+    auto latitudeLimit = _mm256_set1_pd(frame.latitudeLimit);
+    auto longitudeLimit = _mm256_set1_pd(frame.longitudeLimit);
+    auto cosineSquared = _mm256_set1_pd(frame.cosineSquared);
+    auto ellipse = _mm256_set1_pd(frame.ellipse);
+    auto zero = _mm256_setzero_pd();
+    auto one = _mm256_set1_pd(1.0);
+    auto infinite = _mm256_set1_pd(INFINITE);
+    auto absolute = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+
+    size_t within = 0;
+    size_t i = 0;
+    for (; i + 4 <= latitudes.size(); i += 4) {
+        auto latitude = _mm256_loadu_pd(latitudes.data() + i);
+        auto longitude = _mm256_loadu_pd(longitudes.data() + i);
+
+        auto fromLatitude = _mm256_sub_pd(latitude, startLatitude);
+        auto fromLongitude = _mm256_sub_pd(longitude, startLongitude);
+        auto t = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(fromLatitude, deltaLatitude),
+                                             _mm256_mul_pd(fromLongitude, deltaLongitude)), inverseLength);
+        t = _mm256_min_pd(_mm256_max_pd(t, zero), one);
+
+        auto dLat = _mm256_sub_pd(fromLatitude, _mm256_mul_pd(t, deltaLatitude));
+        auto dLon = _mm256_sub_pd(fromLongitude, _mm256_mul_pd(t, deltaLongitude));
+        auto offset = _mm256_add_pd(_mm256_mul_pd(dLat, dLat), _mm256_mul_pd(cosineSquared, _mm256_mul_pd(dLon, dLon)));
+
+        auto far = _mm256_or_pd(
+            _mm256_or_pd(_mm256_cmp_pd(_mm256_and_pd(dLat, absolute), latitudeLimit, _CMP_GT_OQ),
+                         _mm256_cmp_pd(_mm256_and_pd(dLon, absolute), longitudeLimit, _CMP_GT_OQ)),
+            _mm256_cmp_pd(offset, ellipse, _CMP_GT_OQ));
+        _mm256_storeu_pd(distances.data() + i, infinite);
+
+        auto candidates = ~_mm256_movemask_pd(far) & 0xf;
+        while (candidates) {
+            auto lane = static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(candidates)));
+            candidates &= candidates - 1;
+
+            auto distance = GeoKernels::distance(frame, latitudes[i + lane], longitudes[i + lane]);
+            if (distance <= frame.radius) {
+                distances[i + lane] = distance;
+                ++within;
+            }
+        }
+    }
+    return within + corridorDistancesScalar(frame, latitudes, longitudes, distances, i);
+}
+
+__attribute__((target("avx2")))
+bool allWithinAvx2(
+    const GeoKernels::SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes
+) {
+    auto startLatitude = _mm256_set1_pd(frame.start.latitude);
+    auto startLongitude = _mm256_set1_pd(frame.start.longitude);
+    auto deltaLatitude = _mm256_set1_pd(frame.deltaLatitude);
+    auto deltaLongitude = _mm256_set1_pd(frame.deltaLongitude);
+    auto inverseLength = _mm256_set1_pd(frame.inverseLengthSquared);
+    auto latitudeLimit = _mm256_set1_pd(frame.latitudeLimit);
+    auto longitudeLimit = _mm256_set1_pd(frame.longitudeLimit);
+    auto cosineSquared = _mm256_set1_pd(frame.cosineSquared);
+    auto ellipse = _mm256_set1_pd(frame.ellipse);
+    auto innerCosineSquared = _mm256_set1_pd(frame.innerCosineSquared);
+    auto innerEllipse = _mm256_set1_pd(frame.innerEllipse);
+    auto zero = _mm256_setzero_pd();
+    auto one = _mm256_set1_pd(1.0);
+    auto absolute = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+
+    size_t i = 0;
+    for (; i + 4 <= latitudes.size(); i += 4) {
+        auto latitude = _mm256_loadu_pd(latitudes.data() + i);
+        auto longitude = _mm256_loadu_pd(longitudes.data() + i);
+
+        auto fromLatitude = _mm256_sub_pd(latitude, startLatitude);
+        auto fromLongitude = _mm256_sub_pd(longitude, startLongitude);
+        auto t = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(fromLatitude, deltaLatitude),
+                                             _mm256_mul_pd(fromLongitude, deltaLongitude)), inverseLength);
+        t = _mm256_min_pd(_mm256_max_pd(t, zero), one);
+
+        auto dLat = _mm256_sub_pd(fromLatitude, _mm256_mul_pd(t, deltaLatitude));
+        auto dLon = _mm256_sub_pd(fromLongitude, _mm256_mul_pd(t, deltaLongitude));
+        auto dLatSquared = _mm256_mul_pd(dLat, dLat);
+        auto dLonSquared = _mm256_mul_pd(dLon, dLon);
+
+        auto far = _mm256_or_pd(
+            _mm256_or_pd(_mm256_cmp_pd(_mm256_and_pd(dLat, absolute), latitudeLimit, _CMP_GT_OQ),
+                         _mm256_cmp_pd(_mm256_and_pd(dLon, absolute), longitudeLimit, _CMP_GT_OQ)),
+            _mm256_cmp_pd(_mm256_add_pd(dLatSquared, _mm256_mul_pd(cosineSquared, dLonSquared)), ellipse, _CMP_GT_OQ));
+        if (_mm256_movemask_pd(far)) return false;
+
+        auto near = _mm256_cmp_pd(_mm256_add_pd(dLatSquared, _mm256_mul_pd(innerCosineSquared, dLonSquared)),
+                                  innerEllipse, _CMP_LE_OQ);
+        auto candidates = ~_mm256_movemask_pd(near) & 0xf;
+        while (candidates) {
+            auto lane = static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(candidates)));
+            candidates &= candidates - 1;
+            if (!(GeoKernels::distance(frame, latitudes[i + lane], longitudes[i + lane]) <= frame.radius)) {
+                return false;
+            }
+        }
+    }
+    return allWithinScalar(frame, latitudes, longitudes, i);
+}
+
+bool cpuSupportsAvx2() {
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+bool cpuSupportsAvx2() {
+    return false;
+}
+
+#endif
+
+// Falls back to scalar when AVX2 is requested but not available
+bool useAvx2(GeoKernels::Isa isa) {
+    return isa == GeoKernels::Isa::Avx2 && GeoKernels::isa() == GeoKernels::Isa::Avx2;
+}
+
+} // namespace
+
+GeoKernels::Isa GeoKernels::isa() {
+    static const Isa best = cpuSupportsAvx2() ? Isa::Avx2 : Isa::Scalar;
+    return best;
+}
+
+GeoKernels::SegmentFrame GeoKernels::frame(const Waypoint& start, const Waypoint& end, double radius) {
+    SegmentFrame frame;
+    frame.start = anchor(start.latitude, start.longitude);
+    frame.end = anchor(end.latitude, end.longitude);
+    frame.deltaLatitude = end.latitude - start.latitude;
+    frame.deltaLongitude = end.longitude - start.longitude;
+    frame.lengthSquared = frame.deltaLatitude * frame.deltaLatitude + frame.deltaLongitude * frame.deltaLongitude;
+    frame.inverseLengthSquared = frame.lengthSquared > 0 ? 1.0 / frame.lengthSquared : 0.0;
+    frame.radius = radius;
+
+    // A great-circle distance d bounds |dLat| <= d / R. Both the point and
+    // its projection are then at most maxLatitude from the equator, so
+    // hav(d / R) >= hav(dLat) + cosine^2 * hav(dLon), which bounds |dLon|
+    // and, with sin(y) >= y * (1 - y^2 / 6), gives the ellipse.
+    double angle = radius / EARTH_RADIUS;
+    if (angle >= M_PI) {
+        frame.latitudeLimit = frame.longitudeLimit = frame.ellipse = frame.innerEllipse = INFINITE;
+        return frame;
+    }
+    double latitudeLimit = angle * DEGREES_PER_RADIAN;
+    double maxLatitude = std::max(std::abs(start.latitude), std::abs(end.latitude)) + latitudeLimit;
+    double cosine = maxLatitude >= 90 ? 0.0 : std::cos(toRadians(maxLatitude));
+    double halfChord = std::sin(angle / 2);
+
+    frame.latitudeLimit = latitudeLimit * SLACK;
+
+    // Conversely sin(y) <= y: a point within the latitude limit is within
+    // the corridor if its offset lies inside the ellipse taken at the
+    // latitude nearest the equator
+    double minLatitude = start.latitude * end.latitude <= 0
+        ? 0.0 : std::min(std::abs(start.latitude), std::abs(end.latitude));
+    double innerCosine = std::cos(toRadians(std::max(0.0, minLatitude - frame.latitudeLimit)));
+    frame.innerCosineSquared = innerCosine * innerCosine;
+    frame.innerEllipse = 4 * halfChord * halfChord * DEGREES_PER_RADIAN * DEGREES_PER_RADIAN / SLACK;
+    frame.cosineSquared = cosine * cosine;
+    if (halfChord >= cosine) {
+        frame.longitudeLimit = frame.ellipse = INFINITE;
+        return frame;
+    }
+    double longitudeLimit = 2 * std::asin(halfChord / cosine);
+    frame.longitudeLimit = longitudeLimit * DEGREES_PER_RADIAN * SLACK;
+
+    double half = std::max(angle, longitudeLimit) / 2;
+    double shrink = 1 - half * half / 6;
+    frame.ellipse = 4 * halfChord * halfChord / (shrink * shrink) * DEGREES_PER_RADIAN * DEGREES_PER_RADIAN * SLACK;
+    return frame;
+}
+
+double GeoKernels::distance(const SegmentFrame& frame, double latitude, double longitude) {
+    // If segment is actually a point
+    if (frame.lengthSquared == 0) {
+        return haversine(latitude, longitude, frame.start);
+    }
+
+    // Calculate projection
+    double t = ((latitude - frame.start.latitude) * frame.deltaLatitude +
+                (longitude - frame.start.longitude) * frame.deltaLongitude) / frame.lengthSquared;
+    if (t < 0) {
+        return haversine(latitude, longitude, frame.start);
+    } else if (t > 1) {
+        return haversine(latitude, longitude, frame.end);
+    }
+
+    // Point projects onto segment
+    double projectedLatitude = frame.start.latitude + t * frame.deltaLatitude;
+    double projectedLongitude = frame.start.longitude + t * frame.deltaLongitude;
+    return haversine(latitude, longitude, anchor(projectedLatitude, projectedLongitude));
+}
+
+double GeoKernels::project(const SegmentFrame& frame, double latitude, double longitude) {
+    if (frame.lengthSquared == 0) {
+        return 0.0;
+    }
+    double t = ((latitude - frame.start.latitude) * frame.deltaLatitude +
+                (longitude - frame.start.longitude) * frame.deltaLongitude) / frame.lengthSquared;
+    return std::clamp(t, 0.0, 1.0);
+}
+
+size_t GeoKernels::corridorDistances(
+    const SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes,
+    std::span<double> distances,
+    Isa isa
+) {
+#ifdef FUEL_PRICE_AVX2
+    if (useAvx2(isa)) return corridorDistancesAvx2(frame, latitudes, longitudes, distances);
+#endif
+    (void)isa;
+    return corridorDistancesScalar(frame, latitudes, longitudes, distances, 0);
+}
+
+bool GeoKernels::allWithin(
+    const SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes,
+    Isa isa
+) {
+#ifdef FUEL_PRICE_AVX2
+    if (useAvx2(isa)) return allWithinAvx2(frame, latitudes, longitudes);
+#endif
+    (void)isa;
+    return allWithinScalar(frame, latitudes, longitudes, 0);
+}
+
+} // namespace utils
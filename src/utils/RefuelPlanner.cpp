@@ -0,0 +1,133 @@
+#include "utils/RefuelPlanner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace utils {
+
+RefuelPlanner::Plan RefuelPlanner::plan(const Trip& trip, const std::vector<Candidate>& candidates) {
+    if (!(trip.tankCapacity > 0) || !(trip.consumption > 0) || !(trip.routeLength >= 0)) {
+        throw std::invalid_argument(fmt::format("Invalid trip: {} km, {} l tank, {} l/100 km",
+                                                trip.routeLength, trip.tankCapacity, trip.consumption));
+    }
+    if (!(trip.fuel >= 0 && trip.fuel <= trip.tankCapacity) ||
+        !(trip.reserve >= 0 && trip.arrivalFuel <= trip.tankCapacity)) {
+        throw std::invalid_argument(fmt::format("Invalid fuel levels: {} l, {} l reserve, {} l on arrival, {} l tank",
+                                                trip.fuel, trip.reserve, trip.arrivalFuel, trip.tankCapacity));
+    }
+
+    // Fuel is counted in km it lasts for, above the reserve. A tank that is
+    // already below the reserve has nothing to drive on until it is filled
+    // up; the reserve is lowered to what is in it, so later stops keep at
+    // least that much.
+    double kmPerLitre = 100.0 / trip.consumption;
+    double reserve = std::min(trip.reserve, trip.fuel);
+    double range = (trip.tankCapacity - reserve) * kmPerLitre;
+    double onBoard = (trip.fuel - reserve) * kmPerLitre;
+
+    // Fuel wanted on arrival is bought as if the route went on
+    double end = trip.routeLength + std::max(0.0, trip.arrivalFuel - reserve) * kmPerLitre;
+
+    struct Option {
+        size_t candidate;
+        double until;  // last km its fuel can be used for
+        double rank;
+    };
+    std::vector<Option> options;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const auto& candidate = candidates[i];
+        double detour = std::max(0.0, candidate.detour);
+        if (!(candidate.price > 0) || !std::isfinite(candidate.price) ||
+            !(candidate.position >= 0 && candidate.position <= trip.routeLength) || !(detour < range)) {
+            continue;
+        }
+        options.push_back({i, candidate.position + range - detour, candidate.price * (1 + detour / range)});
+    }
+    std::sort(options.begin(), options.end(), [&](const Option& a, const Option& b) {
+        return candidates[a.candidate].position < candidates[b.candidate].position;
+    });
+
+    // Sweep the route, fuelling each stretch from the best station that can
+    // reach it; stations join as they are passed and drop out once out of
+    // range behind
+    auto worse = [&](size_t a, size_t b) {
+        return options[a].rank > options[b].rank ||
+               (options[a].rank == options[b].rank && options[a].candidate > options[b].candidate);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(worse)> reachable(worse);
+    std::vector<double> covered(options.size(), 0.0);  // km of route fuel bought at each option
+
+    double position = std::min(onBoard, end);
+    size_t next = 0;
+    while (position < end) {
+        while (next < options.size() && candidates[options[next].candidate].position <= position) {
+            reachable.push(next++);
+        }
+        while (!reachable.empty() && options[reachable.top()].until <= position) {
+            reachable.pop();
+        }
+        if (reachable.empty()) break;
+
+        auto best = reachable.top();
+        double until = std::min(end, options[best].until);
+        if (next < options.size()) {
+            until = std::min(until, candidates[options[next].candidate].position);
+        }
+        covered[best] += until - position;
+        position = until;
+    }
+
+    Plan plan;
+    plan.feasible = position >= end;
+    plan.reach = std::min(position, trip.routeLength);
+
+    // Options are in route order, so the tank can be followed along
+    double bought = 0.0;  // litres of route fuel so far
+    for (size_t i = 0; i < options.size(); ++i) {
+        if (covered[i] <= 0) continue;
+
+        const auto& candidate = candidates[options[i].candidate];
+        double routeLitres = covered[i] / kmPerLitre;
+        Stop stop;
+        stop.stationId = candidate.stationId;
+        stop.position = candidate.position;
+        stop.price = candidate.price;
+        stop.litres = routeLitres + std::max(0.0, candidate.detour) / kmPerLitre;
+        stop.cost = stop.litres * stop.price;
+        stop.arrivalFuel = trip.fuel + bought - candidate.position / kmPerLitre;
+        bought += routeLitres;
+
+        plan.litres += stop.litres;
+        plan.cost += stop.cost;
+        plan.stops.push_back(std::move(stop));
+    }
+    return plan;
+}
+
+std::optional<double> RefuelPlanner::price(const models::FuelStation& station, std::string_view fuelType) {
+    if (!station.isOpen) return std::nullopt;
+    for (const auto& price : station.prices) {
+        if (price.fuelType == fuelType && price.price > 0) {
+            return price.price;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<RefuelPlanner::Candidate> RefuelPlanner::candidates(
+    std::span<const RouteStation> stations,
+    std::string_view fuelType
+) {
+    std::vector<Candidate> result;
+    result.reserve(stations.size());
+    for (const auto& located : stations) {
+        if (auto stationPrice = price(located.station, fuelType)) {
+            result.push_back({located.station.id, located.chainage, located.detour, *stationPrice});
+        }
+    }
+    return result;
+}
+
+} // namespace utils
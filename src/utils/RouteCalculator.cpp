@@ -1,60 +1,238 @@
 #include "utils/RouteCalculator.hpp"
 #include <algorithm>
+#include <tuple>
+#include "utils/GeoKernels.hpp"
+#include "utils/StationGrid.hpp"
 
 namespace utils {
 
-std::vector<models::FuelStation> RouteCalculator::findStationsAlongRoute(
-    const std::vector<Waypoint>& waypoints,
-    const std::vector<models::FuelStation>& allStations,
+namespace {
+
+struct SegmentMatch {
+    uint32_t slot;
+    size_t segment;
+    double offset;  // km from the segment
+};
+
+// The closest segment of each station within the corridor. The cells near
+// a segment are distinct and a station is in one cell, so each candidate
+// is gathered once per segment and measured in a batch.
+std::vector<SegmentMatch> closestSegments(
+    const std::vector<RouteSegment>& segments,
+    const StationGrid& stations,
     double corridorWidth
 ) {
-    if (waypoints.size() < 2) {
-        return {};
-    }
+    std::vector<SegmentMatch> matches;
+    std::vector<uint32_t> matched(stations.slotCount(), 0);  // index in matches + 1
+    std::vector<uint32_t> candidates;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> distances;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const auto& segment = segments[i];
+        candidates.clear();
+        latitudes.clear();
+        longitudes.clear();
+        for (const auto* cell : stations.cellsNear(segment.start, segment.end, corridorWidth)) {
+            candidates.insert(candidates.end(), cell->slots.begin(), cell->slots.end());
+            latitudes.insert(latitudes.end(), cell->latitudes.begin(), cell->latitudes.end());
+            longitudes.insert(longitudes.end(), cell->longitudes.begin(), cell->longitudes.end());
+        }
+        if (candidates.empty()) continue;
 
-    // Create route segments
-    auto segments = createRouteSegments(waypoints);
-    
-    // Find stations within corridor
-    std::vector<models::FuelStation> result;
-    for (const auto& station : allStations) {
-        // Check each segment
-        for (const auto& segment : segments) {
-            if (isPointInCorridor(
-                segment.start, segment.end,
-                station.location.latitude,
-                station.location.longitude,
-                corridorWidth
-            )) {
-                // Calculate distance to route
-                double distanceToRoute = pointToSegmentDistance(
-                    station.location.latitude,
-                    station.location.longitude,
-                    segment.start.latitude,
-                    segment.start.longitude,
-                    segment.end.latitude,
-                    segment.end.longitude
-                );
-                
-                // Add distance to station object
-                auto stationCopy = station;
-                stationCopy.distance = distanceToRoute;
-                result.push_back(stationCopy);
-                break;  // Station is already added, skip other segments
+        distances.resize(candidates.size());
+        auto frame = GeoKernels::frame(segment.start, segment.end, corridorWidth);
+        if (GeoKernels::corridorDistances(frame, latitudes, longitudes, distances) == 0) continue;
+
+        // A tie keeps the earlier segment
+        for (size_t j = 0; j < candidates.size(); ++j) {
+            if (!(distances[j] <= corridorWidth)) continue;
+
+            auto& index = matched[candidates[j]];
+            if (index == 0) {
+                matches.push_back({candidates[j], i, distances[j]});
+                index = static_cast<uint32_t>(matches.size());
+            } else if (distances[j] < matches[index - 1].offset) {
+                matches[index - 1].segment = i;
+                matches[index - 1].offset = distances[j];
             }
         }
     }
+    return matches;
+}
+
+// A throwaway index of a station list, keyed by position rather than by
+// ID so that stations sharing an ID, or without one, are all kept. Only
+// the coordinates are copied; slots are the input positions, which breaks
+// distance ties as before.
+StationGrid indexByPosition(const std::vector<models::FuelStation>& stations) {
+    StationGrid grid;
+    for (const auto& station : stations) {
+        grid.insert(station.location.latitude, station.location.longitude);
+    }
+    return grid;
+}
+
+// Stations within the corridor, closest to the route first. `stationOf`
+// maps a slot of `grid` to the station it stands for.
+template <typename StationOf>
+std::vector<models::FuelStation> nearestFirst(
+    const std::vector<RouteSegment>& segments,
+    const StationGrid& grid,
+    double corridorWidth,
+    StationOf stationOf
+) {
+    auto matches = closestSegments(segments, grid, corridorWidth);
     
     // Sort by distance from route
-    std::sort(result.begin(), result.end(),
-        [](const auto& a, const auto& b) {
-            return a.distance < b.distance;
-        }
-    );
+    std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.offset, a.slot) < std::tie(b.offset, b.slot);
+    });
     
+    std::vector<models::FuelStation> result;
+    result.reserve(matches.size());
+    for (const auto& match : matches) {
+        auto stationCopy = stationOf(match.slot);
+        stationCopy.distance = match.offset;
+        result.push_back(std::move(stationCopy));
+    }
     return result;
 }
 
+// Stations within the corridor ordered along the route, see nearestFirst().
+// A detour is the offset there and back, times `roadFactor`.
+template <typename StationOf>
+std::vector<RouteStation> alongRoute(
+    const std::vector<RouteSegment>& segments,
+    const StationGrid& grid,
+    double corridorWidth,
+    double roadFactor,
+    StationOf stationOf
+) {
+    auto matches = closestSegments(segments, grid, corridorWidth);
+
+    // Chainage of each waypoint
+    std::vector<double> starts(segments.size());
+    for (size_t i = 1; i < segments.size(); ++i) {
+        starts[i] = starts[i - 1] + segments[i - 1].distance;
+    }
+
+    std::vector<std::pair<size_t, RouteStation>> located;  // slot, station
+    located.reserve(matches.size());
+    for (const auto& match : matches) {
+        const auto& segment = segments[match.segment];
+        const auto& station = stationOf(match.slot);
+
+        // Distance along the segment to the projection
+        auto frame = GeoKernels::frame(segment.start, segment.end, 0.0);
+        auto t = GeoKernels::project(frame, station.location.latitude, station.location.longitude);
+        double along = RouteCalculator::calculateDistance(
+            segment.start.latitude, segment.start.longitude,
+            segment.start.latitude + t * frame.deltaLatitude,
+            segment.start.longitude + t * frame.deltaLongitude
+        );
+
+        RouteStation routeStation{
+            .station = station,
+            .chainage = starts[match.segment] + along,
+            .segment = match.segment,
+            .offset = match.offset,
+            .detour = 2 * match.offset * roadFactor
+        };
+        routeStation.station.distance = match.offset;
+        located.emplace_back(match.slot, std::move(routeStation));
+    }
+
+    // Ordered along the route
+    std::sort(located.begin(), located.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.second.chainage, a.second.offset, a.first) <
+               std::tie(b.second.chainage, b.second.offset, b.first);
+    });
+
+    std::vector<RouteStation> result;
+    result.reserve(located.size());
+    for (auto& [slot, routeStation] : located) {
+        result.push_back(std::move(routeStation));
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<models::FuelStation> RouteCalculator::findStationsAlongRoute(
+    const std::vector<Waypoint>& waypoints,
+    const std::vector<models::FuelStation>& allStations,
+    double corridorWidth
+) {
+    if (waypoints.size() < 2) {
+        return {};
+    }
+
+    // A throwaway index still beats testing every station against every
+    // segment
+    return nearestFirst(createRouteSegments(waypoints), indexByPosition(allStations), corridorWidth,
+                        [&](uint32_t slot) -> const models::FuelStation& { return allStations[slot]; });
+}
+
+std::vector<models::FuelStation> RouteCalculator::findStationsAlongRoute(
+    const std::vector<Waypoint>& waypoints,
+    const StationGrid& stations,
+    double corridorWidth
+) {
+    if (waypoints.size() < 2) {
+        return {};
+    }
+
+    return nearestFirst(createRouteSegments(waypoints), stations, corridorWidth,
+                        [&](uint32_t slot) -> const models::FuelStation& { return stations.station(slot); });
+}
+
+std::vector<RouteStation> RouteCalculator::locateStationsAlongRoute(
+    const std::vector<Waypoint>& waypoints,
+    const std::vector<models::FuelStation>& allStations,
+    double corridorWidth
+) {
+    if (waypoints.size() < 2) {
+        return {};
+    }
+
+    return alongRoute(createRouteSegments(waypoints), indexByPosition(allStations), corridorWidth, ROAD_FACTOR,
+                      [&](uint32_t slot) -> const models::FuelStation& { return allStations[slot]; });
+}
+
+std::vector<RouteStation> RouteCalculator::locateStationsAlongRoute(
+    const std::vector<Waypoint>& waypoints,
+    const StationGrid& stations,
+    double corridorWidth
+) {
+    if (waypoints.size() < 2) {
+        return {};
+    }
+
+    return alongRoute(createRouteSegments(waypoints), stations, corridorWidth, ROAD_FACTOR,
+                      [&](uint32_t slot) -> const models::FuelStation& { return stations.station(slot); });
+}
+
+std::span<const RouteStation> RouteCalculator::stationsAhead(
+    std::span<const RouteStation> stations,
+    double chainage
+) {
+    auto first = std::lower_bound(stations.begin(), stations.end(), chainage,
+                                  [](const RouteStation& station, double at) { return station.chainage < at; });
+    return stations.subspan(static_cast<size_t>(first - stations.begin()));
+}
+
+double RouteCalculator::routeLength(const std::vector<Waypoint>& waypoints) {
+    double length = 0.0;
+    for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+        length += calculateDistance(
+            waypoints[i].latitude, waypoints[i].longitude,
+            waypoints[i+1].latitude, waypoints[i+1].longitude
+        );
+    }
+    return length;
+}
+
 double RouteCalculator::calculateDistance(
     double lat1, double lon1,
     double lat2, double lon2
@@ -118,30 +296,8 @@ double RouteCalculator::pointToSegmentDistance(
     double x1, double y1,
     double x2, double y2
 ) {
-    // Convert to simpler coordinate system for calculation
-    double dx = x2 - x1;
-    double dy = y2 - y1;
-    
-    // If segment is actually a point
-    if (dx == 0 && dy == 0) {
-        return calculateDistance(px, py, x1, y1);
-    }
-    
-    // Calculate projection
-    double t = ((px - x1) * dx + (py - y1) * dy) / (dx * dx + dy * dy);
-    
-    if (t < 0) {
-        // Point is beyond start of segment
-        return calculateDistance(px, py, x1, y1);
-    } else if (t > 1) {
-        // Point is beyond end of segment
-        return calculateDistance(px, py, x2, y2);
-    }
-    
-    // Point projects onto segment
-    double projX = x1 + t * dx;
-    double projY = y1 + t * dy;
-    return calculateDistance(px, py, projX, projY);
+    // The frame keeps the arithmetic of the batched corridor queries
+    return GeoKernels::distance(GeoKernels::frame({x1, y1}, {x2, y2}, 0.0), px, py);
 }
 
 } // namespace utils 
\ No newline at end of file
@@ -0,0 +1,401 @@
+#include "utils/RouteImporter.hpp"
+#include "storage/MappedFile.hpp"
+#include "utils/GeoKernels.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <fmt/format.h>
+
+namespace utils {
+
+namespace {
+
+using json = nlohmann::json;
+
+bool parseNumber(std::string_view text, double& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Finds the next <name ...> or <name .../> tag and returns its attributes
+bool nextTag(std::string_view text, std::string_view name, size_t& position, std::string_view& attributes) {
+    while ((position = text.find(name, position)) != std::string_view::npos) {
+        auto start = position + name.size();
+        if (start < text.size() && (isSpace(text[start]) || text[start] == '>' || text[start] == '/')) {
+            auto end = text.find('>', start);
+            if (end == std::string_view::npos) {
+                throw std::runtime_error(fmt::format("Unterminated GPX tag at byte {}", position));
+            }
+            attributes = text.substr(start, end - start);
+            position = end;
+            return true;
+        }
+        position = start;
+    }
+    return false;
+}
+
+// lat="..." and lon="..." in either order and with either quote
+bool readCoordinates(std::string_view attributes, Waypoint& point) {
+    bool hasLatitude = false;
+    bool hasLongitude = false;
+    size_t i = 0;
+    while (i < attributes.size()) {
+        while (i < attributes.size() && isSpace(attributes[i])) ++i;
+        auto nameStart = i;
+        while (i < attributes.size() && attributes[i] != '=' && !isSpace(attributes[i])) ++i;
+        auto name = attributes.substr(nameStart, i - nameStart);
+        while (i < attributes.size() && isSpace(attributes[i])) ++i;
+        if (i >= attributes.size() || attributes[i] != '=') break;
+        ++i;
+        while (i < attributes.size() && isSpace(attributes[i])) ++i;
+        if (i >= attributes.size() || (attributes[i] != '"' && attributes[i] != '\'')) return false;
+
+        auto quote = attributes[i++];
+        auto valueEnd = attributes.find(quote, i);
+        if (valueEnd == std::string_view::npos) return false;
+        auto value = attributes.substr(i, valueEnd - i);
+        i = valueEnd + 1;
+
+        if (name == "lat") {
+            hasLatitude = parseNumber(value, point.latitude);
+            if (!hasLatitude) return false;
+        } else if (name == "lon") {
+            hasLongitude = parseNumber(value, point.longitude);
+            if (!hasLongitude) return false;
+        }
+    }
+    return hasLatitude && hasLongitude;
+}
+
+size_t readGpx(std::string_view text, const RouteImporter::PointSink& sink) {
+    // A file with a recorded track may also carry the planned route
+    std::string_view name = text.find("<trkpt") != std::string_view::npos ? "<trkpt" : "<rtept";
+
+    size_t count = 0;
+    size_t position = 0;
+    std::string_view attributes;
+    while (nextTag(text, name, position, attributes)) {
+        Waypoint point{};
+        if (!readCoordinates(attributes, point)) {
+            throw std::runtime_error(fmt::format("Invalid GPX point at byte {}", position));
+        }
+        sink(point);
+        ++count;
+    }
+    return count;
+}
+
+// Positions are collected from the "coordinates" of each object. The type
+// of the object may come after them, so they wait in `pending` until it is
+// known to be a LineString or MultiLineString.
+class GeoJsonHandler : public nlohmann::json_sax<json> {
+public:
+    explicit GeoJsonHandler(const RouteImporter::PointSink& sink) : sink(sink) {}
+
+    size_t count = 0;
+    std::string error;
+
+    bool null() override {
+        return true;
+    }
+
+    bool boolean(bool) override {
+        return true;
+    }
+
+    bool number_integer(number_integer_t val) override {
+        return number(static_cast<double>(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        return number(static_cast<double>(val));
+    }
+
+    bool number_float(number_float_t val, const string_t&) override {
+        return number(val);
+    }
+
+    bool string(string_t& val) override {
+        if (arrays == 0 && !containers.empty() && containers.back() == '{' && currentKey == "type") {
+            auto& object = objects.back();
+            object.geometry = val == "LineString" || val == "MultiLineString" ? Geometry::Linear : Geometry::Other;
+            if (object.geometry == Geometry::Linear) {
+                for (size_t i = object.first; i < pending.size(); ++i) {
+                    emit(pending[i]);
+                }
+            }
+            pending.resize(object.first);
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override {
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        containers.push_back('{');
+        objects.push_back({Geometry::Unknown, pending.size()});
+        return true;
+    }
+
+    bool end_object() override {
+        // Coordinates of an object without a type are not a route
+        pending.resize(objects.back().first);
+        objects.pop_back();
+        containers.pop_back();
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (arrays > 0 || (!containers.empty() && containers.back() == '{' && currentKey == "coordinates")) {
+            ++arrays;
+            numbers = 0;
+        }
+        containers.push_back('[');
+        return true;
+    }
+
+    bool end_array() override {
+        containers.pop_back();
+        if (arrays == 0) return true;
+
+        // [longitude, latitude] or [longitude, latitude, altitude]
+        if (numbers >= 2) {
+            auto geometry = objects.back().geometry;
+            if (geometry == Geometry::Linear) {
+                emit(coordinate);
+            } else if (geometry == Geometry::Unknown) {
+                pending.push_back(coordinate);
+            }
+        }
+        numbers = 0;
+        --arrays;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        currentKey = std::move(val);
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override {
+        error = fmt::format("Failed to parse GeoJSON at byte {}: {}", position, ex.what());
+        return false;
+    }
+
+private:
+    enum class Geometry {
+        Unknown,
+        Linear,
+        Other
+    };
+
+    struct Object {
+        Geometry geometry;
+        size_t first;  // of its positions in `pending`
+    };
+
+    bool number(double val) {
+        if (arrays == 0) return true;
+        if (numbers == 0) coordinate.longitude = val;
+        else if (numbers == 1) coordinate.latitude = val;
+        ++numbers;
+        return true;
+    }
+
+    void emit(const Waypoint& point) {
+        sink(point);
+        ++count;
+    }
+
+    const RouteImporter::PointSink& sink;
+    std::vector<char> containers;
+    std::vector<Object> objects;
+    std::vector<Waypoint> pending;
+    std::string currentKey;
+    size_t arrays = 0;  // depth inside "coordinates"
+    size_t numbers = 0;
+    Waypoint coordinate{};
+};
+
+size_t readGeoJson(std::string_view text, const RouteImporter::PointSink& sink) {
+    GeoJsonHandler handler(sink);
+    if (!json::sax_parse(text.begin(), text.end(), &handler)) {
+        throw std::runtime_error(handler.error.empty() ? "Failed to parse GeoJSON" : handler.error);
+    }
+    return handler.count;
+}
+
+// https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+bool nextValue(std::string_view text, size_t& position, int64_t& value) {
+    uint64_t result = 0;
+    int shift = 0;
+    while (position < text.size()) {
+        auto chunk = text[position++] - 63;
+        if (chunk < 0 || chunk > 63 || shift > 60) return false;
+
+        result |= static_cast<uint64_t>(chunk & 0x1f) << shift;
+        shift += 5;
+        if (chunk < 0x20) {
+            value = (result & 1) ? ~static_cast<int64_t>(result >> 1) : static_cast<int64_t>(result >> 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t readPolyline(std::string_view text, const RouteImporter::PointSink& sink, int precision) {
+    if (precision < 0 || precision > 9) {
+        throw std::invalid_argument(fmt::format("Invalid polyline precision: {}", precision));
+    }
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+
+    double scale = std::pow(10.0, precision);
+    int64_t latitude = 0;
+    int64_t longitude = 0;
+    size_t count = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        int64_t deltaLatitude = 0;
+        int64_t deltaLongitude = 0;
+        auto start = position;
+        if (!nextValue(text, position, deltaLatitude) || !nextValue(text, position, deltaLongitude)) {
+            throw std::runtime_error(fmt::format("Invalid encoded polyline at byte {}", start));
+        }
+        latitude += deltaLatitude;
+        longitude += deltaLongitude;
+        sink({static_cast<double>(latitude) / scale, static_cast<double>(longitude) / scale});
+        ++count;
+    }
+    return count;
+}
+
+// The point between first and last that is farthest from their segment,
+// measured on a plane scaled by the cosine of the latitude. Only used to
+// pick where to split, so it need not be exact.
+size_t farthestPoint(
+    const GeoKernels::SegmentFrame& frame,
+    std::span<const double> latitudes,
+    std::span<const double> longitudes,
+    size_t first,
+    size_t last
+) {
+    double cosine = (frame.start.cosine + frame.end.cosine) / 2;
+    double cosineSquared = cosine * cosine;
+
+    size_t farthest = first + 1;
+    double maxOffset = -1.0;
+    for (size_t i = first + 1; i < last; ++i) {
+        double fromLatitude = latitudes[i] - frame.start.latitude;
+        double fromLongitude = longitudes[i] - frame.start.longitude;
+        double t = (fromLatitude * frame.deltaLatitude + fromLongitude * frame.deltaLongitude) * frame.inverseLengthSquared;
+        t = std::clamp(t, 0.0, 1.0);
+        double dLat = fromLatitude - t * frame.deltaLatitude;
+        double dLon = fromLongitude - t * frame.deltaLongitude;
+        double offset = dLat * dLat + cosineSquared * dLon * dLon;
+        if (offset > maxOffset) {
+            maxOffset = offset;
+            farthest = i;
+        }
+    }
+    return farthest;
+}
+
+} // namespace
+
+size_t RouteImporter::read(std::string_view text, Format format, const PointSink& sink, int polylinePrecision) {
+    switch (format) {
+        case Format::Gpx: return readGpx(text, sink);
+        case Format::GeoJson: return readGeoJson(text, sink);
+        case Format::Polyline: return readPolyline(text, sink, polylinePrecision);
+    }
+    return 0;
+}
+
+std::vector<Waypoint> RouteImporter::import(std::string_view text, Format format) {
+    return import(text, format, Options{});
+}
+
+std::vector<Waypoint> RouteImporter::import(std::string_view text, Format format, const Options& options) {
+    std::vector<Waypoint> points;
+    read(text, format, [&](const Waypoint& point) { points.push_back(point); }, options.polylinePrecision);
+    if (options.tolerance <= 0) {
+        return points;
+    }
+    return simplify(points, options.tolerance);
+}
+
+std::vector<Waypoint> RouteImporter::load(const std::filesystem::path& file) {
+    return load(file, Options{});
+}
+
+std::vector<Waypoint> RouteImporter::load(const std::filesystem::path& file, const Options& options) {
+    auto extension = file.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    auto format = extension == ".gpx" ? Format::Gpx
+                  : extension == ".json" || extension == ".geojson" ? Format::GeoJson : Format::Polyline;
+
+    storage::MappedFile mapped(file);
+    return import(mapped.data(), format, options);
+}
+
+std::vector<Waypoint> RouteImporter::simplify(std::span<const Waypoint> points, double tolerance) {
+    if (points.size() <= 2 || !(tolerance > 0)) {
+        return {points.begin(), points.end()};
+    }
+
+    std::vector<double> latitudes(points.size());
+    std::vector<double> longitudes(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        latitudes[i] = points[i].latitude;
+        longitudes[i] = points[i].longitude;
+    }
+
+    // A range is kept as one segment once every point in it is within the
+    // tolerance. The farthest point is checked first since it usually
+    // decides; only then are the others checked, in one batch.
+    std::vector<uint8_t> keep(points.size(), 0);
+    keep.front() = keep.back() = 1;
+    std::vector<std::pair<size_t, size_t>> ranges = {{0, points.size() - 1}};
+    while (!ranges.empty()) {
+        auto [first, last] = ranges.back();
+        ranges.pop_back();
+        if (last - first < 2) continue;
+
+        auto frame = GeoKernels::frame(points[first], points[last], tolerance);
+        auto farthest = farthestPoint(frame, latitudes, longitudes, first, last);
+
+        if (GeoKernels::distance(frame, latitudes[farthest], longitudes[farthest]) <= tolerance) {
+            auto count = last - first - 1;
+            if (GeoKernels::allWithin(frame, std::span<const double>(latitudes).subspan(first + 1, count),
+                                      std::span<const double>(longitudes).subspan(first + 1, count))) {
+                continue;
+            }
+        }
+
+        keep[farthest] = 1;
+        ranges.emplace_back(first, farthest);
+        ranges.emplace_back(farthest, last);
+    }
+
+    std::vector<Waypoint> result;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (keep[i]) {
+            result.push_back(points[i]);
+        }
+    }
+    return result;
+}
+
+} // namespace utils
@@ -0,0 +1,230 @@
+#include "utils/StationGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_set>
+#include <fmt/format.h>
+
+namespace utils {
+
+namespace {
+
+constexpr double EARTH_RADIUS = 6371.0;
+constexpr double DEGREES_PER_RADIAN = 180.0 / M_PI;
+
+// Pieces a segment is split into at most, for degenerate inputs
+constexpr size_t MAX_PIECES = 4096;
+
+int32_t rowOf(uint64_t key) { return static_cast<int32_t>(key >> 32); }
+int32_t columnOf(uint64_t key) { return static_cast<int32_t>(key & 0xffffffff); }
+
+uint64_t makeKey(int64_t row, int64_t column) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(column);
+}
+
+} // namespace
+
+StationGrid::StationGrid(double cellDegrees) : cellDegrees(cellDegrees) {
+    if (!(cellDegrees > 0 && cellDegrees <= 180)) {
+        throw std::invalid_argument(fmt::format("Invalid grid cell size: {}", cellDegrees));
+    }
+}
+
+uint64_t StationGrid::cellKey(double latitude, double longitude) const {
+    return makeKey(static_cast<int64_t>(std::floor(latitude / cellDegrees)),
+                   static_cast<int64_t>(std::floor(longitude / cellDegrees)));
+}
+
+void StationGrid::upsert(const models::FuelStation& station) {
+    auto [it, inserted] = slots.try_emplace(station.id, 0);
+    if (inserted) {
+        it->second = allocateSlot();
+    } else {
+        removeFromCell(it->second);
+    }
+
+    auto slot = it->second;
+    entries[slot].station = station;
+    addToCell(slot, station.location.latitude, station.location.longitude);
+}
+
+uint32_t StationGrid::insert(double latitude, double longitude) {
+    auto slot = allocateSlot();
+    entries[slot].station.location.latitude = latitude;
+    entries[slot].station.location.longitude = longitude;
+    addToCell(slot, latitude, longitude);
+    return slot;
+}
+
+uint32_t StationGrid::allocateSlot() {
+    if (freeSlots.empty()) {
+        entries.emplace_back();
+        return static_cast<uint32_t>(entries.size() - 1);
+    }
+    auto slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+}
+
+void StationGrid::addToCell(uint32_t slot, double latitude, double longitude) {
+    auto key = cellKey(latitude, longitude);
+    auto& entry = entries[slot];
+    entry.cell = key;
+    entry.used = true;
+
+    auto& cell = cells[key];
+    cell.slots.push_back(slot);
+    cell.latitudes.push_back(latitude);
+    cell.longitudes.push_back(longitude);
+}
+
+bool StationGrid::erase(const std::string& stationId) {
+    auto it = slots.find(stationId);
+    if (it == slots.end()) return false;
+
+    auto slot = it->second;
+    removeFromCell(slot);
+    entries[slot] = Entry{};
+    freeSlots.push_back(slot);
+    slots.erase(it);
+    return true;
+}
+
+void StationGrid::update(const std::vector<models::FuelStation>& stations) {
+    std::unordered_set<std::string_view> current;
+    current.reserve(stations.size());
+    for (const auto& station : stations) {
+        current.insert(station.id);
+    }
+
+    std::vector<std::string> missing;
+    for (const auto& [id, slot] : slots) {
+        if (!current.count(id)) {
+            missing.push_back(id);
+        }
+    }
+    for (const auto& id : missing) {
+        erase(id);
+    }
+    for (const auto& station : stations) {
+        upsert(station);
+    }
+}
+
+const models::FuelStation* StationGrid::find(const std::string& stationId) const {
+    auto it = slots.find(stationId);
+    return it == slots.end() ? nullptr : &entries[it->second].station;
+}
+
+void StationGrid::removeFromCell(uint32_t slot) {
+    auto it = cells.find(entries[slot].cell);
+    if (it == cells.end()) return;
+
+    // Cells hold a handful of stations; swap the slot with the last one
+    auto& cell = it->second;
+    auto position = std::find(cell.slots.begin(), cell.slots.end(), slot) - cell.slots.begin();
+    if (position == static_cast<ptrdiff_t>(cell.slots.size())) return;
+
+    cell.slots[position] = cell.slots.back();
+    cell.latitudes[position] = cell.latitudes.back();
+    cell.longitudes[position] = cell.longitudes.back();
+    cell.slots.pop_back();
+    cell.latitudes.pop_back();
+    cell.longitudes.pop_back();
+    if (cell.slots.empty()) {
+        cells.erase(it);
+    }
+}
+
+void StationGrid::appendCells(const BoundingBox& box, std::vector<uint64_t>& keys) const {
+    auto firstRow = static_cast<int64_t>(std::floor(box.minLatitude / cellDegrees));
+    auto lastRow = static_cast<int64_t>(std::floor(box.maxLatitude / cellDegrees));
+    auto firstColumn = static_cast<int64_t>(std::floor(box.minLongitude / cellDegrees));
+    auto lastColumn = static_cast<int64_t>(std::floor(box.maxLongitude / cellDegrees));
+
+    // A box larger than the occupied cells is cheaper to filter than to walk
+    auto count = static_cast<double>(lastRow - firstRow + 1) * static_cast<double>(lastColumn - firstColumn + 1);
+    if (count > static_cast<double>(cells.size())) {
+        for (const auto& [key, cell] : cells) {
+            auto row = rowOf(key);
+            auto column = columnOf(key);
+            if (row >= firstRow && row <= lastRow && column >= firstColumn && column <= lastColumn) {
+                keys.push_back(key);
+            }
+        }
+        return;
+    }
+
+    for (auto row = firstRow; row <= lastRow; ++row) {
+        for (auto column = firstColumn; column <= lastColumn; ++column) {
+            keys.push_back(makeKey(row, column));
+        }
+    }
+}
+
+std::vector<const StationGrid::Cell*> StationGrid::cellsIn(const BoundingBox& box) const {
+    std::vector<uint64_t> keys;
+    appendCells(box, keys);
+
+    std::vector<const Cell*> result;
+    for (auto key : keys) {
+        auto it = cells.find(key);
+        if (it != cells.end()) {
+            result.push_back(&it->second);
+        }
+    }
+    return result;
+}
+
+std::vector<const StationGrid::Cell*> StationGrid::cellsNear(
+    const Waypoint& start,
+    const Waypoint& end,
+    double radius
+) const {
+    if (cells.empty()) return {};
+
+    // Great-circle distance d bounds |dLat| <= d / R and, with both points
+    // at most maxLatitude from the equator,
+    // sin(|dLon| / 2) <= sin(d / 2R) / cos(maxLatitude)
+    double latitudeMargin = radius / EARTH_RADIUS * DEGREES_PER_RADIAN;
+    double halfAngle = std::sin(std::min(M_PI / 2, radius / (2 * EARTH_RADIUS)));
+
+    double latitudeSpan = std::abs(end.latitude - start.latitude);
+    double longitudeSpan = std::abs(end.longitude - start.longitude);
+    auto pieces = static_cast<size_t>(std::ceil(std::max(latitudeSpan, longitudeSpan) / cellDegrees));
+    pieces = std::clamp<size_t>(pieces, 1, MAX_PIECES);
+
+    std::vector<uint64_t> keys;
+    for (size_t piece = 0; piece < pieces; ++piece) {
+        double t0 = static_cast<double>(piece) / static_cast<double>(pieces);
+        double t1 = static_cast<double>(piece + 1) / static_cast<double>(pieces);
+        double lat0 = start.latitude + t0 * (end.latitude - start.latitude);
+        double lat1 = start.latitude + t1 * (end.latitude - start.latitude);
+        double lon0 = start.longitude + t0 * (end.longitude - start.longitude);
+        double lon1 = start.longitude + t1 * (end.longitude - start.longitude);
+
+        BoundingBox box{std::min(lat0, lat1) - latitudeMargin, std::min(lon0, lon1),
+                        std::max(lat0, lat1) + latitudeMargin, std::max(lon0, lon1)};
+
+        double maxLatitude = std::max(std::abs(box.minLatitude), std::abs(box.maxLatitude));
+        double cosine = maxLatitude >= 90 ? 0.0 : std::cos(maxLatitude / DEGREES_PER_RADIAN);
+        double longitudeMargin = halfAngle >= cosine ? 180.0 : 2 * std::asin(halfAngle / cosine) * DEGREES_PER_RADIAN;
+        box.minLongitude -= longitudeMargin;
+        box.maxLongitude += longitudeMargin;
+
+        appendCells(box, keys);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<const Cell*> result;
+    for (auto key : keys) {
+        auto it = cells.find(key);
+        if (it != cells.end()) {
+            result.push_back(&it->second);
+        }
+    }
+    return result;
+}
+
+} // namespace utils
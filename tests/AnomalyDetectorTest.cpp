@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/monitoring/AnomalyDetector.hpp"
+#include "TimeFixtures.hpp"
+
+using namespace monitoring;
+using Catch::Matchers::WithinAbs;
+using models::FuelType;
+using AnomalyType = AnomalyDetector::AnomalyType;
+
+namespace {
+
+// Hourly observations of the pattern with a cent of noise over
+// [from, to), none reported
+void feed(AnomalyDetector& detector, models::StationHandle station, models::EpochSeconds from,
+          models::EpochSeconds to, models::TenthCents base) {
+    for (auto time = from; time < to; time += HOUR) {
+        REQUIRE_FALSE(detector.observe(station, FuelType::E5, time, dailyPattern(time, base, 5)));
+    }
+}
+
+} // namespace
+
+TEST_CASE("AnomalyDetector accepts the daily swings of a station", "[anomaly]") {
+    AnomalyDetector detector;
+    feed(detector, 0, MONDAY - 8 * 7 * DAY, MONDAY, 1750);
+
+    // The evening drop and morning rise are a price change every day
+    feed(detector, 0, MONDAY, MONDAY + 7 * DAY, 1750);
+
+    auto z = detector.deviation(0, FuelType::E5, MONDAY + 19 * HOUR, 1700);
+    REQUIRE(z);
+    CHECK(std::abs(*z) < 2.0);
+
+    // Unknown series and fuel types have no band yet
+    CHECK_FALSE(detector.deviation(1, FuelType::E5, MONDAY, 1750));
+    CHECK_FALSE(detector.deviation(0, FuelType::Diesel, MONDAY, 1750));
+}
+
+TEST_CASE("AnomalyDetector reports spikes and drops against the band for the hour", "[anomaly]") {
+    AnomalyDetector detector;
+    feed(detector, 0, MONDAY - 8 * 7 * DAY, MONDAY, 1750);
+
+    // The morning price in the evening is far out of the evening band
+    auto spike = detector.observe(0, FuelType::E5, MONDAY + 19 * HOUR, 1810);
+    REQUIRE(spike);
+    CHECK(spike->type == AnomalyType::Spike);
+    CHECK(spike->station == 0);
+    CHECK(spike->fuelType == FuelType::E5);
+    CHECK(spike->price == 1810);
+    CHECK_THAT(spike->expected, WithinAbs(1700, 5));
+    CHECK(spike->deviation >= detector.settings().threshold);
+
+    // Holding the price is not another spike, and the outlier has not
+    // widened the band
+    CHECK_FALSE(detector.observe(0, FuelType::E5, MONDAY + 19 * HOUR + 900, 1810));
+    auto z = detector.deviation(0, FuelType::E5, MONDAY + 19 * HOUR, 1810);
+    REQUIRE(z);
+    CHECK(*z >= detector.settings().threshold);
+
+    auto drop = detector.observe(0, FuelType::E5, MONDAY + 20 * HOUR, 1600);
+    REQUIRE(drop);
+    CHECK(drop->type == AnomalyType::Drop);
+    CHECK(drop->deviation < 0);
+    CHECK(drop->unchangedSince == MONDAY + 19 * HOUR);
+
+    SECTION("Small changes are never anomalous, however steady the prices") {
+        AnomalyDetector steady;
+        for (auto time = MONDAY - 8 * 7 * DAY; time < MONDAY; time += HOUR) {
+            steady.observe(0, FuelType::Diesel, time, 1650);
+        }
+        CHECK_FALSE(steady.observe(0, FuelType::Diesel, MONDAY, 1670));
+        CHECK(steady.observe(0, FuelType::Diesel, MONDAY + HOUR, 1700));
+    }
+
+    SECTION("Nothing is reported during the warmup") {
+        AnomalyDetector fresh;
+        fresh.observe(0, FuelType::E5, MONDAY, 1750);
+        CHECK_FALSE(fresh.observe(0, FuelType::E5, MONDAY + HOUR, 2500));
+        CHECK_FALSE(fresh.deviation(0, FuelType::E5, MONDAY + HOUR, 2500));
+    }
+
+    SECTION("A threshold of 0 disables spikes and drops") {
+        AnomalyDetector::Options options;
+        options.threshold = 0;
+        AnomalyDetector disabled(options);
+        for (auto time = MONDAY - 8 * 7 * DAY; time < MONDAY; time += HOUR) {
+            disabled.observe(0, FuelType::E5, time, 1750);
+        }
+        CHECK_FALSE(disabled.observe(0, FuelType::E5, MONDAY, 2500));
+    }
+}
+
+TEST_CASE("AnomalyDetector reports a stale price once", "[anomaly]") {
+    AnomalyDetector detector;
+    detector.observe(0, FuelType::E5, MONDAY, 1750);
+
+    CHECK_FALSE(detector.observe(0, FuelType::E5, MONDAY + 71 * HOUR, 1750));
+    auto stale = detector.observe(0, FuelType::E5, MONDAY + 72 * HOUR, 1750);
+    REQUIRE(stale);
+    CHECK(stale->type == AnomalyType::StalePrice);
+    CHECK(stale->unchangedSince == MONDAY);
+    CHECK(stale->deviation == 0.0);
+    CHECK_FALSE(detector.observe(0, FuelType::E5, MONDAY + 96 * HOUR, 1750));
+
+    // A change starts the clock again
+    CHECK_FALSE(detector.observe(0, FuelType::E5, MONDAY + 100 * HOUR, 1760));
+    CHECK_FALSE(detector.observe(0, FuelType::E5, MONDAY + 171 * HOUR, 1760));
+    CHECK(detector.observe(0, FuelType::E5, MONDAY + 172 * HOUR, 1760));
+
+    // Late observations are not judged
+    CHECK_FALSE(detector.observe(0, FuelType::E5, MONDAY, 1900));
+
+    AnomalyDetector::Options options;
+    options.staleAfter = std::chrono::seconds(0);
+    AnomalyDetector disabled(options);
+    disabled.observe(0, FuelType::E5, MONDAY, 1750);
+    CHECK_FALSE(disabled.observe(0, FuelType::E5, MONDAY + 30 * DAY, 1750));
+
+    options.alpha = 0;
+    CHECK_THROWS_AS(AnomalyDetector(options), std::invalid_argument);
+}
+
+TEST_CASE("AnomalyDetector trains from stored history", "[anomaly]") {
+    std::vector<storage::PriceRecord> records;
+    for (auto time = MONDAY - 8 * 7 * DAY; time < MONDAY; time += HOUR) {
+        auto price = dailyPattern(time, 1750, 5);
+        if (records.empty() || records.back().price != price) {
+            records.push_back({0, FuelType::E5, time, price});
+        }
+    }
+    records.push_back({1, FuelType::E5, MONDAY - 4 * DAY, 1800});
+    auto history = storage::ColumnarHistory::build(records);
+
+    AnomalyDetector detector;
+    detector.train(history, FuelType::E5, MONDAY);
+
+    auto spike = detector.observe(0, FuelType::E5, MONDAY + 19 * HOUR, 1810);
+    REQUIRE(spike);
+    CHECK(spike->type == AnomalyType::Spike);
+
+    // Unchanged since before the end of the history
+    auto stale = detector.observe(1, FuelType::E5, MONDAY, 1800);
+    REQUIRE(stale);
+    CHECK(stale->type == AnomalyType::StalePrice);
+    CHECK(stale->unchangedSince == MONDAY - 4 * DAY);
+}
+
+TEST_CASE("AnomalyDetector learns one price per series and hour", "[anomaly]") {
+    AnomalyDetector::Options options;
+    options.minSamples = 2;
+    AnomalyDetector detector(options);
+
+    // Polled every 15 minutes, the hour still counts as a single sample
+    for (auto minute = 0; minute < 60; minute += 15) {
+        detector.observe(0, FuelType::E5, MONDAY + minute * 60, 1750);
+    }
+    CHECK_FALSE(detector.deviation(0, FuelType::E5, MONDAY, 1750));
+
+    // The same hour a week later is the second one
+    detector.observe(0, FuelType::E5, MONDAY + 7 * DAY, 1750);
+    CHECK(detector.deviation(0, FuelType::E5, MONDAY, 1750));
+
+    // Training and observing share the hour: polls within the last trained
+    // hour add nothing
+    std::vector<storage::PriceRecord> records{{1, FuelType::E5, MONDAY - HOUR, 1750}};
+    auto history = storage::ColumnarHistory::build(records);
+    detector.train(history, FuelType::E5, MONDAY - HOUR + 1);
+    detector.observe(1, FuelType::E5, MONDAY - HOUR + 1800, 1750);
+    CHECK_FALSE(detector.deviation(1, FuelType::E5, MONDAY - HOUR, 1750));
+}
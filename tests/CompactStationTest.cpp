@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/models/CompactStation.hpp"
+
+using namespace models;
+
+TEST_CASE("Fuel types map to the API names", "[models]") {
+    for (auto fuelType : ALL_FUEL_TYPES) {
+        CHECK(parseFuelType(toString(fuelType)) == fuelType);
+    }
+    CHECK_FALSE(parseFuelType("lpg").has_value());
+    
+    nlohmann::json json = FuelType::Diesel;
+    CHECK(json == "diesel");
+    CHECK(nlohmann::json("e10").get<FuelType>() == FuelType::E10);
+}
+
+TEST_CASE("Prices are fixed-point tenth-cents", "[models]") {
+    CHECK(toTenthCents(1.789) == 1789);
+    CHECK(toTenthCents(1.7890000001) == 1789);
+    CHECK(toTenthCents(1.8089999999) == 1809);
+    CHECK_THAT(toEuros(1789), Catch::Matchers::WithinAbs(1.789, 1e-12));
+    
+    // 1.809 - 1.789 is not exactly 0.02 in floating point
+    CHECK(toTenthCents(1.809) - toTenthCents(1.789) == toTenthCents(0.02));
+}
+
+TEST_CASE("Timestamps are parsed to epoch seconds", "[models]") {
+    CHECK(parseTimestamp("2024-01-01 00:00:00+00") == 1704067200);
+    CHECK(parseTimestamp("2024-01-01 00:00:34+01") == 1704067200 - 3600 + 34);
+    CHECK(parseTimestamp("2024-07-15T12:30:00+02:00") == 1721039400);
+    CHECK(parseTimestamp("2024-07-15T10:30:00Z") == 1721039400);
+    CHECK(parseTimestamp("2024-02-29 23:59:59") == 1709251199);
+    CHECK_FALSE(parseTimestamp("not a date").has_value());
+    CHECK_FALSE(parseTimestamp("2024-13-01 00:00:00+00").has_value());
+    
+    CHECK(formatTimestamp(1721039400) == "2024-07-15T10:30:00Z");
+    CHECK(formatTimestamp(0) == "1970-01-01T00:00:00Z");
+    CHECK(parseTimestamp(formatTimestamp(1709251199)) == 1709251199);
+}
+
+TEST_CASE("StationInterner hands out dense, stable handles", "[models]") {
+    StationInterner interner;
+    auto first = interner.intern("005056ba-7cb6-1ed2-bceb-82ea369c0d2d");
+    auto second = interner.intern("51d4b55e-a095-1aa0-e100-80009459e03a");
+    
+    CHECK(first == 0);
+    CHECK(second == 1);
+    CHECK(interner.intern(std::string("005056ba-7cb6-1ed2-bceb-82ea369c0d2d")) == first);
+    CHECK(interner.find("51d4b55e-a095-1aa0-e100-80009459e03a") == second);
+    CHECK_FALSE(interner.find("unknown").has_value());
+    CHECK(interner.id(second) == "51d4b55e-a095-1aa0-e100-80009459e03a");
+    
+    // Handles and IDs stay valid while the interner grows
+    const auto& id = interner.id(first);
+    for (int i = 0; i < 10000; ++i) interner.intern("station-" + std::to_string(i));
+    CHECK(interner.size() == 10002);
+    CHECK(id == "005056ba-7cb6-1ed2-bceb-82ea369c0d2d");
+    CHECK(interner.find("station-9999") == 10001u);
+}
+
+TEST_CASE("Stations convert between compact and full form", "[models]") {
+    FuelStation station;
+    station.id = "station-1";
+    station.name = "Test";
+    station.brand = "ARAL";
+    station.location.latitude = 52.52;
+    station.location.longitude = 13.40;
+    station.isOpen = true;
+    station.distance = 1.5;
+    station.prices = {
+        FuelPrice{.fuelType = "e5", .price = 1.859, .lastUpdate = "2024-07-15T10:30:00Z"},
+        FuelPrice{.fuelType = "diesel", .price = 1.699, .lastUpdate = "2024-07-15T10:25:00Z"},
+        FuelPrice{.fuelType = "lpg", .price = 0.999, .lastUpdate = ""}
+    };
+    
+    StationInterner interner;
+    auto compactStation = compact(station, interner);
+    
+    CHECK(compactStation.handle == 0);
+    CHECK(compactStation.price(FuelType::E5) == 1859);
+    CHECK(compactStation.price(FuelType::Diesel) == 1699);
+    CHECK_FALSE(compactStation.price(FuelType::E10).has_value());
+    CHECK(compactStation.lastUpdate == 1721039400);
+    CHECK(sizeof(CompactStation) <= 40);
+    
+    auto expanded = expand(compactStation, interner);
+    CHECK(expanded.id == "station-1");
+    CHECK(expanded.isOpen);
+    CHECK_THAT(expanded.location.latitude, Catch::Matchers::WithinAbs(52.52, 1e-5));
+    REQUIRE(expanded.prices.size() == 2);
+    CHECK(expanded.prices[0].fuelType == "e5");
+    CHECK_THAT(expanded.prices[0].price, Catch::Matchers::WithinAbs(1.859, 1e-9));
+    CHECK(expanded.prices[0].lastUpdate == "2024-07-15T10:30:00Z");
+    
+    // The full form keeps its JSON layout
+    auto json = nlohmann::json(expanded);
+    CHECK(json["prices"][1]["fuelType"] == "diesel");
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
 #include "../include/utils/Config.hpp"
 #include <filesystem>
 #include <fstream>
@@ -120,4 +121,125 @@ TEST_CASE("Config can be loaded from environment", "[config]") {
         unsetenv("TANKERKOENIG_API_KEY");
         REQUIRE_THROWS(Config::fromEnvironment());
     }
-} 
\ No newline at end of file
+} 
+
+TEST_CASE("Config requires the monitoring cycle settings", "[config]") {
+    fs::path tempFile = fs::temp_directory_path() / "test_config_monitoring.json";
+
+    auto write = [&](const std::string& monitoring) {
+        std::ofstream config(tempFile);
+        config << R"({
+            "apiKey": "test-api-key",
+            "location": {"latitude": 52.52, "longitude": 13.40, "searchRadius": 5.0},
+            "monitoring": )" << monitoring << R"(,
+            "notifications": []
+        })";
+    };
+
+    SECTION("Optional monitoring keys fall back to their defaults") {
+        write(R"({"fuelTypes": ["e5"], "updateInterval": 15, "priceThreshold": 0.05, "notifyOnIncrease": false})");
+        auto cfg = Config::load(tempFile.string());
+        CHECK(cfg.monitoring.pollMode == "list");
+        CHECK(cfg.monitoring.staleHours == 72);
+    }
+
+    SECTION("Missing updateInterval is rejected") {
+        write(R"({"fuelTypes": ["e5"], "priceThreshold": 0.05, "notifyOnIncrease": false})");
+        REQUIRE_THROWS(Config::load(tempFile.string()));
+    }
+
+    SECTION("Zero updateInterval is rejected") {
+        write(R"({"fuelTypes": ["e5"], "updateInterval": 0, "priceThreshold": 0.05, "notifyOnIncrease": false})");
+        REQUIRE_THROWS(Config::load(tempFile.string()));
+    }
+
+    SECTION("Empty fuelTypes is rejected") {
+        write(R"({"fuelTypes": [], "updateInterval": 15, "priceThreshold": 0.05, "notifyOnIncrease": false})");
+        REQUIRE_THROWS(Config::load(tempFile.string()));
+    }
+
+    fs::remove(tempFile);
+}
+
+TEST_CASE("Config checks the monitoring cycle settings from the environment", "[config]") {
+    setenv("TANKERKOENIG_API_KEY", "env-api-key", 1);
+    setenv("LOCATION_LAT", "52.520008", 1);
+    setenv("LOCATION_LON", "13.404954", 1);
+    setenv("SEARCH_RADIUS", "5.0", 1);
+
+    SECTION("Zero UPDATE_INTERVAL is rejected") {
+        setenv("UPDATE_INTERVAL", "0", 1);
+        REQUIRE_THROWS_WITH(Config::fromEnvironment(), Catch::Matchers::ContainsSubstring("updateInterval"));
+    }
+
+    SECTION("Empty FUEL_TYPES is rejected") {
+        setenv("FUEL_TYPES", "", 1);
+        REQUIRE_THROWS_WITH(Config::fromEnvironment(), Catch::Matchers::ContainsSubstring("fuelTypes"));
+    }
+
+    unsetenv("TANKERKOENIG_API_KEY");
+    unsetenv("LOCATION_LAT");
+    unsetenv("LOCATION_LON");
+    unsetenv("SEARCH_RADIUS");
+    unsetenv("UPDATE_INTERVAL");
+    unsetenv("FUEL_TYPES");
+}
+
+TEST_CASE("Config requires the API key and location", "[config]") {
+    fs::path tempFile = fs::temp_directory_path() / "test_config_required.json";
+
+    SECTION("Optional sections fall back to their defaults") {
+        std::ofstream(tempFile) << R"({
+            "apiKey": "test-api-key",
+            "location": {"latitude": 52.52, "longitude": 13.40, "searchRadius": 5.0},
+            "monitoring": {"fuelTypes": ["e5"], "updateInterval": 15, "priceThreshold": 0.05, "notifyOnIncrease": false},
+            "notifications": []
+        })";
+        auto cfg = Config::load(tempFile.string());
+        CHECK(cfg.regions.empty());
+        CHECK(cfg.api.maxConcurrentRequests == 8);
+        CHECK(cfg.storage.directory == "data");
+    }
+
+    SECTION("Missing apiKey is rejected") {
+        std::ofstream(tempFile) << R"({
+            "location": {"latitude": 52.52, "longitude": 13.40, "searchRadius": 5.0},
+            "monitoring": {"fuelTypes": ["e5"], "updateInterval": 15, "priceThreshold": 0.05, "notifyOnIncrease": false},
+            "notifications": []
+        })";
+        REQUIRE_THROWS_WITH(Config::load(tempFile.string()), Catch::Matchers::ContainsSubstring("apiKey"));
+    }
+
+    SECTION("Missing location is rejected") {
+        std::ofstream(tempFile) << R"({
+            "apiKey": "test-api-key",
+            "monitoring": {"fuelTypes": ["e5"], "updateInterval": 15, "priceThreshold": 0.05, "notifyOnIncrease": false},
+            "notifications": []
+        })";
+        REQUIRE_THROWS_WITH(Config::load(tempFile.string()), Catch::Matchers::ContainsSubstring("location"));
+    }
+
+    fs::remove(tempFile);
+}
+
+TEST_CASE("Config merges cache TTLs over the defaults", "[config]") {
+    fs::path tempFile = fs::temp_directory_path() / "test_config_cache.json";
+
+    std::ofstream(tempFile) << R"({
+        "apiKey": "test-api-key",
+        "location": {"latitude": 52.52, "longitude": 13.40, "searchRadius": 5.0},
+        "api": {"cache": {"ttlSeconds": {"list.php": 300}}},
+        "monitoring": {"fuelTypes": ["e5"], "updateInterval": 15, "priceThreshold": 0.05, "notifyOnIncrease": false},
+        "notifications": []
+    })";
+    auto cfg = Config::load(tempFile.string());
+
+    CHECK(cfg.api.cache.enabled);
+    CHECK(cfg.api.cache.memoryMegabytes == 16);
+    REQUIRE(cfg.api.cache.ttlSeconds.size() == 3);
+    CHECK(cfg.api.cache.ttlSeconds["list.php"] == 300);
+    CHECK(cfg.api.cache.ttlSeconds["prices.php"] == 60);
+    CHECK(cfg.api.cache.ttlSeconds["detail.php"] == 30 * 24 * 3600);
+
+    fs::remove(tempFile);
+}
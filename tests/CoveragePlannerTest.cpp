@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../include/utils/CoveragePlanner.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+
+using namespace utils;
+
+namespace {
+
+// Rough outline of Germany
+const std::vector<Waypoint> GERMANY = {
+    {54.91, 8.67}, {54.80, 9.94}, {54.45, 11.09}, {54.18, 12.30}, {54.68, 13.40},
+    {53.92, 14.22}, {52.85, 14.12}, {52.35, 14.55}, {51.55, 14.75}, {51.00, 15.00},
+    {50.32, 12.10}, {49.80, 12.45}, {49.00, 13.40}, {48.57, 13.73}, {47.70, 12.95},
+    {47.55, 10.45}, {47.55, 7.60}, {48.95, 8.20}, {49.45, 6.35}, {50.25, 6.40},
+    {50.75, 6.05}, {51.85, 5.95}, {52.25, 7.05}, {53.25, 7.20}, {53.70, 7.10}
+};
+
+bool isCovered(double lat, double lon, const std::vector<CoverageTile>& tiles) {
+    return std::any_of(tiles.begin(), tiles.end(), [&](const auto& tile) {
+        return RouteCalculator::calculateDistance(lat, lon, tile.latitude, tile.longitude) <= tile.radius;
+    });
+}
+
+} // namespace
+
+TEST_CASE("CoveragePlanner covers a bounding box", "[coverage]") {
+    BoundingBox box{52.3, 13.0, 52.7, 13.8};  // Berlin
+    auto tiles = CoveragePlanner::planBoundingBox(box, 10.0);
+    
+    REQUIRE_FALSE(tiles.empty());
+    
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(box.minLatitude, box.maxLatitude);
+    std::uniform_real_distribution<double> lon(box.minLongitude, box.maxLongitude);
+    for (int i = 0; i < 2000; ++i) {
+        double pLat = lat(rng), pLon = lon(rng);
+        INFO("Point " << pLat << ", " << pLon);
+        REQUIRE(isCovered(pLat, pLon, tiles));
+    }
+}
+
+TEST_CASE("CoveragePlanner covers Germany with a few hundred queries", "[coverage]") {
+    auto tiles = CoveragePlanner::planPolygon(GERMANY);
+    
+    CHECK(tiles.size() > 200);
+    CHECK(tiles.size() < 500);
+    
+    SECTION("Every point inside the polygon is covered") {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> lat(47.5, 55.0);
+        std::uniform_real_distribution<double> lon(5.9, 15.0);
+        for (int i = 0; i < 5000; ++i) {
+            double pLat = lat(rng), pLon = lon(rng);
+            bool inside = false;
+            for (size_t a = 0, b = GERMANY.size() - 1; a < GERMANY.size(); b = a++) {
+                if ((GERMANY[a].latitude > pLat) != (GERMANY[b].latitude > pLat) &&
+                    pLon < GERMANY[a].longitude + (pLat - GERMANY[a].latitude) *
+                        (GERMANY[b].longitude - GERMANY[a].longitude) / (GERMANY[b].latitude - GERMANY[a].latitude)) {
+                    inside = !inside;
+                }
+            }
+            if (!inside) continue;
+            
+            INFO("Point " << pLat << ", " << pLon);
+            REQUIRE(isCovered(pLat, pLon, tiles));
+        }
+    }
+}
+
+TEST_CASE("CoveragePlanner tiles are stable", "[coverage]") {
+    auto large = CoveragePlanner::planBoundingBox({50.0, 8.0, 52.0, 11.0});
+    auto small = CoveragePlanner::planBoundingBox({50.5, 9.0, 51.0, 10.0});
+    
+    std::set<std::pair<int64_t, int64_t>> largeIds;
+    for (const auto& tile : large) {
+        largeIds.insert({tile.row, tile.column});
+    }
+    
+    // Tiles of a sub-area are a subset of the enclosing area's tiles
+    for (const auto& tile : small) {
+        CHECK(largeIds.count({tile.row, tile.column}) == 1);
+    }
+    
+    CHECK(CoveragePlanner::planBoundingBox({50.0, 8.0, 52.0, 11.0}).size() == large.size());
+}
+
+TEST_CASE("CoveragePlanner rejects invalid input", "[coverage]") {
+    REQUIRE_THROWS(CoveragePlanner::planBoundingBox({50.0, 8.0, 51.0, 9.0}, 30.0));
+    REQUIRE_THROWS(CoveragePlanner::planPolygon({{50.0, 8.0}, {51.0, 9.0}}));
+}
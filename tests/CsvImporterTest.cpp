@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/storage/CsvImporter.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+using namespace storage;
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path writeFile(const std::string& name, const std::string& content) {
+    auto path = fs::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+}
+
+struct CollectedRecord {
+    std::string stationId;
+    models::FuelType fuelType;
+    models::EpochSeconds timestamp;
+    models::TenthCents price;
+};
+
+} // namespace
+
+TEST_CASE("CsvFieldSplitter handles quoted fields", "[import]") {
+    CsvFieldSplitter splitter(R"(a,"b, with comma","say ""hi""",,last)");
+    std::vector<std::string> fields;
+    std::string_view field;
+    while (splitter.next(field)) fields.emplace_back(field);
+    
+    REQUIRE(fields.size() == 5);
+    CHECK(fields[0] == "a");
+    CHECK(fields[1] == "b, with comma");
+    CHECK(CsvFieldSplitter::unescape(fields[2]) == "say \"hi\"");
+    CHECK(fields[3].empty());
+    CHECK(fields[4] == "last");
+}
+
+TEST_CASE("CsvImporter emits only changed prices", "[import]") {
+    auto path = writeFile("fuel-prices-test.csv",
+        "date,station_uuid,diesel,e5,e10,dieselchange,e5change,e10change\n"
+        "2024-01-01 00:00:34+01,station-1,1.759,1.859,1.799,1,0,3\n"
+        "2024-01-01 00:01:00+01,station-2,1.749,0.000,1.789,0,1,0\n"
+        "garbage\n"
+        "2024-01-01 00:02:00+01,station-1,1.769,1.859,1.799,1,0,0\r\n");
+    
+    std::vector<CollectedRecord> records;
+    auto stats = CsvImporter::importPrices(path, [&](std::span<const PriceChangeRecord> batch) {
+        for (const auto& record : batch) {
+            records.push_back({std::string(record.stationId), record.fuelType, record.timestamp, record.price});
+        }
+    });
+    
+    CHECK(stats.rows == 4);
+    CHECK(stats.malformedRows == 1);
+    REQUIRE(stats.records == 3);
+    REQUIRE(records.size() == 3);
+    
+    CHECK(records[0].stationId == "station-1");
+    CHECK(records[0].fuelType == models::FuelType::Diesel);
+    CHECK(records[0].timestamp == 1704063634);
+    CHECK(records[0].price == 1759);
+    CHECK(records[1].fuelType == models::FuelType::E10);
+    CHECK(records[2].fuelType == models::FuelType::Diesel);
+    CHECK(records[2].price == 1769);
+    
+    fs::remove(path);
+}
+
+TEST_CASE("CsvImporter splits large files across threads", "[import]") {
+    std::string content = "date,station_uuid,diesel,e5,e10,dieselchange,e5change,e10change\n";
+    const int rows = 20000;
+    for (int i = 0; i < rows; ++i) {
+        content += "2024-01-01 00:00:00+01,station-" + std::to_string(i) + ",1.759,1.859,1.799,1,1,0\n";
+    }
+    auto path = writeFile("fuel-prices-large.csv", content);
+    
+    std::mutex mutex;
+    size_t received = 0;
+    CsvImporter::Options options;
+    options.threads = 4;
+    options.batchSize = 100;
+    auto stats = CsvImporter::importPrices(path, [&](std::span<const PriceChangeRecord> batch) {
+        CHECK(batch.size() <= 100);
+        std::lock_guard<std::mutex> lock(mutex);
+        received += batch.size();
+    }, options);
+    
+    CHECK(stats.rows == rows);
+    CHECK(stats.records == 2 * rows);
+    CHECK(received == 2 * rows);
+    CHECK(stats.bytes == content.size());
+    
+    fs::remove(path);
+}
+
+TEST_CASE("CsvImporter rejects files with an unexpected header", "[import]") {
+    auto path = writeFile("fuel-prices-bad.csv", "uuid,name\n1,2\n");
+    CHECK_THROWS_AS(CsvImporter::importPrices(path, [](auto) {}), std::runtime_error);
+    fs::remove(path);
+}
+
+TEST_CASE("CsvImporter reads station dumps", "[import]") {
+    auto path = writeFile("fuel-stations-test.csv",
+        "uuid,name,brand,street,house_number,post_code,city,latitude,longitude,first_active,openingtimes_json\n"
+        "station-1,\"Tankstelle \"\"Nord\"\"\",ARAL,Hauptstr.,1,10115,Berlin,52.52,13.40,"
+        "1970-01-01 01:00:00+01,\"{\"\"openingTimes\"\":[]}\"\n"
+        "station-2,\"Multi\nLine\",Shell,Ring,2a,80331,München,48.13,11.57,2014-01-01 00:00:00+01,{}\n");
+    
+    auto stations = CsvImporter::importStations(path);
+    
+    REQUIRE(stations.size() == 2);
+    CHECK(stations[0].id == "station-1");
+    CHECK(stations[0].name == "Tankstelle \"Nord\"");
+    CHECK(stations[0].location.postalCode == "10115");
+    CHECK_THAT(stations[0].location.latitude, Catch::Matchers::WithinAbs(52.52, 1e-9));
+    CHECK(stations[1].name == "Multi\nLine");
+    CHECK(stations[1].location.city == "München");
+    
+    fs::remove(path);
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+#include "../include/utils/GeoKernels.hpp"
+
+using namespace utils;
+
+namespace {
+
+constexpr auto ISAS = {GeoKernels::Isa::Scalar, GeoKernels::Isa::Avx2};
+
+} // namespace
+
+TEST_CASE("GeoKernels measures a point like RouteCalculator", "[geo]") {
+    std::mt19937 random(22);
+    std::uniform_real_distribution<double> latitude(47.0, 55.0);
+    std::uniform_real_distribution<double> longitude(6.0, 15.0);
+
+    for (int i = 0; i < 1000; ++i) {
+        Waypoint start{latitude(random), longitude(random)};
+        Waypoint end = i % 10 == 0 ? start : Waypoint{latitude(random), longitude(random)};
+        auto frame = GeoKernels::frame(start, end, 0.0);
+
+        double lat = latitude(random);
+        double lon = longitude(random);
+        auto distance = GeoKernels::distance(frame, lat, lon);
+        CHECK(RouteCalculator::isPointInCorridor(start, end, lat, lon, distance));
+        CHECK_FALSE(RouteCalculator::isPointInCorridor(start, end, lat, lon, std::nextafter(distance, 0.0)));
+    }
+
+    auto frame = GeoKernels::frame({52.52, 13.40}, {52.52, 13.40}, 0.0);
+    CHECK(GeoKernels::distance(frame, 53.55, 9.99) == RouteCalculator::calculateDistance(53.55, 9.99, 52.52, 13.40));
+}
+
+TEST_CASE("GeoKernels corridor bounds agree with the exact distance", "[geo]") {
+    std::mt19937 random(22);
+    std::normal_distribution<double> offset(0.0, 1.0);
+
+    struct Case {
+        Waypoint start;
+        Waypoint end;
+        double radius;
+    };
+    std::vector<Case> cases = {
+        {{48.14, 11.58}, {53.55, 9.99}, 5.0},    // Munich to Hamburg
+        {{52.52, 13.40}, {52.53, 13.41}, 0.5},   // a city block
+        {{50.94, 6.96}, {50.94, 6.96}, 2.0},     // a single waypoint
+        {{69.65, 18.96}, {70.66, 23.68}, 50.0},  // far north
+        {{-33.9, 18.4}, {-34.4, 19.2}, 20.0},
+        {{0.0, -0.5}, {0.0, 0.5}, 3000.0},
+    };
+
+    for (const auto& [start, end, radius] : cases) {
+        auto frame = GeoKernels::frame(start, end, radius);
+
+        // Points scattered around the segment on the scale of the corridor
+        double spread = 2 * radius / 111.0;
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        size_t expected = 0;
+        for (int i = 0; i < 4003; ++i) {
+            double t = (i % 7) / 6.0;
+            double lat = std::clamp(start.latitude + t * (end.latitude - start.latitude) + spread * offset(random),
+                                    -89.0, 89.0);
+            double lon = start.longitude + t * (end.longitude - start.longitude) + spread * offset(random);
+            latitudes.push_back(lat);
+            longitudes.push_back(lon);
+            if (RouteCalculator::isPointInCorridor(start, end, lat, lon, radius)) {
+                ++expected;
+            }
+        }
+        REQUIRE(expected > 0);
+        REQUIRE(expected < latitudes.size());
+
+        // The points within the corridor alone, then with one outside
+        std::vector<double> insideLatitudes;
+        std::vector<double> insideLongitudes;
+        size_t outsidePoint = latitudes.size();
+        for (size_t i = 0; i < latitudes.size(); ++i) {
+            if (GeoKernels::distance(frame, latitudes[i], longitudes[i]) <= radius) {
+                insideLatitudes.push_back(latitudes[i]);
+                insideLongitudes.push_back(longitudes[i]);
+            } else if (outsidePoint == latitudes.size()) {
+                outsidePoint = i;
+            }
+        }
+        for (auto isa : ISAS) {
+            CHECK(GeoKernels::allWithin(frame, insideLatitudes, insideLongitudes, isa));
+        }
+        for (size_t at : {size_t{0}, insideLatitudes.size() / 2, insideLatitudes.size()}) {
+            auto withOutside = insideLatitudes;
+            auto withOutsideLongitudes = insideLongitudes;
+            withOutside.insert(withOutside.begin() + static_cast<ptrdiff_t>(at), latitudes[outsidePoint]);
+            withOutsideLongitudes.insert(withOutsideLongitudes.begin() + static_cast<ptrdiff_t>(at),
+                                         longitudes[outsidePoint]);
+            for (auto isa : ISAS) {
+                CHECK_FALSE(GeoKernels::allWithin(frame, withOutside, withOutsideLongitudes, isa));
+            }
+        }
+
+        for (auto isa : ISAS) {
+            std::vector<double> distances(latitudes.size());
+            CHECK(GeoKernels::corridorDistances(frame, latitudes, longitudes, distances, isa) == expected);
+            for (size_t i = 0; i < latitudes.size(); ++i) {
+                auto exact = GeoKernels::distance(frame, latitudes[i], longitudes[i]);
+                if (exact <= radius) {
+                    CHECK(distances[i] == exact);
+                } else {
+                    CHECK(std::isinf(distances[i]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("GeoKernels implementations agree on odd lengths", "[geo]") {
+    std::mt19937 random(22);
+    std::uniform_real_distribution<double> latitude(52.0, 53.0);
+    std::uniform_real_distribution<double> longitude(13.0, 14.0);
+    auto frame = GeoKernels::frame({52.2, 13.1}, {52.8, 13.9}, 10.0);
+
+    for (size_t count : {0, 1, 3, 5, 17}) {
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        for (size_t i = 0; i < count; ++i) {
+            latitudes.push_back(latitude(random));
+            longitudes.push_back(longitude(random));
+        }
+
+        std::vector<double> scalar(count);
+        std::vector<double> avx2(count);
+        CHECK(GeoKernels::corridorDistances(frame, latitudes, longitudes, scalar, GeoKernels::Isa::Scalar) ==
+              GeoKernels::corridorDistances(frame, latitudes, longitudes, avx2, GeoKernels::Isa::Avx2));
+        CHECK(scalar == avx2);
+    }
+}
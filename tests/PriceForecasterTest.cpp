@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include "../include/analytics/PriceForecaster.hpp"
+#include "TimeFixtures.hpp"
+
+using namespace analytics;
+using Catch::Matchers::WithinAbs;
+using models::FuelType;
+
+namespace {
+
+// Hourly records of the pattern over [from, to)
+void feed(PriceForecaster& forecaster, models::StationHandle station, models::EpochSeconds from,
+          models::EpochSeconds to, models::TenthCents base) {
+    for (auto time = from; time < to; time += HOUR) {
+        forecaster.update({station, FuelType::E5, time, dailyPattern(time, base)});
+    }
+}
+
+size_t localHour(models::EpochSeconds utc) {
+    return static_cast<size_t>(((utc - MONDAY) % DAY + DAY) % DAY / HOUR);
+}
+
+} // namespace
+
+TEST_CASE("PriceForecaster learns the hour-of-week profile of a station", "[forecast]") {
+    PriceForecaster forecaster;
+    feed(forecaster, 0, MONDAY - 28 * DAY, MONDAY, 1750);
+    CHECK(forecaster.seriesCount() == 1);
+
+    auto forecast = forecaster.forecast(0, FuelType::E5, MONDAY + 20 * 60, 24);
+    REQUIRE(forecast);
+    CHECK(forecast->start == MONDAY);
+    REQUIRE(forecast->prices.size() == 24);
+
+    auto cheapest = localHour(forecast->cheapestTime());
+    CHECK(cheapest >= 18);
+    CHECK(cheapest < 21);
+    CHECK_THAT(forecast->cheapestPrice(), WithinAbs(1700, 15));
+    CHECK_THAT(forecast->prices[7], WithinAbs(1810, 15));
+    CHECK_THAT(forecast->prices[13], WithinAbs(1750, 15));
+
+    CHECK_FALSE(forecaster.forecast(1, FuelType::E5, MONDAY, 24));
+    CHECK_FALSE(forecaster.forecast(0, FuelType::Diesel, MONDAY, 24));
+
+    // Older than the newest record
+    CHECK_FALSE(forecaster.update({0, FuelType::E5, MONDAY - 2 * DAY, 1600}));
+}
+
+TEST_CASE("PriceForecaster follows a trend", "[forecast]") {
+    PriceForecaster forecaster;
+    for (int hour = 0; hour < 21 * 24; ++hour) {
+        forecaster.update({0, FuelType::E5, MONDAY - 21 * DAY + hour * HOUR, 1700 + hour / 4});
+    }
+
+    auto forecast = forecaster.forecast(0, FuelType::E5, MONDAY, 24);
+    REQUIRE(forecast);
+    CHECK(forecast->prices.back() > forecast->prices.front());
+    CHECK_THAT(forecast->prices.front(), WithinAbs(1700 + 21 * 24 / 4, 10));
+}
+
+TEST_CASE("PriceForecaster lends new stations the profile of their brand", "[forecast]") {
+    PriceForecaster forecaster;
+    for (models::StationHandle station = 0; station < 3; ++station) {
+        forecaster.setBrand(station, "ARAL");
+        feed(forecaster, station, MONDAY - 28 * DAY, MONDAY, 1750 + static_cast<models::TenthCents>(station) * 20);
+    }
+
+    // A new Aral station priced flat so far, and one of an unknown brand
+    forecaster.setBrand(3, "Aral");
+    forecaster.setBrand(4, "");
+    for (auto time = MONDAY - DAY; time < MONDAY; time += HOUR) {
+        forecaster.update({3, FuelType::E5, time, 1800});
+        forecaster.update({4, FuelType::E5, time, 1800});
+    }
+
+    std::vector<models::StationHandle> stations = {3, 4, 5};
+    auto forecasts = forecaster.forecast(stations, FuelType::E5, MONDAY, 24);
+    REQUIRE(forecasts.size() == 3);
+    REQUIRE(forecasts[0]);
+    REQUIRE(forecasts[1]);
+    CHECK_FALSE(forecasts[2]);
+
+    for (const auto& forecast : {*forecasts[0], *forecasts[1]}) {
+        auto cheapest = localHour(forecast.cheapestTime());
+        CHECK(cheapest >= 18);
+        CHECK(cheapest < 21);
+        CHECK(forecast.prices[7] > forecast.prices[13]);
+    }
+
+    // Without warmed-up stations there is nothing to borrow
+    PriceForecaster fresh;
+    for (auto time = MONDAY - DAY; time < MONDAY; time += HOUR) {
+        fresh.update({0, FuelType::E5, time, 1800});
+    }
+    auto flat = fresh.forecast(0, FuelType::E5, MONDAY, 24);
+    REQUIRE(flat);
+    CHECK_THAT(flat->prices.front(), WithinAbs(1800, 1));
+    CHECK_THAT(flat->prices.back(), WithinAbs(1800, 1));
+}
+
+TEST_CASE("PriceForecaster trains from stored history", "[forecast]") {
+    std::vector<storage::PriceRecord> records;
+    for (auto time = MONDAY - 14 * DAY; time < MONDAY; time += HOUR) {
+        records.push_back({0, FuelType::E5, time, dailyPattern(time, 1750)});
+        records.push_back({1, FuelType::E5, time, dailyPattern(time + 6 * HOUR, 1800)});
+    }
+    auto history = storage::ColumnarHistory::build(records);
+
+    PriceForecaster trained, updated;
+    trained.train(history, FuelType::E5);
+    for (const auto& record : records) {
+        updated.update(record);
+    }
+
+    for (models::StationHandle station = 0; station < 2; ++station) {
+        auto a = trained.forecast(station, FuelType::E5, MONDAY, 48);
+        auto b = updated.forecast(station, FuelType::E5, MONDAY, 48);
+        REQUIRE(a);
+        REQUIRE(b);
+        CHECK(a->prices == b->prices);
+    }
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../include/monitoring/PriceIndex.hpp"
+#include <map>
+#include <random>
+
+using namespace monitoring;
+using models::FuelType;
+
+TEST_CASE("PriceIndex tracks current prices", "[index]") {
+    PriceIndex index;
+    
+    CHECK_FALSE(index.update(1, FuelType::E5, 1799).has_value());
+    CHECK(index.update(1, FuelType::E5, 1779) == 1799);
+    CHECK(index.update(1, FuelType::Diesel, 1659) == std::nullopt);
+    
+    CHECK(index.price(1, FuelType::E5) == 1779);
+    CHECK(index.price(1, FuelType::Diesel) == 1659);
+    CHECK_FALSE(index.price(1, FuelType::E10).has_value());
+    CHECK_FALSE(index.price(2, FuelType::E5).has_value());
+    CHECK(index.size() == 2);
+    CHECK(index.size(FuelType::E5) == 1);
+}
+
+TEST_CASE("PriceIndex answers cheapest, rank and top-k per fuel type", "[index]") {
+    PriceIndex index;
+    index.update(10, FuelType::E5, 1809);
+    index.update(11, FuelType::E5, 1789);
+    index.update(12, FuelType::E5, 1789);
+    index.update(13, FuelType::E5, 1759);
+    index.update(14, FuelType::Diesel, 1599);
+    
+    auto cheapest = index.cheapest(FuelType::E5);
+    REQUIRE(cheapest.has_value());
+    CHECK(cheapest->station == 13);
+    CHECK(cheapest->price == 1759);
+    CHECK_FALSE(index.cheapest(FuelType::E10).has_value());
+    
+    CHECK(index.rank(13, FuelType::E5) == 1);
+    CHECK(index.rank(11, FuelType::E5) == 2);
+    CHECK(index.rank(12, FuelType::E5) == 2);
+    CHECK(index.rank(10, FuelType::E5) == 4);
+    CHECK(index.rank(14, FuelType::Diesel) == 1);
+    CHECK(index.rank(14, FuelType::E5) == 0);
+    
+    auto top = index.topK(FuelType::E5, 3);
+    REQUIRE(top.size() == 3);
+    CHECK(top[0].station == 13);
+    CHECK(top[1].price == 1789);
+    CHECK(top[2].price == 1789);
+    CHECK(index.topK(FuelType::E5, 10).size() == 4);
+    
+    SECTION("Updates keep the ordering in sync") {
+        index.update(10, FuelType::E5, 1749);
+        CHECK(index.cheapest(FuelType::E5)->station == 10);
+        CHECK(index.rank(13, FuelType::E5) == 2);
+        CHECK(index.rank(11, FuelType::E5) == 3);
+    }
+    
+    SECTION("Erased prices leave the ordering") {
+        CHECK(index.erase(13, FuelType::E5));
+        CHECK_FALSE(index.erase(13, FuelType::E5));
+        CHECK(index.cheapest(FuelType::E5)->price == 1789);
+        CHECK(index.rank(10, FuelType::E5) == 3);
+        CHECK(index.size() == 4);
+    }
+}
+
+TEST_CASE("PriceIndex matches a reference map under random updates", "[index]") {
+    PriceIndex index;
+    std::map<std::pair<models::StationHandle, FuelType>, models::TenthCents> reference;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<models::StationHandle> stations(0, 4999);
+    std::uniform_int_distribution<int> fuelTypes(0, 2);
+    std::uniform_int_distribution<models::TenthCents> prices(1500, 2100);
+    
+    for (int i = 0; i < 50000; ++i) {
+        auto station = stations(random);
+        auto fuelType = static_cast<FuelType>(fuelTypes(random));
+        auto key = std::make_pair(station, fuelType);
+        
+        if (i % 5 == 0) {
+            CHECK(index.erase(station, fuelType) == (reference.erase(key) == 1));
+        } else {
+            auto price = prices(random);
+            auto it = reference.find(key);
+            auto previous = index.update(station, fuelType, price);
+            CHECK(previous == (it == reference.end() ? std::nullopt : std::optional(it->second)));
+            reference[key] = price;
+        }
+    }
+    
+    REQUIRE(index.size() == reference.size());
+    for (const auto& [key, price] : reference) {
+        REQUIRE(index.price(key.first, key.second) == price);
+    }
+    
+    // Ranks against a brute-force count
+    for (models::StationHandle station = 0; station < 200; ++station) {
+        auto current = index.price(station, FuelType::E10);
+        if (!current) continue;
+        size_t cheaper = 0;
+        for (const auto& [key, price] : reference) {
+            if (key.second == FuelType::E10 && price < *current) ++cheaper;
+        }
+        CHECK(index.rank(station, FuelType::E10) == cheaper + 1);
+    }
+}
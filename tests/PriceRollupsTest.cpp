@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <random>
+#include "../include/analytics/PriceRollups.hpp"
+#include "TimeFixtures.hpp"
+
+using namespace analytics;
+using models::FuelType;
+using Resolution = PriceRollups::Resolution;
+namespace fs = std::filesystem;
+
+namespace {
+
+bool samePoints(const PriceRollups::Result& a, const PriceRollups::Result& b) {
+    if (a.resolution != b.resolution || a.points.size() != b.points.size()) return false;
+    for (size_t i = 0; i < a.points.size(); ++i) {
+        const auto& x = a.points[i];
+        const auto& y = b.points[i];
+        if (x.start != y.start || x.value.weightedSum != y.value.weightedSum || x.value.seconds != y.value.seconds ||
+            x.value.minPrice != y.value.minPrice || x.value.maxPrice != y.value.maxPrice) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("PriceRollups maintain time-weighted buckets as prices arrive", "[rollups]") {
+    PriceRollups rollups;
+    CHECK(rollups.add({0, FuelType::E10, MONDAY, 1800}));
+    CHECK(rollups.add({0, FuelType::E10, MONDAY + 90 * 60, 1700}));
+    CHECK(rollups.add({0, FuelType::E10, MONDAY + 3 * HOUR, 1600}));
+    CHECK(rollups.add({1, FuelType::E10, MONDAY + HOUR, 1900}));
+    CHECK(rollups.add({1, FuelType::E10, MONDAY + 2 * HOUR, 1900}));
+    
+    // Older than the newest record of the series
+    CHECK_FALSE(rollups.add({0, FuelType::E10, MONDAY + HOUR, 1500}));
+    
+    PriceRollups::Query hourly{.fuelType = FuelType::E10, .from = MONDAY, .to = MONDAY + 3 * HOUR, .step = HOUR, .stations = {0}};
+    auto result = rollups.query(hourly);
+    CHECK(result.resolution == Resolution::Hour);
+    REQUIRE(result.points.size() == 3);
+    CHECK(result.points[0].start == MONDAY);
+    CHECK(result.points[0].value.average() == 1800);
+    CHECK(result.points[1].value.average() == 1750);
+    CHECK(result.points[1].value.minPrice == 1700);
+    CHECK(result.points[1].value.maxPrice == 1800);
+    CHECK(result.points[2].value.average() == 1700);
+    
+    // The whole area: station 1 adds an hour at 1.900
+    hourly.stations.clear();
+    auto area = rollups.query(hourly);
+    CHECK(area.points[0].value.seconds == HOUR);
+    CHECK(area.points[1].value.seconds == 2 * HOUR);
+    CHECK(area.points[1].value.average() == (1750 + 1900) / 2.0);
+    CHECK(area.points[1].value.maxPrice == 1900);
+    
+    // Local days; the last price of each series is still open
+    auto daily = rollups.query({.fuelType = FuelType::E10, .from = MONDAY, .to = MONDAY + 2 * DAY, .step = DAY, .stations = {}});
+    CHECK(daily.resolution == Resolution::Day);
+    REQUIRE(daily.points.size() == 2);
+    CHECK(daily.points[0].value.seconds == 4 * HOUR);
+    CHECK(daily.points[1].value.seconds == 0);
+    
+    // Ranges not aligned to an hour fall back to five-minute buckets
+    auto fine = rollups.query({.fuelType = FuelType::E10, .from = MONDAY + 600, .to = MONDAY + 3 * HOUR, .step = 1800, .stations = {0}});
+    CHECK(fine.resolution == Resolution::FiveMinutes);
+    REQUIRE(fine.points.size() == 6);
+    CHECK(fine.points[0].start == MONDAY + 600);
+    CHECK(fine.points[2].value.weightedSum == 1200 * 1800 + 600 * 1700);
+}
+
+TEST_CASE("PriceRollups follow German local days", "[rollups]") {
+    PriceRollups rollups;
+    
+    // Summer time starts on 2024-03-31, a 23-hour day
+    constexpr models::EpochSeconds SUNDAY = 1711839600;  // 2024-03-31 00:00 CET
+    rollups.add({0, FuelType::Diesel, SUNDAY - HOUR, 1700});
+    rollups.add({0, FuelType::Diesel, SUNDAY + 23 * HOUR + 1, 1700});
+    
+    auto daily = rollups.query({.fuelType = FuelType::Diesel, .from = SUNDAY, .to = SUNDAY + 23 * HOUR, .step = DAY, .stations = {}});
+    CHECK(daily.resolution == Resolution::Day);
+    REQUIRE(daily.points.size() == 1);
+    CHECK(daily.points[0].value.seconds == static_cast<uint64_t>(23 * HOUR));
+}
+
+TEST_CASE("PriceRollups recompute matches incremental updates", "[rollups]") {
+    auto directory = fs::temp_directory_path() / "price-rollups-recompute";
+    fs::remove_all(directory);
+    
+    std::mt19937 random(11);
+    std::uniform_int_distribution<models::EpochSeconds> gap(60, 6 * HOUR);
+    std::uniform_int_distribution<models::TenthCents> price(1500, 2000);
+    
+    PriceRollups live;
+    storage::PriceStore store({.directory = directory});
+    for (int station = 0; station < 20; ++station) {
+        auto handle = store.intern("station-" + std::to_string(station));
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            for (auto timestamp = MONDAY + gap(random); timestamp < MONDAY + 20 * DAY; timestamp += gap(random)) {
+                storage::PriceRecord record{handle, fuelType, timestamp, price(random)};
+                store.append(record);
+                live.add(record);
+            }
+        }
+    }
+    
+    PriceRollups rebuilt;
+    rebuilt.recompute(store, MONDAY, MONDAY + 20 * DAY, 4);
+    
+    auto compare = [&](models::EpochSeconds from, models::EpochSeconds step) {
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            PriceRollups::Query query{.fuelType = fuelType, .from = from, .to = MONDAY + 20 * DAY, .step = step, .stations = {}};
+            CHECK(samePoints(live.query(query), rebuilt.query(query)));
+            query.stations = {3, 7};
+            CHECK(samePoints(live.query(query), rebuilt.query(query)));
+        }
+    };
+    compare(MONDAY, DAY);
+    compare(MONDAY, 7 * DAY);
+    compare(MONDAY, HOUR);
+    compare(MONDAY + 19 * DAY, 300);
+    
+    // Five-minute buckets are only kept for two days
+    CHECK(rebuilt.resolutionFor({.fuelType = FuelType::E5, .from = MONDAY, .to = MONDAY + DAY, .step = 300, .stations = {}}) == Resolution::Hour);
+    CHECK(rebuilt.resolutionFor({.fuelType = FuelType::E5, .from = MONDAY + 19 * DAY, .to = MONDAY + 20 * DAY, .step = 900, .stations = {}}) == Resolution::FiveMinutes);
+    
+    // Both continue from the newest price of each series
+    live.add({5, FuelType::E5, MONDAY + 21 * DAY, 1599});
+    rebuilt.add({5, FuelType::E5, MONDAY + 21 * DAY, 1599});
+    compare(MONDAY, DAY);
+    
+    // Recomputing a range again gives the same buckets
+    rebuilt.recompute(store, MONDAY + 3 * DAY, MONDAY + 5 * DAY, 3);
+    compare(MONDAY, HOUR);
+    
+    fs::remove_all(directory);
+}
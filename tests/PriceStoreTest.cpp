@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../include/storage/ColumnarHistory.hpp"
+#include "../include/storage/PriceStore.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace storage;
+using models::FuelType;
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path freshDirectory(const std::string& name) {
+    auto directory = fs::temp_directory_path() / name;
+    fs::remove_all(directory);
+    return directory;
+}
+
+} // namespace
+
+TEST_CASE("PriceStore keeps the latest price across restarts", "[store]") {
+    auto directory = freshDirectory("price-store-restart");
+    
+    {
+        PriceStore store({.directory = directory});
+        auto first = store.intern("station-1");
+        auto second = store.intern("station-2");
+        
+        store.append({first, FuelType::E5, 1000, 1799});
+        store.append({first, FuelType::E5, 2000, 1779});
+        store.append({second, FuelType::Diesel, 1500, 1659});
+        
+        // Out-of-order records do not replace newer ones
+        store.append({first, FuelType::E5, 1200, 1899});
+        
+        CHECK(store.latest(first, FuelType::E5)->price == 1779);
+    }
+    
+    PriceStore store({.directory = directory});
+    CHECK(store.stationCount() == 2);
+    REQUIRE(store.find("station-2").has_value());
+    
+    auto first = *store.find("station-1");
+    auto latest = store.latest(first, FuelType::E5);
+    REQUIRE(latest.has_value());
+    CHECK(latest->price == 1779);
+    CHECK(latest->timestamp == 2000);
+    CHECK_FALSE(store.latest(first, FuelType::Diesel).has_value());
+    CHECK(store.recordCount() == 4);
+    
+    size_t count = 0;
+    store.forEachLatest([&](const PriceRecord&) { ++count; });
+    CHECK(count == 2);
+    
+    fs::remove_all(directory);
+}
+
+TEST_CASE("PriceStore replays records written after the last checkpoint", "[store]") {
+    auto directory = freshDirectory("price-store-replay");
+    
+    {
+        PriceStore store({.directory = directory});
+        auto station = store.intern("station-1");
+        store.append({station, FuelType::E10, 1000, 1739});
+        store.checkpoint();
+        fs::copy_file(directory / "latest.snapshot", directory / "stale.snapshot");
+        store.append({station, FuelType::E10, 2000, 1749});
+    }
+    
+    // Simulate a crash after the second record was written: the snapshot
+    // predates it and a torn record follows it
+    fs::rename(directory / "stale.snapshot", directory / "latest.snapshot");
+    {
+        std::ofstream segment(directory / "segment-00000001.log", std::ios::binary | std::ios::app);
+        segment.write("torn", 4);
+    }
+    
+    PriceStore store({.directory = directory});
+    auto station = *store.find("station-1");
+    CHECK(store.latest(station, FuelType::E10)->price == 1749);
+    CHECK(store.recordCount() == 2);
+    CHECK(fs::file_size(directory / "segment-00000001.log") == 2 * 24);
+    
+    // New records follow the valid ones
+    store.append({station, FuelType::E10, 3000, 1759});
+    std::vector<PriceRecord> records;
+    store.scan(0, 10000, [&](const PriceRecord& record) { records.push_back(record); });
+    REQUIRE(records.size() == 3);
+    CHECK(records.back().price == 1759);
+    
+    fs::remove_all(directory);
+}
+
+TEST_CASE("PriceStore rolls segments and skips them when scanning", "[store]") {
+    auto directory = freshDirectory("price-store-segments");
+    
+    {
+        PriceStore store({.directory = directory, .segmentBytes = 24 * 100, .bufferBytes = 24 * 8});
+        auto station = store.intern("station-1");
+        for (int i = 0; i < 1000; ++i) {
+            store.append({station, FuelType::E5, i, 1700 + i % 50});
+        }
+        CHECK(store.segmentCount() == 10);
+    }
+    
+    PriceStore store({.directory = directory, .segmentBytes = 24 * 100, .bufferBytes = 24 * 8});
+    CHECK(store.segmentCount() == 10);
+    CHECK(store.recordCount() == 1000);
+    
+    std::vector<models::EpochSeconds> timestamps;
+    store.scan(250, 260, [&](const PriceRecord& record) { timestamps.push_back(record.timestamp); });
+    REQUIRE(timestamps.size() == 10);
+    CHECK(timestamps.front() == 250);
+    CHECK(timestamps.back() == 259);
+    
+    CHECK_THROWS_AS(store.append({42, FuelType::E5, 0, 1799}), std::invalid_argument);
+    
+    fs::remove_all(directory);
+}
+
+TEST_CASE("PriceStore archives rolled segments", "[store]") {
+    auto directory = freshDirectory("price-store-archive");
+    PriceStore::Options options{.directory = directory, .segmentBytes = 24 * 1000, .bufferBytes = 24 * 8};
+    
+    {
+        PriceStore store(options);
+        auto first = store.intern("station-1");
+        auto second = store.intern("station-2");
+        for (int i = 0; i < 2500; ++i) {
+            store.append({i % 2 ? first : second, FuelType::E10, 1000 + i * 60, 1700 + (i % 5) * 10});
+        }
+        store.checkpoint();
+        
+        CHECK(fs::exists(directory / "segment-00000001.fpa"));
+        CHECK(fs::exists(directory / "segment-00000002.fpa"));
+        CHECK_FALSE(fs::exists(directory / "segment-00000001.log"));
+        CHECK(fs::exists(directory / "segment-00000003.log"));
+        CHECK(fs::file_size(directory / "segment-00000001.fpa") < 24 * 1000 / 4);
+        
+        size_t count = 0;
+        store.scan(1000 + 900 * 60, 1000 + 1100 * 60, [&](const PriceRecord&) { ++count; });
+        CHECK(count == 200);
+    }
+    
+    // Without the snapshot the latest prices come from the archives and the log
+    fs::remove(directory / "latest.snapshot");
+    fs::copy_file(directory / "segment-00000003.log", directory / "segment-00000002.log");  // left over from a crash
+    
+    PriceStore store(options);
+    CHECK(store.recordCount() == 2500);
+    CHECK(store.segmentCount() == 3);
+    CHECK_FALSE(fs::exists(directory / "segment-00000002.log"));
+    CHECK(store.latest(*store.find("station-1"), FuelType::E10)->timestamp == 1000 + 2499 * 60);
+    CHECK(store.latest(*store.find("station-2"), FuelType::E10)->timestamp == 1000 + 2498 * 60);
+    
+    fs::remove_all(directory);
+}
+
+TEST_CASE("ColumnarHistory groups records by station and fuel type in time order", "[store]") {
+    auto directory = freshDirectory("price-store-columns");
+    PriceStore store({.directory = directory});
+    auto first = store.intern("station-1");
+    auto second = store.intern("station-2");
+    
+    store.append({second, FuelType::E5, 3000, 1700});
+    store.append({first, FuelType::E5, 2000, 1799});
+    store.append({first, FuelType::Diesel, 2500, 1599});
+    store.append({first, FuelType::E5, 1000, 1819});  // imported out of order
+    store.append({first, FuelType::E5, 9000, 1789});  // outside the range
+    
+    auto history = ColumnarHistory::load(store, 0, 5000);
+    CHECK(history.recordCount() == 4);
+    CHECK(history.stationCount() == 2);
+    CHECK(history.bytes() == 4 * 12);
+    
+    auto e5 = history.column(first, FuelType::E5);
+    REQUIRE(e5.size() == 2);
+    CHECK(e5.timestamps[0] == 1000);
+    CHECK(e5.prices[0] == 1819);
+    CHECK(e5.timestamps[1] == 2000);
+    CHECK(e5.prices[1] == 1799);
+    
+    CHECK(history.column(first, FuelType::Diesel).size() == 1);
+    CHECK(history.column(second, FuelType::E5).prices[0] == 1700);
+    CHECK(history.column(second, FuelType::E10).empty());
+    CHECK(history.column(7, FuelType::E5).empty());
+    
+    fs::remove_all(directory);
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <random>
+#include "../include/analytics/PriceDistributions.hpp"
+#include "../include/analytics/QuantileSketch.hpp"
+#include "TimeFixtures.hpp"
+
+using namespace analytics;
+using Catch::Matchers::WithinAbs;
+using models::FuelType;
+
+namespace {
+
+// Fraction of the values below `value`, ties counted half
+double exactRank(const std::vector<double>& sorted, double value) {
+    auto below = std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+    auto upTo = std::upper_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+    return (static_cast<double>(below) + static_cast<double>(upTo)) / 2 / static_cast<double>(sorted.size());
+}
+
+std::vector<double> skewedPrices(size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    std::gamma_distribution<double> premium(2.0, 40.0);
+    std::vector<double> prices;
+    for (size_t i = 0; i < count; ++i) {
+        prices.push_back(1650 + std::round(premium(random)) * 1.0);
+    }
+    return prices;
+}
+
+} // namespace
+
+TEST_CASE("QuantileSketch estimates quantiles within a small rank error", "[sketch]") {
+    auto prices = skewedPrices(100000, 1);
+    QuantileSketch sketch;
+    for (auto price : prices) {
+        sketch.add(price);
+    }
+    std::sort(prices.begin(), prices.end());
+
+    CHECK(sketch.weight() == prices.size());
+    CHECK(sketch.min() == prices.front());
+    CHECK(sketch.max() == prices.back());
+
+    for (double q : {0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+        auto estimate = sketch.quantile(q);
+        REQUIRE(estimate);
+        CHECK_THAT(exactRank(prices, *estimate), WithinAbs(q, 0.01));
+    }
+    for (double price : {1660.0, 1700.0, 1750.0, 1850.0}) {
+        CHECK_THAT(*sketch.rank(price), WithinAbs(exactRank(prices, price), 0.01));
+    }
+
+    CHECK(*sketch.quantile(0.0) == prices.front());
+    CHECK(*sketch.quantile(1.0) == prices.back());
+    CHECK(*sketch.rank(prices.front() - 1) == 0.0);
+    CHECK(*sketch.rank(prices.back() + 1) == 1.0);
+
+    // Fixed size, whatever was added
+    CHECK(sizeof(QuantileSketch) <= 1100);
+    CHECK_FALSE(QuantileSketch{}.quantile(0.5));
+}
+
+TEST_CASE("QuantileSketch merges into a sketch of the union", "[sketch]") {
+    auto prices = skewedPrices(50000, 2);
+
+    QuantileSketch merged;
+    for (size_t part = 0; part < 25; ++part) {
+        QuantileSketch sketch;
+        for (size_t i = part; i < prices.size(); i += 25) {
+            sketch.add(prices[i]);
+        }
+        merged.merge(sketch);
+    }
+    std::sort(prices.begin(), prices.end());
+
+    CHECK(merged.weight() == prices.size());
+    for (double q : {0.05, 0.1, 0.5, 0.9}) {
+        CHECK_THAT(exactRank(prices, *merged.quantile(q)), WithinAbs(q, 0.015));
+    }
+
+    // Weights count like repeated values, and equal values rank in the middle
+    QuantileSketch weighted;
+    weighted.add(1700, 3.0);
+    weighted.add(1800, 1.0);
+    CHECK(weighted.weight() == 4.0);
+    CHECK(*weighted.rank(1700) == 0.375);
+    CHECK(*weighted.rank(1800) == 0.875);
+}
+
+TEST_CASE("PriceDistributions answer percentiles per region and for the area", "[sketch]") {
+    PriceDistributions distributions;
+
+    // Region 0 is cheap, region 1 expensive; prices seen every five minutes
+    for (auto time = MONDAY; time < MONDAY + 3 * HOUR; time += 300) {
+        for (int station = 0; station < 20; ++station) {
+            distributions.observe(0, FuelType::E10, time, 1700 + station, std::chrono::minutes(5));
+            distributions.observe(1, FuelType::E10, time, 1800 + station, std::chrono::minutes(5));
+        }
+    }
+
+    PriceDistributions::Query lastHour{.fuelType = FuelType::E10, .from = MONDAY + 2 * HOUR, .to = MONDAY + 3 * HOUR, .regions = {}};
+    auto area = distributions.distribution(lastHour);
+    CHECK(area.weight() == 40 * HOUR);
+    CHECK_THAT(*area.rank(1700), WithinAbs(0.0125, 0.01));
+    CHECK_THAT(*area.rank(1810), WithinAbs(0.75, 0.02));
+
+    // The cheapest 10% of the area are the four cheapest prices of region 0
+    CHECK(*distributions.percentile(lastHour, 0.1) <= 1704.5);
+
+    lastHour.regions = {1};
+    CHECK(*distributions.percentile(lastHour, 0.0) == 1800);
+    CHECK_THAT(*distributions.rank(lastHour, 1810), WithinAbs(0.525, 0.03));
+    lastHour.regions = {0, 1};
+    CHECK(distributions.distribution(lastHour).weight() == 40 * HOUR);
+    lastHour.regions = {7};
+    CHECK(distributions.distribution(lastHour).empty());
+    CHECK_FALSE(distributions.percentile({.fuelType = FuelType::Diesel, .from = MONDAY, .to = MONDAY + HOUR, .regions = {}}, 0.5));
+
+    // Once the hourly track has moved on, whole local days are used
+    distributions.observe(0, FuelType::E10, MONDAY + 5 * DAY, 1600, std::chrono::minutes(5));
+    auto monday = distributions.distribution({.fuelType = FuelType::E10, .from = MONDAY + HOUR, .to = MONDAY + 2 * HOUR, .regions = {}});
+    CHECK(monday.weight() == 40 * 3 * HOUR);
+}
+
+TEST_CASE("PriceDistributions backfill the area from stored history", "[sketch]") {
+    std::vector<storage::PriceRecord> records = {
+        {0, FuelType::E5, MONDAY, 1800},
+        {0, FuelType::E5, MONDAY + 3 * HOUR, 1700},
+        {1, FuelType::E5, MONDAY, 1900},
+        {1, FuelType::Diesel, MONDAY, 1600},
+    };
+    auto history = storage::ColumnarHistory::build(records);
+
+    PriceDistributions distributions;
+    distributions.backfill(history, FuelType::E5, MONDAY + 4 * HOUR);
+
+    PriceDistributions::Query query{.fuelType = FuelType::E5, .from = MONDAY, .to = MONDAY + 4 * HOUR, .regions = {}};
+    auto sketch = distributions.distribution(query);
+    CHECK(sketch.weight() == 8 * HOUR);
+    CHECK(sketch.min() == 1700);
+    CHECK(sketch.max() == 1900);
+    CHECK(*distributions.rank(query, 1800) == (1 + 1.5) / 8);
+
+    query.fuelType = FuelType::Diesel;
+    CHECK(distributions.distribution(query).empty());
+}
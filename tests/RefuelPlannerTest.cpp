@@ -0,0 +1,223 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <limits>
+#include <random>
+#include "../include/utils/RefuelPlanner.hpp"
+
+using namespace utils;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+RefuelPlanner::Candidate candidate(const std::string& id, double position, double price, double detour = 0.0) {
+    return {id, position, detour, price};
+}
+
+// Cheapest cost over whole litres, stepping one km at a time, for stations
+// on the route at whole km and a consumption of 1 l/km
+double bruteForce(const RefuelPlanner::Trip& trip, const std::vector<RefuelPlanner::Candidate>& candidates) {
+    constexpr double NONE = std::numeric_limits<double>::infinity();
+    auto length = static_cast<int>(trip.routeLength);
+    auto capacity = static_cast<int>(trip.tankCapacity);
+
+    std::vector<double> cheapest(length + 1, NONE);
+    for (const auto& candidate : candidates) {
+        auto at = static_cast<int>(candidate.position);
+        cheapest[at] = std::min(cheapest[at], candidate.price);
+    }
+
+    std::vector<double> cost(capacity + 1, NONE);
+    cost[static_cast<int>(trip.fuel)] = 0.0;
+    for (int position = 0;; ++position) {
+        if (cheapest[position] < NONE) {
+            for (int fuel = 1; fuel <= capacity; ++fuel) {
+                cost[fuel] = std::min(cost[fuel], cost[fuel - 1] + cheapest[position]);
+            }
+        }
+        if (position == length) break;
+
+        std::vector<double> driven(capacity + 1, NONE);
+        for (int fuel = 1; fuel <= capacity; ++fuel) {
+            driven[fuel - 1] = cost[fuel];
+        }
+        cost = std::move(driven);
+    }
+    return *std::min_element(cost.begin() + static_cast<int>(trip.arrivalFuel), cost.end());
+}
+
+} // namespace
+
+TEST_CASE("RefuelPlanner buys just enough to reach cheaper fuel", "[refuel]") {
+    RefuelPlanner::Trip trip;
+    trip.routeLength = 600;
+    trip.tankCapacity = 50;
+    trip.consumption = 10;  // 500 km on a full tank
+    trip.fuel = 10;         // 100 km
+
+    auto plan = RefuelPlanner::plan(trip, {
+        candidate("expensive", 80, 1.90),
+        candidate("cheap", 300, 1.60),
+        candidate("average", 450, 1.75),
+    });
+    REQUIRE(plan.feasible);
+    CHECK(plan.reach == 600);
+    REQUIRE(plan.stops.size() == 2);
+
+    // 200 km more to the cheap station, arriving empty, then enough for the rest
+    CHECK(plan.stops[0].stationId == "expensive");
+    CHECK_THAT(plan.stops[0].litres, WithinAbs(20, 1e-9));
+    CHECK_THAT(plan.stops[0].arrivalFuel, WithinAbs(2, 1e-9));
+    CHECK(plan.stops[1].stationId == "cheap");
+    CHECK_THAT(plan.stops[1].litres, WithinAbs(30, 1e-9));
+    CHECK_THAT(plan.stops[1].arrivalFuel, WithinAbs(0, 1e-9));
+    CHECK_THAT(plan.cost, WithinAbs(20 * 1.90 + 30 * 1.60, 1e-9));
+    CHECK_THAT(plan.litres, WithinAbs(50, 1e-9));
+
+    // Fuel wanted on arrival is bought where it is cheapest
+    trip.arrivalFuel = 20;
+    plan = RefuelPlanner::plan(trip, {candidate("expensive", 80, 1.90), candidate("cheap", 300, 1.60),
+                                      candidate("average", 450, 1.75)});
+    REQUIRE(plan.stops.size() == 2);
+    CHECK_THAT(plan.stops[1].litres, WithinAbs(50, 1e-9));
+    CHECK_THAT(plan.stops[1].arrivalFuel, WithinAbs(0, 1e-9));
+
+    // Enough fuel on board, no stops
+    trip.fuel = 50;
+    trip.arrivalFuel = 0;
+    trip.routeLength = 400;
+    plan = RefuelPlanner::plan(trip, {candidate("cheap", 300, 1.60)});
+    CHECK(plan.feasible);
+    CHECK(plan.stops.empty());
+    CHECK(plan.cost == 0);
+}
+
+TEST_CASE("RefuelPlanner weighs detours and keeps the reserve", "[refuel]") {
+    RefuelPlanner::Trip trip;
+    trip.routeLength = 300;
+    trip.tankCapacity = 50;
+    trip.consumption = 10;
+    trip.fuel = 10;
+    trip.reserve = 5;  // 50 km on board above the reserve
+
+    // 10 km off the route to save a cent: not worth it
+    auto plan = RefuelPlanner::plan(trip, {candidate("on route", 50, 1.80), candidate("off route", 60, 1.79, 10)});
+    REQUIRE(plan.stops.size() == 1);
+    CHECK(plan.stops[0].stationId == "on route");
+    CHECK_THAT(plan.stops[0].litres, WithinAbs(25, 1e-9));
+    CHECK_THAT(plan.stops[0].arrivalFuel, WithinAbs(5, 1e-9));
+
+    // 2 km off the route to save 20 cents: worth it, and the detour is paid
+    plan = RefuelPlanner::plan(trip, {candidate("on route", 50, 1.80), candidate("off route", 60, 1.60, 2)});
+    REQUIRE(plan.stops.size() == 2);
+    CHECK(plan.stops[0].stationId == "on route");
+    CHECK_THAT(plan.stops[0].litres, WithinAbs(1, 1e-9));
+    CHECK(plan.stops[1].stationId == "off route");
+    CHECK_THAT(plan.stops[1].litres, WithinAbs(24 + 0.2, 1e-9));
+    CHECK_THAT(plan.stops[1].arrivalFuel, WithinAbs(5, 1e-9));
+
+    // Starting below the reserve, the tank is not driven any further before a stop
+    trip.fuel = 3;
+    plan = RefuelPlanner::plan(trip, {candidate("on route", 50, 1.80)});
+    CHECK_FALSE(plan.feasible);
+    CHECK(plan.reach == 0);
+
+    plan = RefuelPlanner::plan(trip, {candidate("at start", 0, 1.80), candidate("on route", 50, 1.80)});
+    REQUIRE(plan.feasible);
+    REQUIRE(plan.stops.size() == 1);
+    CHECK(plan.stops[0].stationId == "at start");
+    CHECK_THAT(plan.stops[0].litres, WithinAbs(30, 1e-9));
+    CHECK_THAT(plan.stops[0].arrivalFuel, WithinAbs(3, 1e-9));
+}
+
+TEST_CASE("RefuelPlanner reports where a route cannot be driven", "[refuel]") {
+    RefuelPlanner::Trip trip;
+    trip.routeLength = 1000;
+    trip.tankCapacity = 50;
+    trip.consumption = 10;
+    trip.fuel = 20;
+
+    auto plan = RefuelPlanner::plan(trip, {candidate("a", 150, 1.70), candidate("b", 900, 1.70),
+                                           candidate("beyond", 1200, 1.00), candidate("no price", 700, 0.0)});
+    CHECK_FALSE(plan.feasible);
+    CHECK(plan.reach == 650);
+
+    CHECK_THROWS_AS(RefuelPlanner::plan({.routeLength = 100, .tankCapacity = 0}, {}), std::invalid_argument);
+    CHECK_THROWS_AS(RefuelPlanner::plan({.routeLength = 100, .tankCapacity = 50, .fuel = 60}, {}),
+                    std::invalid_argument);
+}
+
+TEST_CASE("RefuelPlanner matches an exhaustive search", "[refuel]") {
+    std::mt19937 random(24);
+    std::uniform_int_distribution<int> price(150, 200);
+
+    for (int round = 0; round < 200; ++round) {
+        RefuelPlanner::Trip trip;
+        trip.routeLength = 40;
+        trip.tankCapacity = 8;
+        trip.consumption = 100;  // 1 l/km
+        trip.fuel = static_cast<double>(round % 9);
+        trip.arrivalFuel = static_cast<double>(round % 3);
+
+        std::uniform_int_distribution<int> position(0, 40);
+        std::vector<RefuelPlanner::Candidate> candidates;
+        for (int i = 0; i < 12; ++i) {
+            candidates.push_back(candidate(std::to_string(i), position(random), price(random) / 100.0));
+        }
+
+        auto plan = RefuelPlanner::plan(trip, candidates);
+        auto expected = bruteForce(trip, candidates);
+        if (expected == std::numeric_limits<double>::infinity()) {
+            CHECK_FALSE(plan.feasible);
+        } else {
+            REQUIRE(plan.feasible);
+            CHECK_THAT(plan.cost, WithinAbs(expected, 1e-9));
+        }
+    }
+}
+
+TEST_CASE("RefuelPlanner reads prices of open stations", "[refuel]") {
+    models::FuelStation station{};
+    station.isOpen = true;
+    station.prices = {{"e5", 1.799, ""}, {"diesel", 1.659, ""}, {"e10", 0.0, ""}};
+
+    CHECK(RefuelPlanner::price(station, "diesel") == 1.659);
+    CHECK_FALSE(RefuelPlanner::price(station, "e10"));
+    CHECK_FALSE(RefuelPlanner::price(station, "lpg"));
+
+    station.isOpen = false;
+    CHECK_FALSE(RefuelPlanner::price(station, "e5"));
+}
+
+TEST_CASE("RefuelPlanner plans from located corridor stations", "[refuel]") {
+    auto located = [](const std::string& id, double chainage, double offset, double diesel) {
+        RouteStation station{};
+        station.station.id = id;
+        station.station.isOpen = true;
+        station.station.prices = {{"diesel", diesel, ""}};
+        station.chainage = chainage;
+        station.offset = offset;
+        station.detour = 2 * offset;
+        return station;
+    };
+    std::vector<RouteStation> stations = {
+        located("a", 40, 0.5, 1.70),
+        located("b", 120, 1.0, 1.60),
+        located("petrol only", 130, 0.0, 0.0),
+    };
+
+    auto candidates = RefuelPlanner::candidates(stations, "diesel");
+    REQUIRE(candidates.size() == 2);
+    CHECK(candidates[1].stationId == "b");
+    CHECK(candidates[1].position == 120);
+    CHECK(candidates[1].detour == 2.0);
+    CHECK(candidates[1].price == 1.60);
+
+    RefuelPlanner::Trip trip;
+    trip.routeLength = 300;
+    trip.fuel = 5;  // 71 km
+    auto plan = RefuelPlanner::plan(trip, candidates);
+    REQUIRE(plan.feasible);
+    REQUIRE(plan.stops.size() == 2);
+    CHECK(plan.stops[0].stationId == "a");
+    CHECK(plan.stops[1].stationId == "b");
+}
@@ -0,0 +1,27 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../include/api/RequestEngine.hpp"
+#include <stdexcept>
+
+using namespace api;
+
+namespace {
+
+// Nothing listens on port 1, so transfers fail fast without network access
+constexpr const char* UNREACHABLE_URL = "http://127.0.0.1:1/list.php";
+
+} // namespace
+
+TEST_CASE("RequestEngine survives a throwing completion", "[engine]") {
+    RequestEngine engine;
+    
+    std::promise<void> thrown;
+    engine.submit({.url = UNREACHABLE_URL, .headers = {}}, [&](std::exception_ptr, HttpResponse) {
+        thrown.set_value();
+        throw std::runtime_error("decoder failed");
+    });
+    thrown.get_future().get();
+    
+    // The worker thread keeps serving requests afterwards
+    auto next = engine.submit({.url = UNREACHABLE_URL, .headers = {}});
+    REQUIRE_THROWS(next.get());
+}
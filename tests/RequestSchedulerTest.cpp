@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../include/api/RequestScheduler.hpp"
+#include <thread>
+
+using namespace api;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Nothing listens on port 1, so transfers fail fast without network access
+constexpr const char* UNREACHABLE_URL = "http://127.0.0.1:1/list.php";
+
+} // namespace
+
+TEST_CASE("RequestScheduler coalesces identical requests", "[scheduler]") {
+    // A single token, refilled after a second: once the blocker has spent
+    // it, the identical requests wait in the queue and cannot complete
+    // before the second one is submitted
+    RequestScheduler::Options options;
+    options.requestsPerMinute = 60;
+    options.burst = 1;
+    RequestScheduler scheduler(RequestEngine::Options{}, options);
+    
+    auto blocker = scheduler.submit({.url = std::string(UNREACHABLE_URL) + "?blocker", .headers = {}}, Priority::PricePoll);
+    auto first = scheduler.submit({.url = UNREACHABLE_URL, .headers = {}}, Priority::Discovery);
+    auto second = scheduler.submit({.url = UNREACHABLE_URL, .headers = {}}, Priority::PricePoll);
+    
+    auto metrics = scheduler.metrics();
+    CHECK(metrics[static_cast<size_t>(Priority::Discovery)].dispatched == 0);
+    CHECK(metrics[static_cast<size_t>(Priority::PricePoll)].coalesced == 1);
+    
+    // The next token releases the shared request
+    REQUIRE_THROWS(blocker.get());
+    REQUIRE_THROWS(first.get());
+    REQUIRE_THROWS(second.get());
+    
+    metrics = scheduler.metrics();
+    CHECK(metrics[static_cast<size_t>(Priority::Discovery)].submitted == 1);
+    CHECK(metrics[static_cast<size_t>(Priority::PricePoll)].submitted == 2);
+    CHECK(metrics[static_cast<size_t>(Priority::PricePoll)].coalesced == 1);
+    
+    uint64_t dispatched = 0;
+    for (const auto& m : metrics) dispatched += m.dispatched;
+    CHECK(dispatched == 2);
+}
+
+TEST_CASE("RequestScheduler holds requests beyond the token budget", "[scheduler]") {
+    RequestScheduler::Options options;
+    options.requestsPerMinute = 1;
+    options.burst = 1;
+    
+    std::shared_future<HttpResponse> queued;
+    {
+        RequestScheduler scheduler(RequestEngine::Options{}, options);
+        
+        auto first = scheduler.submit({.url = std::string(UNREACHABLE_URL) + "?a", .headers = {}}, Priority::DetailHydration);
+        queued = scheduler.submit({.url = std::string(UNREACHABLE_URL) + "?b", .headers = {}}, Priority::DetailHydration);
+        
+        REQUIRE_THROWS(first.get());
+        std::this_thread::sleep_for(50ms);
+        
+        CHECK(queued.wait_for(0s) == std::future_status::timeout);
+        
+        auto metrics = scheduler.metrics()[static_cast<size_t>(Priority::DetailHydration)];
+        CHECK(metrics.submitted == 2);
+        CHECK(metrics.dispatched == 1);
+    }
+    
+    // Requests still waiting for a token fail on shutdown instead of hanging
+    REQUIRE_THROWS(queued.get());
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../include/api/ResponseCache.hpp"
+#include <filesystem>
+
+using namespace api;
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+TEST_CASE("ResponseCache keys ignore the API key", "[cache]") {
+    auto key = ResponseCache::makeKey("list.php", {
+        {"lat", "52.520008"},
+        {"lng", "13.404954"},
+        {"apikey", "secret"}
+    });
+    
+    CHECK(key == "list.php?lat=52.520008&lng=13.404954");
+    CHECK(key == ResponseCache::makeKey("list.php", {{"lng", "13.404954"}, {"lat", "52.520008"}, {"apikey", "other"}}));
+}
+
+TEST_CASE("ResponseCache applies per-endpoint TTLs", "[cache]") {
+    ResponseCache::Options options;
+    options.ttls["list.php"] = 60s;
+    options.ttls["detail.php"] = 24h;
+    ResponseCache cache(options);
+    
+    auto now = ResponseCache::Clock::now();
+    cache.store("list.php?a=1", {.body = "list", .etag = "", .lastModified = "", .storedAt = now});
+    cache.store("detail.php?id=1", {.body = "detail", .etag = "\"v1\"", .lastModified = "", .storedAt = now});
+    
+    SECTION("Fresh entries") {
+        auto hit = cache.lookup("list.php?a=1", "list.php", now + 30s);
+        REQUIRE(hit.has_value());
+        CHECK(hit->fresh);
+        CHECK(hit->entry.body == "list");
+    }
+    
+    SECTION("Stale entries are still returned for revalidation") {
+        auto hit = cache.lookup("list.php?a=1", "list.php", now + 61s);
+        REQUIRE(hit.has_value());
+        CHECK_FALSE(hit->fresh);
+        
+        auto detail = cache.lookup("detail.php?id=1", "detail.php", now + 61s);
+        REQUIRE(detail.has_value());
+        CHECK(detail->fresh);
+        CHECK(detail->entry.etag == "\"v1\"");
+    }
+    
+    SECTION("Refresh restarts the TTL") {
+        cache.refresh("list.php?a=1", now + 61s);
+        
+        auto hit = cache.lookup("list.php?a=1", "list.php", now + 90s);
+        REQUIRE(hit.has_value());
+        CHECK(hit->fresh);
+    }
+    
+    SECTION("Unknown keys miss") {
+        CHECK_FALSE(cache.lookup("list.php?a=2", "list.php", now).has_value());
+    }
+}
+
+TEST_CASE("ResponseCache evicts least recently used entries", "[cache]") {
+    ResponseCache::Options options;
+    options.memoryBytes = 50;  // room for two 21-byte entries
+    ResponseCache cache(options);
+    
+    auto now = ResponseCache::Clock::now();
+    cache.store("a", {.body = std::string(20, 'a'), .etag = "", .lastModified = "", .storedAt = now});
+    cache.store("b", {.body = std::string(20, 'b'), .etag = "", .lastModified = "", .storedAt = now});
+    
+    // Touch "a" so that "b" is the oldest entry
+    REQUIRE(cache.lookup("a", "list.php", now).has_value());
+    cache.store("c", {.body = std::string(20, 'c'), .etag = "", .lastModified = "", .storedAt = now});
+    
+    CHECK(cache.lookup("a", "list.php", now).has_value());
+    CHECK_FALSE(cache.lookup("b", "list.php", now).has_value());
+    CHECK(cache.lookup("c", "list.php", now).has_value());
+}
+
+TEST_CASE("ResponseCache persists entries on disk", "[cache]") {
+    fs::path directory = fs::temp_directory_path() / "response_cache_test";
+    fs::remove_all(directory);
+    
+    ResponseCache::Options options;
+    options.directory = directory;
+    auto now = ResponseCache::Clock::now();
+    
+    {
+        ResponseCache cache(options);
+        cache.store("detail.php?id=1", {
+            .body = "{\"ok\":true}\nsecond line",
+            .etag = "\"v1\"",
+            .lastModified = "Tue, 20 Jan 2024 10:00:00 GMT",
+            .storedAt = now
+        });
+    }
+    
+    ResponseCache cache(options);
+    auto hit = cache.lookup("detail.php?id=1", "detail.php", now);
+    
+    REQUIRE(hit.has_value());
+    CHECK(hit->entry.body == "{\"ok\":true}\nsecond line");
+    CHECK(hit->entry.etag == "\"v1\"");
+    CHECK(hit->entry.lastModified == "Tue, 20 Jan 2024 10:00:00 GMT");
+    
+    fs::remove_all(directory);
+}
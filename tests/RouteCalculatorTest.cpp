@@ -76,6 +76,28 @@ TEST_CASE("RouteCalculator can find stations along route", "[route]") {
         REQUIRE(result.size() == 3);
     }
     
+    SECTION("Find stations that share an ID or have none") {
+        FuelStation twin = station1;
+        twin.name = "Station 1 twin";
+        twin.location.longitude += 0.01;
+        FuelStation unnamed;
+        unnamed.location = station2.location;
+        FuelStation anonymous = unnamed;
+        stations.push_back(twin);
+        stations.push_back(unnamed);
+        stations.push_back(anonymous);
+        
+        auto result = RouteCalculator::findStationsAlongRoute(waypoints, stations, 5.0);
+        REQUIRE(result.size() == 5);
+        CHECK(result[0].name == "Station 1");
+        CHECK(result[1].name == "Station 2");
+        CHECK(result[2].id.empty());
+        CHECK(result[3].id.empty());
+        CHECK(result[4].name == "Station 1 twin");
+        
+        CHECK(RouteCalculator::locateStationsAlongRoute(waypoints, stations, 5.0).size() == 5);
+    }
+    
     SECTION("Find stations with empty waypoints") {
         std::vector<Waypoint> emptyWaypoints;
         auto result = RouteCalculator::findStationsAlongRoute(emptyWaypoints, stations, 5.0);
@@ -136,4 +158,57 @@ TEST_CASE("RouteCalculator can check if point is in corridor", "[route]") {
         
         CHECK(inCorridor);
     }
-} 
\ No newline at end of file
+}
+
+TEST_CASE("RouteCalculator locates stations along the route", "[route]") {
+    // East along the 50th parallel, then back west slightly further north
+    std::vector<Waypoint> waypoints = {
+        {50.00, 10.0},
+        {50.00, 11.0},
+        {50.05, 10.0}
+    };
+
+    auto makeStation = [](const std::string& id, double latitude, double longitude) {
+        FuelStation station{};
+        station.id = id;
+        station.location.latitude = latitude;
+        station.location.longitude = longitude;
+        return station;
+    };
+    std::vector<FuelStation> stations = {
+        makeStation("way back", 50.045, 10.5),  // 5 km off the way out, closer to the way back
+        makeStation("late", 50.001, 10.8),
+        makeStation("early", 50.001, 10.2),
+        makeStation("far", 50.5, 10.5)
+    };
+
+    auto result = RouteCalculator::locateStationsAlongRoute(waypoints, stations, 6.0);
+    REQUIRE(result.size() == 3);
+    CHECK(result[0].station.id == "early");
+    CHECK(result[1].station.id == "late");
+    CHECK(result[2].station.id == "way back");
+
+    double firstLeg = RouteCalculator::calculateDistance(50.0, 10.0, 50.0, 11.0);
+    CHECK(result[0].segment == 0);
+    CHECK_THAT(result[0].chainage, Catch::Matchers::WithinRel(0.2 * firstLeg, 0.01));
+    CHECK_THAT(result[0].offset, Catch::Matchers::WithinAbs(0.11, 0.01));
+    CHECK(result[0].station.distance == result[0].offset);
+    CHECK(result[0].detour > 2 * result[0].offset);
+
+    // The closest segment, not the first one within the corridor
+    CHECK(result[2].segment == 1);
+    CHECK(result[2].offset < 3.0);
+    CHECK(result[2].chainage > firstLeg);
+    CHECK(result[2].chainage < RouteCalculator::routeLength(waypoints));
+
+    auto ahead = RouteCalculator::stationsAhead(result, result[1].chainage);
+    REQUIRE(ahead.size() == 2);
+    CHECK(ahead[0].station.id == "late");
+    CHECK(RouteCalculator::stationsAhead(result, 1000.0).empty());
+
+    // The distance-ordered search measures against the closest segment too
+    auto byDistance = RouteCalculator::findStationsAlongRoute(waypoints, stations, 6.0);
+    REQUIRE(byDistance.size() == 3);
+    CHECK(byDistance[2].id == "way back");
+    CHECK(byDistance[2].distance == result[2].offset);
+}
@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/utils/RouteImporter.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace utils;
+using Catch::Matchers::WithinAbs;
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path writeFile(const std::string& name, const std::string& content) {
+    auto path = fs::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+}
+
+std::vector<Waypoint> readAll(std::string_view text, RouteImporter::Format format, int precision = 5) {
+    std::vector<Waypoint> points;
+    RouteImporter::read(text, format, [&](const Waypoint& point) { points.push_back(point); }, precision);
+    return points;
+}
+
+} // namespace
+
+TEST_CASE("RouteImporter reads GPX tracks and routes", "[route][import]") {
+    auto track = readAll(R"(<?xml version="1.0"?>
+<gpx version="1.1" creator="test">
+  <wpt lat="1.0" lon="1.0"><name>Home</name></wpt>
+  <rte><rtept lat="9.0" lon="9.0"/></rte>
+  <trk><trkseg>
+    <trkpt lat="52.5200" lon="13.4050"><ele>34</ele></trkpt>
+    <trkpt lon='13.41' lat='52.53'/>
+    <trkpt
+        lat = "52.54" lon="13.42" ></trkpt>
+  </trkseg></trk>
+</gpx>)", RouteImporter::Format::Gpx);
+    REQUIRE(track.size() == 3);
+    CHECK(track[0].latitude == 52.52);
+    CHECK(track[0].longitude == 13.405);
+    CHECK(track[1].latitude == 52.53);
+    CHECK(track[1].longitude == 13.41);
+    CHECK(track[2].latitude == 52.54);
+
+    // Without a track the route points are used
+    auto route = readAll(R"(<gpx><rte><rtept lat="48.1" lon="11.5"/><rtept lat="48.2" lon="11.6"/></rte></gpx>)",
+                         RouteImporter::Format::Gpx);
+    REQUIRE(route.size() == 2);
+    CHECK(route[1].longitude == 11.6);
+
+    CHECK_THROWS_AS(readAll(R"(<gpx><trk><trkpt lat="48.1"/></trk></gpx>)", RouteImporter::Format::Gpx),
+                    std::runtime_error);
+    CHECK_THROWS_AS(readAll(R"(<gpx><trk><trkpt lat="north" lon="11.5"/></trk></gpx>)", RouteImporter::Format::Gpx),
+                    std::runtime_error);
+}
+
+TEST_CASE("RouteImporter reads GeoJSON line strings", "[route][import]") {
+    auto points = readAll(R"({
+        "type": "FeatureCollection",
+        "features": [
+            {"type": "Feature", "properties": {"name": "start"},
+             "geometry": {"type": "Point", "coordinates": [1.0, 2.0]}},
+            {"type": "Feature", "properties": {"tags": ["a", "type"]},
+             "geometry": {"coordinates": [[13.40, 52.52], [13.41, 52.53, 34.0]], "type": "LineString"}},
+            {"type": "Feature", "properties": {},
+             "geometry": {"type": "MultiLineString", "coordinates": [[[13.42, 52.54]], [[13.43, 52.55]]]}},
+            {"type": "Feature", "properties": {},
+             "geometry": {"type": "Polygon", "coordinates": [[[0, 0], [1, 0], [1, 1], [0, 0]]]}}
+        ]
+    })", RouteImporter::Format::GeoJson);
+    REQUIRE(points.size() == 4);
+    CHECK(points[0].latitude == 52.52);
+    CHECK(points[0].longitude == 13.40);
+    CHECK(points[1].latitude == 52.53);
+    CHECK(points[3].latitude == 52.55);
+    CHECK(points[3].longitude == 13.43);
+
+    // A bare geometry works as well
+    CHECK(readAll(R"({"type": "LineString", "coordinates": [[6, 50], [7, 51]]})",
+                  RouteImporter::Format::GeoJson).size() == 2);
+    CHECK_THROWS_AS(readAll(R"({"type": "LineString", "coordinates": [[6, 50)", RouteImporter::Format::GeoJson),
+                    std::runtime_error);
+}
+
+TEST_CASE("RouteImporter decodes encoded polylines", "[route][import]") {
+    // The example from Google's documentation
+    auto points = readAll("_p~iF~ps|U_ulLnnqC_mqNvxq`@\n", RouteImporter::Format::Polyline);
+    REQUIRE(points.size() == 3);
+    CHECK_THAT(points[0].latitude, WithinAbs(38.5, 1e-9));
+    CHECK_THAT(points[0].longitude, WithinAbs(-120.2, 1e-9));
+    CHECK_THAT(points[1].latitude, WithinAbs(40.7, 1e-9));
+    CHECK_THAT(points[1].longitude, WithinAbs(-120.95, 1e-9));
+    CHECK_THAT(points[2].latitude, WithinAbs(43.252, 1e-9));
+    CHECK_THAT(points[2].longitude, WithinAbs(-126.453, 1e-9));
+
+    auto precise = readAll("_p~iF~ps|U", RouteImporter::Format::Polyline, 6);
+    REQUIRE(precise.size() == 1);
+    CHECK_THAT(precise[0].latitude, WithinAbs(3.85, 1e-9));
+
+    CHECK(readAll("", RouteImporter::Format::Polyline).empty());
+    CHECK_THROWS_AS(readAll("_p~iF", RouteImporter::Format::Polyline), std::runtime_error);
+    CHECK_THROWS_AS(readAll("_p~iF~ps|U !", RouteImporter::Format::Polyline), std::runtime_error);
+}
+
+TEST_CASE("RouteImporter simplifies within the tolerance", "[route][import]") {
+    std::mt19937 random(23);
+    std::normal_distribution<double> noise(0.0, 0.00005);
+
+    // A noisy drive north, a sharp turn east and a stretch with a repeated point
+    std::vector<Waypoint> points;
+    for (int i = 0; i < 5000; ++i) {
+        points.push_back({48.0 + i * 0.0002 + noise(random), 11.0 + noise(random)});
+    }
+    for (int i = 1; i < 5000; ++i) {
+        points.push_back({49.0 + noise(random), 11.0 + i * 0.0003 + noise(random)});
+    }
+    points.push_back(points.back());
+
+    double tolerance = 0.05;
+    auto simplified = RouteImporter::simplify(points, tolerance);
+    CHECK(simplified.size() >= 3);
+    CHECK(simplified.size() < 100);
+    CHECK(simplified.front().latitude == points.front().latitude);
+    CHECK(simplified.back().longitude == points.back().longitude);
+
+    // Every point is within the tolerance of the simplified route
+    for (const auto& point : points) {
+        bool covered = false;
+        for (size_t i = 0; i + 1 < simplified.size() && !covered; ++i) {
+            covered = RouteCalculator::isPointInCorridor(simplified[i], simplified[i + 1], point.latitude,
+                                                         point.longitude, tolerance);
+        }
+        CHECK(covered);
+    }
+
+    CHECK(RouteImporter::simplify(points, 0.0).size() == points.size());
+    CHECK(RouteImporter::simplify(std::span(points).first(2), tolerance).size() == 2);
+}
+
+TEST_CASE("RouteImporter loads files by extension", "[route][import]") {
+    auto gpx = writeFile("route_import_test.gpx",
+                         R"(<gpx><trk><trkseg><trkpt lat="48.0" lon="11.0"/><trkpt lat="48.5" lon="11.0"/>)"
+                         R"(<trkpt lat="49.0" lon="11.0"/></trkseg></trk></gpx>)");
+    auto geojson = writeFile("route_import_test.geojson",
+                             R"({"type": "LineString", "coordinates": [[11.0, 48.0], [11.0, 48.5], [11.0, 49.0]]})");
+    auto polyline = writeFile("route_import_test.txt", "_p~iF~ps|U_ulLnnqC_mqNvxq`@");
+
+    RouteImporter::Options keepAll;
+    keepAll.tolerance = 0.0;
+    CHECK(RouteImporter::load(gpx, keepAll).size() == 3);
+    CHECK(RouteImporter::load(geojson, keepAll).size() == 3);
+    CHECK(RouteImporter::load(polyline, keepAll).size() == 3);
+
+    // The middle point lies on the line
+    CHECK(RouteImporter::load(gpx).size() == 2);
+    CHECK(RouteImporter::load(geojson).size() == 2);
+
+    fs::remove(gpx);
+    fs::remove(geojson);
+    fs::remove(polyline);
+}
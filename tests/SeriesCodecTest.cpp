@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <random>
+#include "../include/storage/SeriesArchive.hpp"
+
+using namespace storage;
+using models::FuelType;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Changes a few cents at a time, clustered around the same minutes of the day
+std::vector<PriceRecord> realisticSeries(models::StationHandle station, FuelType fuelType, size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    std::discrete_distribution<int> step({5, 20, 30, 10, 30, 5});  // -3 .. +2 cents
+    std::uniform_int_distribution<models::EpochSeconds> minutes(1, 240);
+
+    std::vector<PriceRecord> records;
+    models::EpochSeconds timestamp = 1704067200;
+    models::TenthCents price = 1789;
+    for (size_t i = 0; i < count; ++i) {
+        timestamp += minutes(random) * 60 + (i % 7 == 0 ? 1 : 0);
+        price = std::max(1009, price + (step(random) - 3) * 10);
+        records.push_back({station, fuelType, timestamp, price});
+    }
+    return records;
+}
+
+} // namespace
+
+TEST_CASE("SeriesCodec round-trips blocks", "[codec]") {
+    std::vector<models::EpochSeconds> timestamps = {
+        1000, 1060, 1120, 1180, 1181, 5000, 5000, 900000000, 900000001, 4000000000
+    };
+    std::vector<models::TenthCents> prices = {
+        1789, 1799, 1799, 1649, 1650, 2999, 1009, 1009, 999999, 1
+    };
+    
+    std::vector<uint8_t> encoded;
+    auto size = SeriesCodec::encode(timestamps, prices, encoded);
+    CHECK(encoded.size() == size + SeriesCodec::PADDING);
+    
+    std::vector<models::EpochSeconds> decodedTimestamps(timestamps.size());
+    std::vector<models::TenthCents> decodedPrices(prices.size());
+    SeriesCodec::decode(encoded.data(), timestamps.size(), timestamps[0], prices[0],
+                        decodedTimestamps.data(), decodedPrices.data());
+    CHECK(decodedTimestamps == timestamps);
+    CHECK(decodedPrices == prices);
+    
+    CHECK_THROWS_AS(SeriesCodec::encode(std::span(timestamps).first(0), std::span(prices).first(0), encoded),
+                    std::invalid_argument);
+}
+
+TEST_CASE("SeriesCodec packs typical price changes into a few bytes", "[codec]") {
+    auto records = realisticSeries(0, FuelType::E5, SeriesCodec::BLOCK_POINTS, 3);
+    std::vector<models::EpochSeconds> timestamps;
+    std::vector<models::TenthCents> prices;
+    for (const auto& record : records) {
+        timestamps.push_back(record.timestamp);
+        prices.push_back(record.price);
+    }
+    
+    std::vector<uint8_t> encoded;
+    auto size = SeriesCodec::encode(timestamps, prices, encoded);
+    CHECK(size < records.size() * 4);
+    
+    std::vector<models::EpochSeconds> decodedTimestamps(timestamps.size());
+    std::vector<models::TenthCents> decodedPrices(prices.size());
+    SeriesCodec::decode(encoded.data(), timestamps.size(), timestamps[0], prices[0],
+                        decodedTimestamps.data(), decodedPrices.data());
+    CHECK(decodedTimestamps == timestamps);
+    CHECK(decodedPrices == prices);
+}
+
+TEST_CASE("SeriesArchive gives random access to the blocks of a series", "[codec]") {
+    auto path = fs::temp_directory_path() / "series-archive-test.fpa";
+    
+    std::vector<PriceRecord> records;
+    for (models::StationHandle station = 0; station < 5; ++station) {
+        for (auto fuelType : models::ALL_FUEL_TYPES) {
+            auto series = realisticSeries(station, fuelType, 2500 + station, station * 3 + models::index(fuelType));
+            records.insert(records.end(), series.begin(), series.end());
+        }
+    }
+    auto history = ColumnarHistory::build(records);
+    SeriesArchive::write(path, history);
+    
+    SeriesArchive archive(path);
+    CHECK(archive.recordCount() == records.size());
+    CHECK(archive.blocks().size() == 5 * 3 * 3);
+    CHECK(archive.fileSize() < records.size() * 5);
+    
+    auto blocks = archive.blocks(3, FuelType::E10);
+    REQUIRE(blocks.size() == 3);
+    CHECK(blocks[0].count == SeriesCodec::BLOCK_POINTS);
+    CHECK(blocks[2].count == 2503 - 2 * SeriesCodec::BLOCK_POINTS);
+    
+    // The second block on its own
+    auto column = history.column(3, FuelType::E10);
+    std::vector<models::EpochSeconds> timestamps(blocks[1].count);
+    std::vector<models::TenthCents> prices(blocks[1].count);
+    archive.decode(blocks[1], timestamps.data(), prices.data());
+    CHECK(std::equal(timestamps.begin(), timestamps.end(), column.timestamps.begin() + SeriesCodec::BLOCK_POINTS));
+    CHECK(std::equal(prices.begin(), prices.end(), column.prices.begin() + SeriesCodec::BLOCK_POINTS));
+    CHECK(blocks[1].minPrice == *std::min_element(prices.begin(), prices.end()));
+    
+    CHECK(archive.blocks(9, FuelType::E5).empty());
+    
+    // A range scan returns exactly the records inside it
+    auto from = column.timestamps[100];
+    auto to = column.timestamps[1500];
+    size_t expected = std::count_if(records.begin(), records.end(), [&](const PriceRecord& record) {
+        return record.timestamp >= from && record.timestamp < to;
+    });
+    size_t scanned = 0, outside = 0;
+    archive.scan(from, to, [&](const PriceRecord& record) {
+        outside += record.timestamp < from || record.timestamp >= to;
+        ++scanned;
+    });
+    CHECK(scanned == expected);
+    CHECK(outside == 0);
+    
+    fs::remove(path);
+    
+    // Truncated files are rejected
+    SeriesArchive::write(path, history);
+    fs::resize_file(path, fs::file_size(path) - 1);
+    CHECK_THROWS_AS(SeriesArchive(path), std::runtime_error);
+    fs::remove(path);
+}
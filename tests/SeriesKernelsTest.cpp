@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include "../include/analytics/SeriesKernels.hpp"
+#include "../include/analytics/StatisticsEngine.hpp"
+#include "TimeFixtures.hpp"
+
+using namespace analytics;
+using models::FuelType;
+using Isa = SeriesKernels::Isa;
+
+namespace {
+
+struct Series {
+    std::vector<models::EpochSeconds> timestamps;
+    std::vector<models::TenthCents> prices;
+};
+
+// Price changes every few minutes to a few hours, including a DST switch
+Series randomSeries(size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<models::EpochSeconds> gap(60, 4 * 3600);
+    std::uniform_int_distribution<models::TenthCents> price(1500, 2100);
+
+    Series series;
+    models::EpochSeconds timestamp = 1711500000;  // 2024-03-27, before summer time
+    for (size_t i = 0; i < count; ++i) {
+        timestamp += gap(random);
+        series.timestamps.push_back(timestamp);
+        series.prices.push_back(price(random));
+    }
+    return series;
+}
+
+bool sameProfile(const WeekProfile& a, const WeekProfile& b) {
+    for (size_t hour = 0; hour < HOURS_PER_WEEK; ++hour) {
+        if (a[hour].weightedSum != b[hour].weightedSum || a[hour].seconds != b[hour].seconds ||
+            a[hour].minPrice != b[hour].minPrice || a[hour].maxPrice != b[hour].maxPrice) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("SeriesKernels implementations agree", "[kernels]") {
+    // Sizes around the vector widths exercise the scalar tails
+    for (size_t count : {0, 1, 4, 5, 7, 8, 9, 1023, 1024, 1025, 5000}) {
+        auto series = randomSeries(count, static_cast<unsigned>(count));
+        auto end = count > 0 ? series.timestamps.back() + 1800 : 0;
+        constexpr models::EpochSeconds maxGap = 3 * 3600;
+        
+        auto scalar = SeriesKernels::summarize(series.prices, Isa::Scalar);
+        auto vector = SeriesKernels::summarize(series.prices, Isa::Avx2);
+        CHECK(scalar.count == count);
+        CHECK(vector.count == scalar.count);
+        CHECK(vector.sum == scalar.sum);
+        CHECK(vector.minPrice == scalar.minPrice);
+        CHECK(vector.maxPrice == scalar.maxPrice);
+        
+        auto scalarWeighted = SeriesKernels::timeWeighted(series.timestamps, series.prices, end, maxGap, Isa::Scalar);
+        auto vectorWeighted = SeriesKernels::timeWeighted(series.timestamps, series.prices, end, maxGap, Isa::Avx2);
+        CHECK(vectorWeighted.weightedSum == scalarWeighted.weightedSum);
+        CHECK(vectorWeighted.seconds == scalarWeighted.seconds);
+        
+        WeekProfile scalarProfile{}, vectorProfile{};
+        SeriesKernels::accumulateWeek(series.timestamps, series.prices, end, maxGap, scalarProfile, Isa::Scalar);
+        SeriesKernels::accumulateWeek(series.timestamps, series.prices, end, maxGap, vectorProfile, Isa::Avx2);
+        CHECK(sameProfile(scalarProfile, vectorProfile));
+        
+        uint64_t profileSeconds = 0;
+        for (const auto& bucket : scalarProfile) {
+            profileSeconds += bucket.seconds;
+        }
+        CHECK(profileSeconds == scalarWeighted.seconds);
+    }
+}
+
+TEST_CASE("SeriesKernels compute time-weighted sums", "[kernels]") {
+    std::vector<models::EpochSeconds> timestamps = {MONDAY, MONDAY + 3600, MONDAY + 7200, MONDAY + 100000};
+    std::vector<models::TenthCents> prices = {1800, 1700, 1600, 1900};
+    
+    // The third price is capped at maxGap, the last one runs until end
+    auto result = SeriesKernels::timeWeighted(timestamps, prices, MONDAY + 100600, 7200);
+    CHECK(result.seconds == 3600 + 3600 + 7200 + 600);
+    CHECK(result.weightedSum == 3600 * 1800 + 3600 * 1700 + 7200 * 1600 + 600 * 1900);
+    
+    auto summary = SeriesKernels::summarize(prices);
+    CHECK(summary.minPrice == 1600);
+    CHECK(summary.maxPrice == 1900);
+    CHECK(summary.sum == 7000);
+    
+    // An interval spanning an hour boundary is split between the buckets
+    WeekProfile profile{};
+    std::vector<models::EpochSeconds> across = {MONDAY + 1800, MONDAY + 5400};
+    std::vector<models::TenthCents> acrossPrices = {1800, 1700};
+    SeriesKernels::accumulateWeek(across, acrossPrices, MONDAY + 5400, 7200, profile);
+    CHECK(profile[0].seconds == 1800);
+    CHECK(profile[1].seconds == 1800);
+    CHECK(profile[1].minPrice == 1800);
+}
+
+TEST_CASE("StatisticsEngine backfill matches observing every record", "[kernels]") {
+    auto series = randomSeries(3000, 42);
+    
+    StatisticsEngine observed, backfilled;
+    std::vector<storage::PriceRecord> records;
+    for (size_t i = 0; i < series.timestamps.size(); ++i) {
+        observed.observe(3, FuelType::E10, series.timestamps[i], series.prices[i]);
+        records.push_back({3, FuelType::E10, series.timestamps[i], series.prices[i]});
+    }
+    
+    // Half observed live first, then the whole range backfilled
+    for (size_t i = 0; i < 1500; ++i) {
+        backfilled.observe(3, FuelType::E10, series.timestamps[i], series.prices[i]);
+    }
+    backfilled.backfill(storage::ColumnarHistory::build(records), FuelType::E10);
+    
+    CHECK(*backfilled.averagePrice(3, FuelType::E10) == *observed.averagePrice(3, FuelType::E10));
+    CHECK(*backfilled.areaAveragePrice(FuelType::E10) == *observed.areaAveragePrice(FuelType::E10));
+    CHECK(backfilled.seriesCount() == 1);
+    
+    auto label = [](models::StationHandle) { return StatisticsEngine::StationLabel{"id", "name"}; };
+    auto expected = nlohmann::json(*observed.stationStatistics(3, FuelType::E10, label));
+    auto actual = nlohmann::json(*backfilled.stationStatistics(3, FuelType::E10, label));
+    CHECK(actual == expected);
+}
+
+TEST_CASE("Parallel StatisticsEngine backfill matches the sequential one", "[kernels]") {
+    std::vector<storage::PriceRecord> records;
+    for (models::StationHandle station = 0; station < 200; station += 1 + station % 3) {
+        // Uneven series, so workers have to steal
+        auto series = randomSeries(station < 20 ? 2000 : 50, station);
+        for (size_t i = 0; i < series.timestamps.size(); ++i) {
+            records.push_back({station, i % 3 ? FuelType::E5 : FuelType::Diesel, series.timestamps[i], series.prices[i]});
+        }
+    }
+    auto history = storage::ColumnarHistory::build(records);
+    const std::vector<FuelType> fuelTypes = {FuelType::E5, FuelType::Diesel};
+
+    StatisticsEngine sequential;
+    sequential.observe(7, FuelType::E5, 1711400000, 1750);  // seen live before
+    for (auto fuelType : fuelTypes) {
+        sequential.backfill(history, fuelType);
+    }
+
+    auto label = [](models::StationHandle station) {
+        return StatisticsEngine::StationLabel{std::to_string(station), "name"};
+    };
+    auto expected = sequential.statistics(FuelType::E5, label);
+
+    for (size_t threads : {1, 3, 8}) {
+        StatisticsEngine parallel;
+        parallel.observe(7, FuelType::E5, 1711400000, 1750);
+
+        StatisticsEngine::BackfillOptions options;
+        options.threads = threads;
+        options.chunkStations = 2;
+        size_t calls = 0;
+        auto progress = parallel.backfill(history, fuelTypes, options, [&](const auto& current) {
+            ++calls;
+            CHECK(current.records <= current.totalRecords);
+        });
+
+        CHECK(calls >= 1);
+        CHECK(progress.stations == progress.totalStations);
+        CHECK(progress.records == records.size());
+        CHECK(progress.totalRecords == records.size());
+        CHECK(parallel.seriesCount() == sequential.seriesCount());
+        for (auto fuelType : fuelTypes) {
+            CHECK(*parallel.areaAveragePrice(fuelType) == *sequential.areaAveragePrice(fuelType));
+        }
+        CHECK(nlohmann::json(parallel.statistics(FuelType::E5, label)) == nlohmann::json(expected));
+    }
+
+    // Nothing new the second time
+    auto average = *sequential.areaAveragePrice(FuelType::E5);
+    auto again = sequential.backfill(history, fuelTypes, {});
+    CHECK(again.stations == again.totalStations);
+    CHECK(*sequential.areaAveragePrice(FuelType::E5) == average);
+    CHECK(nlohmann::json(sequential.statistics(FuelType::E5, label)) == nlohmann::json(expected));
+}
@@ -0,0 +1,277 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/api/TankerkoenigAPI.hpp"
+#include "../tools/StandInServer.hpp"
+#include <curl/curl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace api;
+using namespace standin;
+namespace fs = std::filesystem;
+
+namespace {
+
+TankerkoenigAPI::Options clientOptions(const StandInServer& server) {
+    TankerkoenigAPI::Options options;
+    options.baseUrl = server.baseUrl();
+    options.scheduler.requestsPerMinute = 0;  // unlimited
+    options.scheduler.maxRetries = 0;
+    return options;
+}
+
+// A raw connection, for requests curl won't send
+int connectTo(const StandInServer& server) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(server.port());
+    ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+double priceOf(const models::FuelStation& station, const std::string& fuelType) {
+    for (const auto& price : station.prices) {
+        if (price.fuelType == fuelType) return price.price;
+    }
+    return 0.0;
+}
+
+} // namespace
+
+TEST_CASE("StandInServer synthesizes consistent stations", "[standin]") {
+    StandInServer server({});
+    server.start();
+    TankerkoenigAPI api("test-api-key", clientOptions(server));
+    
+    auto stations = api.findStations(52.520008, 13.404954, 5.0);
+    REQUIRE(stations.size() > 10);
+    for (size_t i = 1; i < stations.size(); ++i) {
+        CHECK(stations[i - 1].distance <= stations[i].distance);
+        CHECK(stations[i].distance <= 5.0);
+    }
+    
+    SECTION("Details and prices of listed stations") {
+        auto details = api.getStationDetails(stations.front().id);
+        REQUIRE(details.has_value());
+        CHECK(details->name == stations.front().name);
+        CHECK_THAT(details->location.latitude, Catch::Matchers::WithinAbs(stations.front().location.latitude, 1e-9));
+        
+        std::vector<std::string> ids;
+        for (size_t i = 0; i < 25; ++i) ids.push_back(stations[i].id);
+        auto prices = api.getPrices(ids);
+        REQUIRE(prices.size() == 25);
+        for (const auto& station : prices) {
+            auto listed = std::find_if(stations.begin(), stations.end(),
+                                       [&](const auto& s) { return s.id == station.id; });
+            REQUIRE(listed != stations.end());
+            CHECK_THAT(priceOf(station, "e5"), Catch::Matchers::WithinAbs(priceOf(*listed, "e5"), 1e-9));
+        }
+    }
+    
+    SECTION("Invalid parameters are rejected like the API does") {
+        CHECK_THROWS(api.findStations(91.0, 0.0, 5.0));
+    }
+    
+    CHECK(server.counters().synthesized >= 1);
+}
+
+TEST_CASE("StandInServer replays recorded responses", "[standin]") {
+    auto directory = fs::temp_directory_path() / "standin-recordings";
+    fs::create_directories(directory);
+    {
+        std::ofstream file(directory / "list.json");
+        file << R"({"ok":true,"status":"ok","stations":[{"id":"recorded-1","name":"Recorded","brand":"ARAL",)"
+                R"("street":"Main","houseNumber":"1","postCode":10115,"place":"Berlin","lat":52.5,"lng":13.4,)"
+                R"("dist":0.5,"e5":1.799,"e10":1.739,"diesel":1.699,"isOpen":true}]})";
+    }
+    
+    StandInServer::Options options;
+    options.recordings = directory;
+    StandInServer server(options);
+    server.start();
+    TankerkoenigAPI api("test-api-key", clientOptions(server));
+    
+    auto stations = api.findStations(52.520008, 13.404954, 5.0);
+    REQUIRE(stations.size() == 1);
+    CHECK(stations.front().id == "recorded-1");
+    CHECK(server.counters().replayed == 1);
+    
+    fs::remove_all(directory);
+}
+
+TEST_CASE("TankerkoenigAPI caches only responses the API reports as ok", "[standin][cache]") {
+    auto directory = fs::temp_directory_path() / "standin-cache-recordings";
+    fs::create_directories(directory);
+    {
+        // The first "ok" in the body is not the response status
+        std::ofstream file(directory / "list.json");
+        file << R"({"status":"error","message":"rate limited","details":{"ok":true},"ok":false})";
+    }
+    {
+        std::ofstream file(directory / "detail.json");
+        file << R"({"ok":true,"status":"ok","station":{"id":"recorded-1","name":"ok","brand":"ARAL",)"
+                R"("street":"Main","houseNumber":"1","postCode":10115,"place":"Berlin","lat":52.5,"lng":13.4,)"
+                R"("e5":1.799,"e10":1.739,"diesel":1.699,"isOpen":true}})";
+    }
+
+    StandInServer::Options options;
+    options.recordings = directory;
+    StandInServer server(options);
+    server.start();
+    auto clientOptionsWithCache = clientOptions(server);
+    clientOptionsWithCache.cache = ResponseCache::Options{};
+    TankerkoenigAPI api("test-api-key", clientOptionsWithCache);
+
+    CHECK_THROWS(api.findStations(52.520008, 13.404954, 5.0));
+    CHECK_THROWS(api.findStations(52.520008, 13.404954, 5.0));
+    CHECK(server.counters().replayed == 2);
+
+    REQUIRE(api.getStationDetails("recorded-1").has_value());
+    REQUIRE(api.getStationDetails("recorded-1").has_value());
+    CHECK(server.counters().replayed == 3);
+
+    fs::remove_all(directory);
+}
+
+TEST_CASE("StandInServer injects errors and drifts prices", "[standin]") {
+    SECTION("Errors") {
+        StandInServer::Options options;
+        options.errorRate = 1.0;
+        options.errorStatus = 200;  // "ok": false
+        StandInServer server(options);
+        server.start();
+        TankerkoenigAPI api("test-api-key", clientOptions(server));
+        
+        CHECK_THROWS(api.findStations(52.520008, 13.404954, 5.0));
+        CHECK(server.counters().injectedErrors == 1);
+    }
+    
+    SECTION("Price drift") {
+        StandInServer::Options options;
+        options.priceDrift = 0.05;
+        StandInServer server(options);
+        server.start();
+        TankerkoenigAPI api("test-api-key", clientOptions(server));
+        
+        auto stations = api.findStations(52.520008, 13.404954, 2.0);
+        REQUIRE_FALSE(stations.empty());
+        
+        std::map<std::string, double> listed;
+        std::vector<std::string> ids;
+        for (const auto& station : stations) {
+            ids.push_back(station.id);
+            listed[station.id] = priceOf(station, "e5");
+        }
+        
+        bool changed = false;
+        for (const auto& station : api.getPrices(ids)) {
+            double price = priceOf(station, "e5");
+            CHECK(std::abs(price - listed[station.id]) <= 2 * 0.05 + 1e-9);
+            changed = changed || price != listed[station.id];
+        }
+        CHECK(changed);
+    }
+}
+
+TEST_CASE("StandInServer answers conditional requests and accepts webhooks", "[standin]") {
+    StandInServer server({});
+    server.start();
+    RequestEngine engine;
+    
+    auto url = server.baseUrl() + "detail.php?id=0000a45b-5d1e-4000-8000-0000000002a0";
+    auto first = engine.submit({.url = url, .headers = {}}).get();
+    REQUIRE(first.status == 200);
+    REQUIRE(first.headers.count("etag") == 1);
+    
+    auto second = engine.submit({.url = url, .headers = {"If-None-Match: " + first.headers["etag"]}}).get();
+    CHECK(second.status == 304);
+    CHECK(server.counters().notModified == 1);
+    
+    CURL* curl = curl_easy_init();
+    REQUIRE(curl != nullptr);
+    std::string payload = R"({"type":"message","attachments":[]})";
+    auto webhookUrl = server.webhookUrl();
+    curl_easy_setopt(curl, CURLOPT_URL, webhookUrl.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
+    CHECK(curl_easy_perform(curl) == CURLE_OK);
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_cleanup(curl);
+    
+    CHECK(status == 200);
+    auto webhooks = server.webhooks();
+    REQUIRE(webhooks.size() == 1);
+    CHECK(webhooks.front()["type"] == "message");
+}
+
+TEST_CASE("StandInServer rejects malformed Content-Length headers", "[standin]") {
+    StandInServer server({});
+    server.start();
+    
+    for (const char* contentLength : {"Content-Length: abc", "Content-Length: 99999999999999999999999"}) {
+        CURL* curl = curl_easy_init();
+        REQUIRE(curl != nullptr);
+        auto webhookUrl = server.webhookUrl();
+        curl_slist* headers = curl_slist_append(nullptr, contentLength);
+        curl_easy_setopt(curl, CURLOPT_URL, webhookUrl.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char*, size_t size, size_t count, void*) { return size * count; });
+        CHECK(curl_easy_perform(curl) == CURLE_OK);
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        curl_easy_cleanup(curl);
+        curl_slist_free_all(headers);
+        
+        CHECK(status == 400);
+    }
+    
+    // The server keeps serving afterwards
+    RequestEngine engine;
+    auto response = engine.submit({.url = server.baseUrl() + "list.php?lat=52.52&lng=13.40&rad=1&type=all", .headers = {}}).get();
+    CHECK(response.status == 200);
+}
+
+TEST_CASE("StandInServer does not wait forever on incomplete requests", "[standin]") {
+    StandInServer server({});
+    server.start();
+
+    SECTION("An endless header is rejected") {
+        int fd = connectTo(server);
+        REQUIRE(fd >= 0);
+        std::string header = "GET /json/list.php HTTP/1.1\r\nX-Filler: " + std::string(128 * 1024, 'x');
+        ::send(fd, header.data(), header.size(), MSG_NOSIGNAL);
+
+        std::string response;
+        char chunk[4096];
+        ssize_t received;
+        while ((received = ::recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+            response.append(chunk, static_cast<size_t>(received));
+        }
+        ::close(fd);
+        CHECK(response.rfind("HTTP/1.1 400", 0) == 0);
+    }
+
+    SECTION("A stalled body does not hold up stop()") {
+        int fd = connectTo(server);
+        REQUIRE(fd >= 0);
+        std::string request = "POST /webhook HTTP/1.1\r\nContent-Length: 100\r\n\r\n{\"type\"";
+        ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        auto start = std::chrono::steady_clock::now();
+        server.stop();
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+        ::close(fd);
+    }
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/api/StationDecoder.hpp"
+
+using namespace api;
+using namespace models;
+
+TEST_CASE("StationDecoder decodes list.php responses", "[decoder]") {
+    const char* body = R"({
+        "ok": true,
+        "license": "CC BY 4.0 -  https://creativecommons.tankerkoenig.de",
+        "data": "MTS-K",
+        "status": "ok",
+        "stations": [
+            {
+                "id": "474e5046-deaf-4f9b-9a32-9797b778f047",
+                "name": "TOTAL BERLIN",
+                "brand": "TOTAL",
+                "street": "MARGARETE-SOMMER-STR.",
+                "place": "BERLIN",
+                "lat": 52.53083,
+                "lng": 13.440946,
+                "dist": 1.1,
+                "diesel": 1.109,
+                "e5": 1.339,
+                "e10": 1.319,
+                "isOpen": true,
+                "houseNumber": "2",
+                "postCode": 10407
+            },
+            {
+                "id": "278130b1-e062-4a0f-80cc-19e486b4c024",
+                "name": "Aral Tankstelle",
+                "brand": "ARAL",
+                "street": "Holzmarktstraße",
+                "place": "Berlin",
+                "lat": 52.51202,
+                "lng": 13.42244,
+                "dist": 1.7,
+                "diesel": 1.089,
+                "e5": null,
+                "e10": false,
+                "isOpen": false,
+                "houseNumber": null,
+                "postCode": 10179
+            }
+        ]
+    })";
+
+    auto result = StationDecoder::decode(body, StationDecoder::Endpoint::List);
+    
+    REQUIRE(result.ok);
+    REQUIRE(result.stations.size() == 2);
+    
+    SECTION("Station fields are decoded") {
+        const auto& station = result.stations[0];
+        CHECK(station.id == "474e5046-deaf-4f9b-9a32-9797b778f047");
+        CHECK(station.name == "TOTAL BERLIN");
+        CHECK(station.brand == "TOTAL");
+        CHECK(station.location.street == "MARGARETE-SOMMER-STR.");
+        CHECK(station.location.houseNumber == "2");
+        CHECK(station.location.postalCode == "10407");
+        CHECK(station.location.city == "BERLIN");
+        CHECK_THAT(station.location.latitude, Catch::Matchers::WithinAbs(52.53083, 1e-9));
+        CHECK_THAT(station.location.longitude, Catch::Matchers::WithinAbs(13.440946, 1e-9));
+        CHECK_THAT(station.distance, Catch::Matchers::WithinAbs(1.1, 1e-9));
+        CHECK(station.isOpen);
+        
+        REQUIRE(station.prices.size() == 3);
+        CHECK(station.prices[0].fuelType == "e5");
+        CHECK_THAT(station.prices[0].price, Catch::Matchers::WithinAbs(1.339, 1e-9));
+        CHECK(station.prices[1].fuelType == "e10");
+        CHECK(station.prices[2].fuelType == "diesel");
+    }
+    
+    SECTION("Missing prices and null strings are skipped") {
+        const auto& station = result.stations[1];
+        CHECK(station.location.houseNumber.empty());
+        CHECK_FALSE(station.isOpen);
+        
+        REQUIRE(station.prices.size() == 1);
+        CHECK(station.prices[0].fuelType == "diesel");
+    }
+}
+
+TEST_CASE("StationDecoder decodes detail.php responses", "[decoder]") {
+    SECTION("Valid station") {
+        const char* body = R"({
+            "ok": true,
+            "status": "ok",
+            "station": {
+                "id": "24a381e3-0d72-416d-bfd8-b2f65f6e5802",
+                "name": "Esso Tankstelle",
+                "brand": "ESSO",
+                "street": "HAUPTSTR. 7",
+                "houseNumber": " ",
+                "postCode": 84152,
+                "place": "MENGKOFEN",
+                "openingTimes": [
+                    {"text": "Mo-Fr", "start": "06:00:00", "end": "22:30:00"}
+                ],
+                "overrideOpeningTimes": [],
+                "lat": 48.72210601,
+                "lng": 12.44438439,
+                "isOpen": true,
+                "e5": 1.379,
+                "e10": 1.359,
+                "diesel": 1.169,
+                "wholeDay": false,
+                "state": null
+            }
+        })";
+
+        auto result = StationDecoder::decode(body, StationDecoder::Endpoint::Detail);
+        
+        REQUIRE(result.ok);
+        REQUIRE(result.stations.size() == 1);
+        CHECK(result.stations[0].id == "24a381e3-0d72-416d-bfd8-b2f65f6e5802");
+        CHECK(result.stations[0].location.city == "MENGKOFEN");
+        CHECK(result.stations[0].prices.size() == 3);
+    }
+    
+    SECTION("Invalid station") {
+        const char* body = R"({"ok": false, "message": "parameter error"})";
+        
+        auto result = StationDecoder::decode(body, StationDecoder::Endpoint::Detail);
+        
+        CHECK_FALSE(result.ok);
+        CHECK(result.message == "parameter error");
+        CHECK(result.stations.empty());
+    }
+}
+
+TEST_CASE("StationDecoder decodes prices.php responses", "[decoder]") {
+    const char* body = R"({
+        "ok": true,
+        "prices": {
+            "60c0eefa-d2a8-4f5c-82cc-b5244ecae955": {
+                "status": "open",
+                "e5": false,
+                "e10": false,
+                "diesel": 1.189
+            },
+            "44444444-4444-4444-4444-444444444444": {
+                "status": "no stations"
+            },
+            "4429a7d9-fb2d-4c29-8cfe-2ca90323f9f8": {
+                "status": "closed",
+                "e5": 1.409,
+                "e10": 1.389,
+                "diesel": 1.129
+            }
+        }
+    })";
+
+    auto result = StationDecoder::decode(body, StationDecoder::Endpoint::Prices);
+    
+    REQUIRE(result.ok);
+    REQUIRE(result.stations.size() == 2);
+    
+    CHECK(result.stations[0].id == "60c0eefa-d2a8-4f5c-82cc-b5244ecae955");
+    CHECK(result.stations[0].isOpen);
+    REQUIRE(result.stations[0].prices.size() == 1);
+    CHECK(result.stations[0].prices[0].fuelType == "diesel");
+    
+    CHECK(result.stations[1].id == "4429a7d9-fb2d-4c29-8cfe-2ca90323f9f8");
+    CHECK_FALSE(result.stations[1].isOpen);
+    CHECK(result.stations[1].prices.size() == 3);
+}
+
+TEST_CASE("StationDecoder rejects malformed responses", "[decoder]") {
+    REQUIRE_THROWS(StationDecoder::decode(R"({"ok": true, "stations": [)", StationDecoder::Endpoint::List));
+    REQUIRE_THROWS(StationDecoder::decode("", StationDecoder::Endpoint::Prices));
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <set>
+#include "../include/utils/StationGrid.hpp"
+
+using namespace utils;
+using models::FuelStation;
+
+namespace {
+
+FuelStation makeStation(const std::string& id, double latitude, double longitude) {
+    FuelStation station{};
+    station.id = id;
+    station.name = "Station " + id;
+    station.location.latitude = latitude;
+    station.location.longitude = longitude;
+    return station;
+}
+
+size_t stationsIn(const std::vector<const StationGrid::Cell*>& cells) {
+    size_t count = 0;
+    for (const auto* cell : cells) {
+        count += cell->slots.size();
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("StationGrid follows stations as they appear, move and disappear", "[grid]") {
+    StationGrid grid;
+    grid.upsert(makeStation("a", 52.52, 13.40));  // Berlin
+    grid.upsert(makeStation("b", 52.53, 13.41));
+    grid.upsert(makeStation("c", 53.55, 9.99));   // Hamburg
+    REQUIRE(grid.size() == 3);
+
+    BoundingBox berlin{52.3, 13.0, 52.7, 13.8};
+    CHECK(stationsIn(grid.cellsIn(berlin)) == 2);
+
+    // Moved to Hamburg
+    grid.upsert(makeStation("b", 53.56, 10.00));
+    CHECK(grid.size() == 3);
+    CHECK(stationsIn(grid.cellsIn(berlin)) == 1);
+    REQUIRE(grid.find("b"));
+    CHECK(grid.find("b")->location.latitude == 53.56);
+
+    CHECK(grid.erase("a"));
+    CHECK_FALSE(grid.erase("a"));
+    CHECK_FALSE(grid.find("a"));
+    CHECK(grid.cellsIn(berlin).empty());
+
+    // The freed slot is reused
+    auto slots = grid.slotCount();
+    grid.upsert(makeStation("d", 48.14, 11.58));  // Munich
+    CHECK(grid.slotCount() == slots);
+
+    grid.update({makeStation("c", 53.55, 9.99), makeStation("e", 50.94, 6.96)});
+    CHECK(grid.size() == 2);
+    CHECK(grid.find("c"));
+    CHECK(grid.find("e"));
+    CHECK_FALSE(grid.find("b"));
+    CHECK_FALSE(grid.find("d"));
+
+    CHECK_THROWS_AS(StationGrid(0.0), std::invalid_argument);
+}
+
+TEST_CASE("StationGrid keeps positions inserted without an ID apart", "[grid]") {
+    StationGrid grid;
+    CHECK(grid.insert(52.52, 13.40) == 0);
+    CHECK(grid.insert(52.52, 13.40) == 1);  // same place, still a station of its own
+    CHECK(grid.insert(53.55, 9.99) == 2);
+    REQUIRE(grid.size() == 3);
+    CHECK(grid.station(2).location.longitude == 9.99);
+
+    BoundingBox berlin{52.3, 13.0, 52.7, 13.8};
+    CHECK(stationsIn(grid.cellsIn(berlin)) == 2);
+
+    // Not keyed by ID, so an update of the keyed stations leaves them alone
+    grid.update({makeStation("a", 48.14, 11.58)});
+    CHECK(grid.size() == 4);
+    CHECK_FALSE(grid.find(""));
+}
+
+TEST_CASE("StationGrid finds the same stations along a route as testing all of them", "[grid][route]") {
+    std::mt19937 random(21);
+    std::uniform_real_distribution<double> latitude(47.5, 55.0);
+    std::uniform_real_distribution<double> longitude(6.0, 15.0);
+
+    std::vector<FuelStation> stations;
+    for (int i = 0; i < 3000; ++i) {
+        stations.push_back(makeStation(std::to_string(i), latitude(random), longitude(random)));
+    }
+
+    // A long diagonal segment, a zigzag of short ones and a waypoint repeated
+    std::vector<Waypoint> waypoints = {{47.6, 7.6}, {54.3, 13.1}, {54.3, 13.1}};
+    for (int i = 0; i < 200; ++i) {
+        waypoints.push_back({54.3 - i * 0.03, 13.1 - (i % 2) * 0.05 - i * 0.02});
+    }
+
+    StationGrid grid(0.05);
+    for (const auto& station : stations) {
+        grid.upsert(station);
+    }
+
+    for (double corridorWidth : {0.5, 5.0, 30.0}) {
+        std::set<std::string> expected;
+        for (const auto& station : stations) {
+            for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+                if (RouteCalculator::isPointInCorridor(waypoints[i], waypoints[i + 1], station.location.latitude,
+                                                       station.location.longitude, corridorWidth)) {
+                    expected.insert(station.id);
+                    break;
+                }
+            }
+        }
+
+        auto indexed = RouteCalculator::findStationsAlongRoute(waypoints, grid, corridorWidth);
+        std::set<std::string> found;
+        for (const auto& station : indexed) {
+            found.insert(station.id);
+        }
+        CHECK(found == expected);
+        CHECK(indexed.size() == expected.size());
+        CHECK(std::is_sorted(indexed.begin(), indexed.end(),
+                             [](const auto& a, const auto& b) { return a.distance < b.distance; }));
+
+        auto direct = RouteCalculator::findStationsAlongRoute(waypoints, stations, corridorWidth);
+        REQUIRE(direct.size() == indexed.size());
+        for (size_t i = 0; i < direct.size(); ++i) {
+            CHECK(direct[i].distance == indexed[i].distance);
+        }
+    }
+}
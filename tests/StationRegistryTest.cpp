@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/monitoring/StationRegistry.hpp"
+
+using namespace monitoring;
+using namespace models;
+using namespace std::chrono_literals;
+
+namespace {
+
+FuelStation makeStation(const std::string& id, double e5, double diesel) {
+    FuelStation station;
+    station.id = id;
+    station.name = "Station " + id;
+    station.brand = "TestBrand";
+    station.location.city = "Berlin";
+    station.isOpen = true;
+    station.prices = {
+        FuelPrice{.fuelType = "e5", .price = e5, .lastUpdate = ""},
+        FuelPrice{.fuelType = "diesel", .price = diesel, .lastUpdate = ""}
+    };
+    return station;
+}
+
+} // namespace
+
+TEST_CASE("StationRegistry keeps the discovered station set", "[registry]") {
+    StationRegistry registry;
+    auto now = StationRegistry::Clock::now();
+
+    SECTION("Empty registry needs discovery") {
+        CHECK(registry.empty());
+        CHECK(registry.needsDiscovery(now, 60min));
+    }
+
+    SECTION("Discovery is due again after the interval") {
+        registry.update({makeStation("a", 1.799, 1.699)}, now);
+        
+        CHECK_FALSE(registry.needsDiscovery(now + 59min, 60min));
+        CHECK(registry.needsDiscovery(now + 60min, 60min));
+    }
+
+    SECTION("Station IDs are returned in stable order") {
+        registry.update({makeStation("c", 1.0, 1.0), makeStation("a", 1.0, 1.0), makeStation("b", 1.0, 1.0)}, now);
+        
+        CHECK(registry.stationIds() == std::vector<std::string>{"a", "b", "c"});
+    }
+
+    SECTION("Rediscovery drops vanished stations") {
+        registry.update({makeStation("a", 1.0, 1.0), makeStation("b", 1.0, 1.0)}, now);
+        registry.update({makeStation("b", 1.0, 1.0)}, now + 1min);
+        
+        CHECK(registry.size() == 1);
+        CHECK(registry.find("a") == nullptr);
+        CHECK(registry.find("b") != nullptr);
+    }
+}
+
+TEST_CASE("StationRegistry merges price updates", "[registry]") {
+    StationRegistry registry;
+    registry.update({makeStation("a", 1.799, 1.699)}, StationRegistry::Clock::now());
+
+    SECTION("Known station keeps its metadata") {
+        FuelStation update;
+        update.id = "a";
+        update.isOpen = false;
+        update.prices = {FuelPrice{.fuelType = "e5", .price = 1.759, .lastUpdate = ""}};
+        
+        const auto* merged = registry.applyPrices(update);
+        REQUIRE(merged != nullptr);
+        CHECK(merged->name == "Station a");
+        CHECK_FALSE(merged->isOpen);
+        
+        REQUIRE(merged->prices.size() == 2);
+        CHECK_THAT(merged->prices[0].price, Catch::Matchers::WithinAbs(1.759, 1e-9));
+        CHECK_THAT(merged->prices[1].price, Catch::Matchers::WithinAbs(1.699, 1e-9));
+    }
+
+    SECTION("New fuel type is added") {
+        FuelStation update;
+        update.id = "a";
+        update.isOpen = true;
+        update.prices = {FuelPrice{.fuelType = "e10", .price = 1.739, .lastUpdate = ""}};
+        
+        const auto* merged = registry.applyPrices(update);
+        REQUIRE(merged != nullptr);
+        CHECK(merged->prices.size() == 3);
+    }
+
+    SECTION("Unknown station is ignored") {
+        FuelStation update;
+        update.id = "unknown";
+        
+        CHECK(registry.applyPrices(update) == nullptr);
+    }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../include/analytics/StatisticsEngine.hpp"
+#include "TimeFixtures.hpp"
+
+using namespace analytics;
+using models::FuelType;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+StatisticsEngine::StationLabel label(models::StationHandle station) {
+    return {"station-" + std::to_string(station), "Station " + std::to_string(station)};
+}
+
+} // namespace
+
+TEST_CASE("Hours of the week follow German local time", "[statistics]") {
+    CHECK(hourOfWeek(MONDAY) == 0);
+    CHECK(hourOfWeek(MONDAY + 25 * HOUR) == 25);
+    CHECK(hourOfWeek(MONDAY - HOUR) == 167);
+    
+    // 2024-07-15 00:00 UTC is Monday 02:00 CEST
+    CHECK(hourOfWeek(1721001600) == 2);
+    
+    // Summer time starts on 2024-03-31 at 01:00 UTC (03:00 CEST)
+    CHECK(toLocalTime(1711846800 - 1) - (1711846800 - 1) == HOUR);
+    CHECK(toLocalTime(1711846800) - 1711846800 == 2 * HOUR);
+    CHECK(nextHour(MONDAY + 10) == MONDAY + HOUR);
+}
+
+TEST_CASE("StatisticsEngine builds time-weighted weekly statistics", "[statistics]") {
+    StatisticsEngine engine;
+    
+    // Station 0: 1.800 from 07:00, 1.700 from 09:00, observed until 11:00
+    engine.observe(0, FuelType::E5, MONDAY + 7 * HOUR, 1800);
+    engine.observe(0, FuelType::E5, MONDAY + 8 * HOUR, 1800);
+    engine.observe(0, FuelType::E5, MONDAY + 9 * HOUR, 1700);
+    engine.observe(0, FuelType::E5, MONDAY + 11 * HOUR, 1700);
+    
+    // Station 1: 1.600 on Tuesday, 1.900 on Wednesday
+    engine.observe(1, FuelType::E5, MONDAY + 24 * HOUR, 1600);
+    engine.observe(1, FuelType::E5, MONDAY + 30 * HOUR, 1900);
+    engine.observe(1, FuelType::E5, MONDAY + 54 * HOUR, 1900);
+    
+    CHECK_THAT(*engine.averagePrice(0, FuelType::E5), WithinAbs(1750.0, 1e-9));
+    CHECK_THAT(*engine.averagePrice(1, FuelType::E5), WithinAbs((6 * 1600 + 24 * 1900) / 30.0, 1e-9));
+    CHECK_THAT(*engine.areaAveragePrice(FuelType::E5), WithinAbs((1750.0 + 1840.0) / 2, 1e-9));
+    CHECK_FALSE(engine.averagePrice(0, FuelType::Diesel).has_value());
+    
+    auto stats = engine.stationStatistics(0, FuelType::E5, label);
+    REQUIRE(stats.has_value());
+    CHECK(stats->stationId == "station-0");
+    CHECK_THAT(stats->averagePrice, WithinAbs(1.75, 1e-9));
+    REQUIRE(stats->weeklyStats.dailyStats.size() == 1);
+    
+    const auto& monday = stats->weeklyStats.dailyStats.at("Mon");
+    CHECK_THAT(monday.minPrice, WithinAbs(1.7, 1e-9));
+    CHECK_THAT(monday.maxPrice, WithinAbs(1.8, 1e-9));
+    CHECK_THAT(monday.avgPrice, WithinAbs(1.75, 1e-9));
+    CHECK(monday.bestTimeToRefuel == "09:00");
+    CHECK(monday.worstTimeToRefuel == "07:00");
+    CHECK(stats->weeklyStats.cheapestDay == "Mon");
+    CHECK(stats->isTypicallyCheapest);
+    
+    auto other = engine.stationStatistics(1, FuelType::E5, label);
+    REQUIRE(other.has_value());
+    CHECK(other->weeklyStats.cheapestDay == "Tue");
+    CHECK(other->weeklyStats.mostExpensiveDay == "Wed");
+    CHECK_FALSE(other->isTypicallyCheapest);
+    
+    auto area = engine.statistics(FuelType::E5, label);
+    CHECK(area.fuelType == "e5");
+    REQUIRE(area.stationStats.size() == 2);
+    CHECK(area.stationStats[0].stationId == "station-0");
+    CHECK(area.stationStats[0].isTypicallyCheapest);
+    CHECK_FALSE(area.stationStats[1].isTypicallyCheapest);
+    CHECK_THAT(area.areaAveragePrice, WithinAbs(1.795, 1e-9));
+    CHECK(area.lastUpdate == models::formatTimestamp(MONDAY + 54 * HOUR));
+}
+
+TEST_CASE("StatisticsEngine bounds gaps and ignores stale observations", "[statistics]") {
+    StatisticsEngine::Options options;
+    options.maxGap = std::chrono::hours(2);
+    StatisticsEngine engine(options);
+    
+    engine.observe(0, FuelType::Diesel, MONDAY, 1600);
+    engine.observe(0, FuelType::Diesel, MONDAY + 72 * HOUR, 1800);  // monitor was down
+    engine.observe(0, FuelType::Diesel, MONDAY + 71 * HOUR, 1000);  // older than the last one
+    engine.observe(0, FuelType::Diesel, MONDAY + 73 * HOUR, 1800);
+    
+    // Two hours at 1.600 and one at 1.800
+    CHECK_THAT(*engine.averagePrice(0, FuelType::Diesel), WithinAbs((2 * 1600 + 1800) / 3.0, 1e-9));
+    
+    auto stats = engine.stationStatistics(0, FuelType::Diesel, label);
+    REQUIRE(stats.has_value());
+    CHECK(stats->weeklyStats.dailyStats.count("Mon") == 1);
+    CHECK(stats->weeklyStats.dailyStats.count("Thu") == 1);
+    CHECK(stats->weeklyStats.dailyStats.count("Tue") == 0);
+}
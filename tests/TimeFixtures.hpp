@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../include/models/CompactStation.hpp"
+
+// Time constants and price patterns shared by the analytics tests
+
+// Monday, 2024-01-15 00:00 CET
+inline constexpr models::EpochSeconds MONDAY = 1705273200;
+inline constexpr models::EpochSeconds HOUR = 3600;
+inline constexpr models::EpochSeconds DAY = 86400;
+
+// Expensive in the morning rush, cheapest in the evening. `noise` adds
+// -noise, 0 or +noise in turn from hour to hour.
+inline models::TenthCents dailyPattern(models::EpochSeconds time, models::TenthCents base,
+                                       models::TenthCents noise = 0) {
+    auto hour = ((time - MONDAY) % DAY + DAY) % DAY / HOUR;
+    auto offset = static_cast<models::TenthCents>((time / HOUR) % 3 - 1) * noise;
+    if (hour >= 6 && hour < 10) return base + 60 + offset;
+    if (hour >= 18 && hour < 21) return base - 50 + offset;
+    return base + offset;
+}
@@ -0,0 +1,86 @@
+#include "StandInServer.hpp"
+#include <csignal>
+#include <iostream>
+#include <fmt/format.h>
+
+namespace {
+
+void printUsage() {
+    std::cout <<
+        "Usage: fuel-price-standin [options]\n"
+        "  --bind ADDRESS       address to listen on (default 127.0.0.1)\n"
+        "  --port PORT          port to listen on, 0 picks a free one (default 8080)\n"
+        "  --threads N          connections served concurrently (default 16)\n"
+        "  --recordings DIR     replay recorded responses from DIR\n"
+        "  --record URL         fetch unrecorded queries from URL and save them to DIR\n"
+        "  --latency MS         latency added to every response\n"
+        "  --jitter MS          uniformly distributed extra latency\n"
+        "  --error-rate RATE    fraction of requests answered with an error (0-1)\n"
+        "  --error-status CODE  status of injected errors (default 503)\n"
+        "  --drift EURO         largest price step per response (synthetic price drift)\n"
+        "  --seed N             seed for latency, errors and drift\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        standin::StandInServer::Options options;
+        options.port = 8080;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error(fmt::format("Missing value for {}", arg));
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--bind") options.bindAddress = value;
+            else if (arg == "--port") options.port = static_cast<uint16_t>(std::stoi(value));
+            else if (arg == "--threads") options.threads = std::stoul(value);
+            else if (arg == "--recordings") options.recordings = value;
+            else if (arg == "--record") options.upstream = value;
+            else if (arg == "--latency") options.latency = std::chrono::milliseconds(std::stol(value));
+            else if (arg == "--jitter") options.latencyJitter = std::chrono::milliseconds(std::stol(value));
+            else if (arg == "--error-rate") options.errorRate = std::stod(value);
+            else if (arg == "--error-status") options.errorStatus = std::stoi(value);
+            else if (arg == "--drift") options.priceDrift = std::stod(value);
+            else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+            else throw std::runtime_error(fmt::format("Unknown option: {}", arg));
+        }
+
+        if (!options.upstream.empty() && !options.upstream.ends_with('/')) {
+            options.upstream += '/';
+        }
+
+        // Serve until SIGINT/SIGTERM
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        standin::StandInServer server(options);
+        server.start();
+        std::cout << fmt::format("Tankerkoenig base URL: {}", server.baseUrl()) << std::endl;
+        std::cout << fmt::format("Teams webhook URL:     {}", server.webhookUrl()) << std::endl;
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+
+        auto counters = server.counters();
+        std::cout << fmt::format("{} requests: {} replayed, {} recorded, {} synthesized, {} not modified, "
+                                 "{} injected errors, {} webhooks",
+                                 counters.requests, counters.replayed, counters.recorded, counters.synthesized,
+                                 counters.notModified, counters.injectedErrors, counters.webhooks) << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << fmt::format("Fatal error: {}", e.what()) << std::endl;
+        return 1;
+    }
+}
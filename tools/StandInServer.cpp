@@ -0,0 +1,642 @@
+#include "StandInServer.hpp"
+#include "utils/RouteCalculator.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <numbers>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fmt/format.h>
+
+namespace standin {
+
+namespace {
+
+constexpr std::string_view API_PREFIX = "/json/";
+constexpr double KM_PER_DEGREE = 111.195;
+constexpr size_t MAX_HEADER_BYTES = 64 * 1024;
+constexpr size_t MAX_BODY_BYTES = 16 * 1024 * 1024;  // webhook payloads are a few kilobytes
+constexpr const char* FUEL_TYPES[] = {"e5", "e10", "diesel"};
+constexpr const char* BRANDS[] = {"ARAL", "Shell", "ESSO", "JET", "TotalEnergies", "STAR", "AVIA"};
+
+uint64_t fnv1a(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string percentDecode(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size() &&
+            std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            result += static_cast<char>(std::stoi(std::string(text.substr(i + 1, 2)), nullptr, 16));
+            i += 2;
+        } else if (text[i] == '+') {
+            result += ' ';
+        } else {
+            result += text[i];
+        }
+    }
+    return result;
+}
+
+std::map<std::string, std::string> parseQuery(std::string_view query) {
+    std::map<std::string, std::string> params;
+    while (!query.empty()) {
+        auto amp = query.find('&');
+        auto pair = query.substr(0, amp);
+        query.remove_prefix(amp == std::string_view::npos ? query.size() : amp + 1);
+
+        auto eq = pair.find('=');
+        if (eq == std::string_view::npos) {
+            params[percentDecode(pair)] = "";
+        } else {
+            params[percentDecode(pair.substr(0, eq))] = percentDecode(pair.substr(eq + 1));
+        }
+    }
+    return params;
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+std::string errorBody(const std::string& message) {
+    return nlohmann::json{{"ok", false}, {"status", "error"}, {"message", message}}.dump();
+}
+
+bool sendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+double roundPrice(double price) {
+    return std::round(price * 1000.0) / 1000.0;
+}
+
+// Synthetic IDs look like real UUIDs and carry the grid position
+std::string stationId(int32_t row, int64_t column) {
+    return fmt::format("{:08x}-5d1e-4000-8000-{:012x}",
+                       static_cast<uint32_t>(row),
+                       static_cast<uint64_t>(column) & 0xffffffffffffull);
+}
+
+std::optional<std::pair<int32_t, int64_t>> parseStationId(const std::string& id) {
+    if (id.size() != 36 || id.compare(8, 16, "-5d1e-4000-8000-") != 0) {
+        return std::nullopt;
+    }
+    try {
+        auto row = static_cast<int32_t>(std::stoul(id.substr(0, 8), nullptr, 16));
+        auto column = static_cast<int64_t>(std::stoull(id.substr(24), nullptr, 16));
+        if (column & 0x800000000000ll) column -= 0x1000000000000ll;  // sign-extend 48 bits
+        return std::make_pair(row, column);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+StandInServer::StandInServer(Options options)
+    : options(std::move(options)), random(this->options.seed) {
+    if (!this->options.upstream.empty()) {
+        upstream = std::make_unique<api::RequestEngine>();
+    }
+}
+
+StandInServer::~StandInServer() {
+    stop();
+}
+
+void StandInServer::start() {
+    if (running) return;
+
+    listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    int reuse = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.port);
+    if (::inet_pton(AF_INET, options.bindAddress.c_str(), &address.sin_addr) != 1) {
+        ::close(listenFd);
+        throw std::runtime_error(fmt::format("Invalid bind address: {}", options.bindAddress));
+    }
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        ::close(listenFd);
+        throw std::runtime_error(fmt::format("Failed to listen on {}:{}", options.bindAddress, options.port));
+    }
+
+    socklen_t length = sizeof(address);
+    ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    running = true;
+    for (size_t i = 0; i < std::max<size_t>(1, options.threads); ++i) {
+        workers.emplace_back(&StandInServer::workerLoop, this);
+    }
+    acceptor = std::thread(&StandInServer::acceptLoop, this);
+}
+
+void StandInServer::stop() {
+    if (!running.exchange(false)) return;
+
+    queueCondition.notify_all();
+    acceptor.join();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    ::close(listenFd);
+    listenFd = -1;
+
+    for (int fd : connections) {
+        ::close(fd);
+    }
+    connections.clear();
+}
+
+std::string StandInServer::baseUrl() const {
+    return fmt::format("http://{}:{}{}", options.bindAddress, boundPort, API_PREFIX);
+}
+
+std::string StandInServer::webhookUrl() const {
+    return fmt::format("http://{}:{}/webhook", options.bindAddress, boundPort);
+}
+
+StandInServer::Counters StandInServer::counters() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return stats;
+}
+
+std::vector<nlohmann::json> StandInServer::webhooks() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return receivedWebhooks;
+}
+
+std::string StandInServer::recordingFile(
+    const std::string& endpoint,
+    const std::map<std::string, std::string>& params
+) {
+    // The API key is not part of the recording
+    std::string key = endpoint;
+    for (const auto& [name, value] : params) {
+        if (name != "apikey") key += fmt::format("&{}={}", name, value);
+    }
+    auto stem = endpoint.substr(0, endpoint.rfind('.'));
+    return fmt::format("{}-{:016x}.json", stem, fnv1a(key));
+}
+
+void StandInServer::acceptLoop() {
+    while (running) {
+        pollfd entry{listenFd, POLLIN, 0};
+        if (::poll(&entry, 1, POLL_TIMEOUT_MS) <= 0) continue;
+
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            connections.push_back(fd);
+        }
+        queueCondition.notify_one();
+    }
+}
+
+void StandInServer::workerLoop() {
+    while (true) {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return !running || !connections.empty(); });
+            if (!running) return;
+            fd = connections.front();
+            connections.pop_front();
+        }
+        // A broken connection must not take the worker, and with it the
+        // whole server, down
+        try {
+            serveConnection(fd);
+        } catch (const std::exception& e) {
+            std::cerr << fmt::format("Stand-in connection failed: {}", e.what()) << std::endl;
+        }
+        ::close(fd);
+    }
+}
+
+bool StandInServer::receive(int fd, std::string& buffer) {
+    char chunk[16384];
+    while (running) {
+        pollfd entry{fd, POLLIN, 0};
+        int ready = ::poll(&entry, 1, POLL_TIMEOUT_MS);
+        if (ready == 0) continue;
+        if (ready < 0) return false;
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(received));
+        return true;
+    }
+    return false;
+}
+
+void StandInServer::serveConnection(int fd) {
+    std::string buffer;
+
+    // Keep-alive: serve requests until the client closes the connection
+    while (running) {
+        auto headerEnd = buffer.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) {
+            if (buffer.size() > MAX_HEADER_BYTES) {
+                sendResponse(fd, {.status = 400, .body = errorBody("request header too large"), .headers = {}}, false);
+                return;
+            }
+            if (!receive(fd, buffer)) return;
+            continue;
+        }
+
+        Request request;
+        std::istringstream head(buffer.substr(0, headerEnd));
+        std::string target, version, line;
+        head >> request.method >> target >> version;
+        std::getline(head, line);
+        while (std::getline(head, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            auto colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            auto name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return std::tolower(c); });
+            auto value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            request.headers[name] = value;
+        }
+
+        size_t contentLength = 0;
+        if (auto it = request.headers.find("content-length"); it != request.headers.end()) {
+            const auto& value = it->second;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), contentLength);
+            if (error != std::errc() || end != value.data() + value.size() || contentLength > MAX_BODY_BYTES) {
+                sendResponse(fd, {.status = 400, .body = errorBody("invalid Content-Length"), .headers = {}}, false);
+                return;
+            }
+        }
+        while (buffer.size() < headerEnd + 4 + contentLength) {
+            if (!receive(fd, buffer)) return;
+        }
+        request.body = buffer.substr(headerEnd + 4, contentLength);
+        buffer.erase(0, headerEnd + 4 + contentLength);
+
+        auto question = target.find('?');
+        request.path = target.substr(0, question);
+        if (question != std::string::npos) {
+            request.query = target.substr(question + 1);
+            request.params = parseQuery(request.query);
+        }
+
+        Response response;
+        try {
+            response = handle(request);
+        } catch (const std::exception& e) {
+            response = {.status = 500, .body = errorBody(e.what()), .headers = {}};
+        }
+
+        auto delay = options.latency;
+        if (options.latencyJitter.count() > 0) {
+            delay += std::chrono::milliseconds(
+                static_cast<int64_t>(uniform(0.0, static_cast<double>(options.latencyJitter.count()))));
+        }
+        if (delay.count() > 0) {
+            std::this_thread::sleep_for(delay);
+        }
+
+        auto connection = request.headers["connection"];
+        bool keepAlive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+        if (!sendResponse(fd, response, keepAlive) || !keepAlive) return;
+    }
+}
+
+bool StandInServer::sendResponse(int fd, const Response& response, bool keepAlive) {
+    std::string message = fmt::format("HTTP/1.1 {} {}\r\n", response.status, reasonPhrase(response.status));
+    message += "Content-Type: application/json; charset=utf-8\r\n";
+    message += fmt::format("Content-Length: {}\r\n", response.body.size());
+    message += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    for (const auto& header : response.headers) {
+        message += header + "\r\n";
+    }
+    message += "\r\n";
+    message += response.body;
+
+    return sendAll(fd, message);
+}
+
+StandInServer::Response StandInServer::handle(const Request& request) {
+    bool injectError;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++stats.requests;
+        injectError = options.errorRate > 0.0 &&
+                      std::uniform_real_distribution<double>(0.0, 1.0)(random) < options.errorRate;
+        if (injectError) ++stats.injectedErrors;
+    }
+
+    if (injectError) {
+        Response response{.status = options.errorStatus, .body = errorBody("injected error"), .headers = {}};
+        if (options.errorStatus == 429) {
+            response.headers.push_back("Retry-After: 1");
+        }
+        return response;
+    }
+
+    if (request.path.starts_with(API_PREFIX) && request.method == "GET") {
+        return handleApi(request, request.path.substr(API_PREFIX.size()));
+    }
+    if (request.method == "POST") {
+        return handleWebhook(request);
+    }
+    return {.status = 404, .body = errorBody("not found"), .headers = {}};
+}
+
+StandInServer::Response StandInServer::handleApi(const Request& request, const std::string& endpoint) {
+    if (endpoint != "list.php" && endpoint != "detail.php" && endpoint != "prices.php") {
+        return {.status = 404, .body = errorBody("not found"), .headers = {}};
+    }
+
+    nlohmann::json body;
+    if (auto recorded = replay(endpoint, request)) {
+        body = nlohmann::json::parse(*recorded, nullptr, false);
+    } else if (auto response = record(endpoint, request)) {
+        if (response->status != 200) return *response;
+        body = nlohmann::json::parse(response->body, nullptr, false);
+    } else {
+        body = synthesize(endpoint, request);
+    }
+
+    if (body.is_discarded()) {
+        return {.status = 502, .body = errorBody("unreadable recording"), .headers = {}};
+    }
+    if (options.priceDrift > 0.0) {
+        applyDrift(body);
+    }
+
+    Response response{.status = 200, .body = body.dump(), .headers = {}};
+    auto etag = fmt::format("\"{:016x}\"", fnv1a(response.body));
+    response.headers.push_back("ETag: " + etag);
+
+    auto ifNoneMatch = request.headers.find("if-none-match");
+    if (ifNoneMatch != request.headers.end() && ifNoneMatch->second == etag) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++stats.notModified;
+        return {.status = 304, .body = "", .headers = {"ETag: " + etag}};
+    }
+    return response;
+}
+
+StandInServer::Response StandInServer::handleWebhook(const Request& request) {
+    auto payload = nlohmann::json::parse(request.body, nullptr, false);
+    if (payload.is_discarded()) {
+        return {.status = 400, .body = errorBody("invalid payload"), .headers = {}};
+    }
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    ++stats.webhooks;
+    receivedWebhooks.push_back(std::move(payload));
+    return {.status = 200, .body = "1", .headers = {}};  // what Teams answers
+}
+
+std::optional<std::string> StandInServer::replay(const std::string& endpoint, const Request& request) {
+    if (options.recordings.empty()) return std::nullopt;
+
+    auto stem = endpoint.substr(0, endpoint.rfind('.'));
+    for (const auto& name : {recordingFile(endpoint, request.params), stem + ".json"}) {
+        std::ifstream file(options.recordings / name, std::ios::binary);
+        if (!file.is_open()) continue;
+
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++stats.replayed;
+        return content;
+    }
+    return std::nullopt;
+}
+
+std::optional<StandInServer::Response> StandInServer::record(const std::string& endpoint, const Request& request) {
+    if (!upstream) return std::nullopt;
+
+    api::HttpResponse upstreamResponse;
+    try {
+        upstreamResponse = upstream->submit({.url = options.upstream + endpoint + "?" + request.query, .headers = {}}).get();
+    } catch (const std::exception& e) {
+        return Response{.status = 502, .body = errorBody(e.what()), .headers = {}};
+    }
+
+    Response response{.status = static_cast<int>(upstreamResponse.status), .body = upstreamResponse.body, .headers = {}};
+    auto json = nlohmann::json::parse(response.body, nullptr, false);
+    bool ok = response.status == 200 && !json.is_discarded() && json.value("ok", false);
+    if (ok && !options.recordings.empty()) {
+        // Written to a temporary file first so concurrent replays never see partial files
+        std::filesystem::create_directories(options.recordings);
+        auto path = options.recordings / recordingFile(endpoint, request.params);
+        auto temporary = path;
+        temporary += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file(temporary, std::ios::binary);
+            file << response.body;
+        }
+        std::filesystem::rename(temporary, path);
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++stats.recorded;
+    }
+    return response;
+}
+
+nlohmann::json StandInServer::synthesize(const std::string& endpoint, const Request& request) {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++stats.synthesized;
+    }
+
+    auto param = [&](const std::string& name) {
+        auto it = request.params.find(name);
+        return it == request.params.end() ? std::string() : it->second;
+    };
+
+    if (endpoint == "detail.php") {
+        auto position = parseStationId(param("id"));
+        if (!position) {
+            return nlohmann::json::parse(errorBody("parameter error"));
+        }
+        return {{"ok", true}, {"license", "CC BY 4.0 - stand-in"}, {"data", "SYN"}, {"status", "ok"},
+                {"station", syntheticStation(position->first, position->second, true)}};
+    }
+
+    if (endpoint == "prices.php") {
+        nlohmann::json prices = nlohmann::json::object();
+        std::istringstream ids(param("ids"));
+        std::string id;
+        while (std::getline(ids, id, ',')) {
+            auto position = parseStationId(id);
+            if (!position) {
+                prices[id] = {{"status", "no stations"}};
+                continue;
+            }
+            auto station = syntheticStation(position->first, position->second, false);
+            prices[id] = {{"status", "open"}, {"e5", station["e5"]}, {"e10", station["e10"]}, {"diesel", station["diesel"]}};
+        }
+        return {{"ok", true}, {"license", "CC BY 4.0 - stand-in"}, {"data", "SYN"}, {"prices", prices}};
+    }
+
+    // list.php
+    double lat, lng, radius;
+    try {
+        lat = std::stod(param("lat"));
+        lng = std::stod(param("lng"));
+        radius = std::stod(param("rad"));
+    } catch (const std::exception&) {
+        return nlohmann::json::parse(errorBody("parameter error"));
+    }
+    if (lat < -90.0 || lat > 90.0 || lng < -180.0 || lng > 180.0 || radius <= 0.0 || radius > 25.0) {
+        return nlohmann::json::parse(errorBody("parameter error"));
+    }
+    auto type = param("type").empty() ? std::string("all") : param("type");
+
+    double spacing = options.stationSpacing;
+    double latSpan = radius / KM_PER_DEGREE;
+    double lngSpan = latSpan / std::max(0.01, std::cos(lat * std::numbers::pi / 180.0));
+    auto firstRow = static_cast<int32_t>(std::floor((lat - latSpan) / spacing));
+    auto lastRow = static_cast<int32_t>(std::ceil((lat + latSpan) / spacing));
+    auto firstColumn = static_cast<int64_t>(std::floor((lng - lngSpan) / spacing));
+    auto lastColumn = static_cast<int64_t>(std::ceil((lng + lngSpan) / spacing));
+
+    nlohmann::json stations = nlohmann::json::array();
+    for (auto row = firstRow; row <= lastRow; ++row) {
+        for (auto column = firstColumn; column <= lastColumn; ++column) {
+            auto station = syntheticStation(row, column, false);
+            double distance = utils::RouteCalculator::calculateDistance(
+                lat, lng, station["lat"].get<double>(), station["lng"].get<double>());
+            if (distance > radius) continue;
+
+            station["dist"] = std::round(distance * 10.0) / 10.0;
+            if (type != "all") {
+                if (!station.contains(type)) {
+                    return nlohmann::json::parse(errorBody("parameter error"));
+                }
+                station["price"] = station[type];
+                for (const char* fuelType : FUEL_TYPES) station.erase(fuelType);
+            }
+            stations.push_back(std::move(station));
+        }
+    }
+
+    // Like the API: sorted by distance for type=all, else by price
+    auto sortKey = type == "all" || param("sort") == "dist" ? "dist" : "price";
+    std::stable_sort(stations.begin(), stations.end(), [&](const auto& a, const auto& b) {
+        return a[sortKey].template get<double>() < b[sortKey].template get<double>();
+    });
+
+    return {{"ok", true}, {"license", "CC BY 4.0 - stand-in"}, {"data", "SYN"}, {"status", "ok"},
+            {"stations", stations}};
+}
+
+nlohmann::json StandInServer::syntheticStation(int32_t row, int64_t column, bool detail) {
+    auto id = stationId(row, column);
+    auto hash = fnv1a(id);
+    double e5 = 1.689 + static_cast<double>(hash % 20) * 0.01;
+
+    nlohmann::json station = {
+        {"id", id},
+        {"name", fmt::format("Stand-in {}", hash % 10000)},
+        {"brand", BRANDS[hash % std::size(BRANDS)]},
+        {"street", "Teststraße"},
+        {"houseNumber", std::to_string(hash % 200 + 1)},
+        {"postCode", static_cast<int>(10000 + hash % 90000)},
+        {"place", "Teststadt"},
+        {"lat", row * options.stationSpacing},
+        {"lng", static_cast<double>(column) * options.stationSpacing},
+        {"isOpen", true},
+        {"e5", roundPrice(e5)},
+        {"e10", roundPrice(e5 - 0.06)},
+        {"diesel", roundPrice(e5 - 0.1)}
+    };
+    if (detail) {
+        station["openingTimes"] = nlohmann::json::array();
+        station["overrideOpeningTimes"] = nlohmann::json::array();
+        station["wholeDay"] = true;
+        station["state"] = nullptr;
+    }
+    return station;
+}
+
+void StandInServer::applyDrift(nlohmann::json& response) {
+    if (auto stations = response.find("stations"); stations != response.end() && stations->is_array()) {
+        for (auto& station : *stations) {
+            if (station.contains("id")) applyDrift(station["id"].get<std::string>(), station);
+        }
+    }
+    if (auto station = response.find("station"); station != response.end() && station->contains("id")) {
+        applyDrift((*station)["id"].get<std::string>(), *station);
+    }
+    if (auto prices = response.find("prices"); prices != response.end() && prices->is_object()) {
+        for (auto& [id, stationPrices] : prices->items()) {
+            applyDrift(id, stationPrices);
+        }
+    }
+}
+
+void StandInServer::applyDrift(const std::string& stationId, nlohmann::json& prices) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    for (const char* fuelType : {"e5", "e10", "diesel", "price"}) {
+        auto price = prices.find(fuelType);
+        if (price == prices.end() || !price->is_number()) continue;
+
+        // A bounded random walk per station and fuel type
+        auto& offset = driftOffsets[stationId + "/" + fuelType];
+        offset = std::clamp(
+            offset + std::uniform_real_distribution<double>(-options.priceDrift, options.priceDrift)(random),
+            -MAX_DRIFT, MAX_DRIFT);
+        *price = std::max(0.001, roundPrice(price->get<double>() + offset));
+    }
+}
+
+double StandInServer::uniform(double min, double max) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return std::uniform_real_distribution<double>(min, max)(random);
+}
+
+} // namespace standin
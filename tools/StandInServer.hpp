@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "api/RequestEngine.hpp"
+
+namespace standin {
+
+// Local HTTP stand-in for the Tankerkoenig API (list.php, detail.php and
+// prices.php under /json/) and for Teams webhooks (POST to any other path).
+//
+// API requests are answered from recorded responses if there is one, else
+// from upstream in record mode (the response is saved for later replays),
+// else from a synthetic station grid. Synthetic station IDs encode their grid
+// position, so the same stations show up in list, detail and prices queries.
+class StandInServer {
+public:
+    struct Options {
+        std::string bindAddress = "127.0.0.1";
+        uint16_t port = 0;  // 0 picks a free port
+        size_t threads = 16;  // connections served concurrently
+        std::filesystem::path recordings;  // directory of recorded responses, see recordingFile()
+        std::string upstream;  // record mode: base URL misses are fetched from, e.g. the real API
+        std::chrono::milliseconds latency{0};  // added to every response
+        std::chrono::milliseconds latencyJitter{0};  // uniformly distributed extra latency
+        double errorRate = 0.0;  // fraction of requests answered with errorStatus
+        int errorStatus = 503;  // 200 answers with "ok": false, 429 sets Retry-After
+        double priceDrift = 0.0;  // largest price step in euro per response, 0 keeps prices fixed
+        double stationSpacing = 0.02;  // degrees between synthetic stations
+        uint32_t seed = 1;
+    };
+
+    struct Counters {
+        uint64_t requests = 0;
+        uint64_t replayed = 0;
+        uint64_t recorded = 0;
+        uint64_t synthesized = 0;
+        uint64_t notModified = 0;
+        uint64_t injectedErrors = 0;
+        uint64_t webhooks = 0;
+    };
+
+    explicit StandInServer(Options options);
+    ~StandInServer();
+
+    // Disable copying
+    StandInServer(const StandInServer&) = delete;
+    StandInServer& operator=(const StandInServer&) = delete;
+
+    // Binds the socket and starts serving; throws if the address is taken
+    void start();
+    void stop();
+
+    uint16_t port() const { return boundPort; }
+    std::string baseUrl() const;  // to be used as the API client's base URL
+    std::string webhookUrl() const;
+
+    Counters counters() const;
+
+    // Payloads of the webhooks received so far
+    std::vector<nlohmann::json> webhooks() const;
+
+    // Recorded responses are stored as <endpoint>-<hash of the query>.json;
+    // <endpoint>.json, if present, answers every query of that endpoint
+    static std::string recordingFile(const std::string& endpoint,
+                                     const std::map<std::string, std::string>& params);
+
+private:
+    struct Request {
+        std::string method;
+        std::string path;
+        std::map<std::string, std::string> params;
+        std::string query;  // raw, forwarded upstream in record mode
+        std::map<std::string, std::string> headers;  // lower-case names
+        std::string body;
+    };
+
+    struct Response {
+        int status = 200;
+        std::string body;
+        std::vector<std::string> headers;  // "Name: value"
+    };
+
+    void acceptLoop();
+    void workerLoop();
+    void serveConnection(int fd);
+    // Appends what the client sent next; false once it closed the connection
+    // or the server is stopping
+    bool receive(int fd, std::string& buffer);
+    bool sendResponse(int fd, const Response& response, bool keepAlive);
+
+    Response handle(const Request& request);
+    Response handleApi(const Request& request, const std::string& endpoint);
+    Response handleWebhook(const Request& request);
+
+    std::optional<std::string> replay(const std::string& endpoint, const Request& request);
+    std::optional<Response> record(const std::string& endpoint, const Request& request);
+    nlohmann::json synthesize(const std::string& endpoint, const Request& request);
+
+    nlohmann::json syntheticStation(int32_t row, int64_t column, bool detail);
+    void applyDrift(nlohmann::json& response);
+    void applyDrift(const std::string& stationId, nlohmann::json& prices);
+
+    double uniform(double min, double max);
+
+    Options options;
+    std::unique_ptr<api::RequestEngine> upstream;  // record mode only
+
+    int listenFd = -1;
+    uint16_t boundPort = 0;
+    std::atomic<bool> running{false};
+    std::thread acceptor;
+    std::vector<std::thread> workers;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<int> connections;
+
+    mutable std::mutex stateMutex;
+    Counters stats;
+    std::vector<nlohmann::json> receivedWebhooks;
+    std::unordered_map<std::string, double> driftOffsets;  // per station and fuel type
+    std::mt19937 random;
+
+    static constexpr int POLL_TIMEOUT_MS = 100;
+    static constexpr double MAX_DRIFT = 0.3;  // drift offsets stay within +-30 cents
+};
+
+} // namespace standin